@@ -0,0 +1,41 @@
+//
+// Copyright 2017 nfactorial
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#if !defined( BENCH_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL )
+#define BENCH_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL
+
+
+// -----------------------------------------------------------------------------------
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+// -----------------------------------------------------------------------------------
+
+void BenchReport(const char *name, uint64_t elapsedNano, size_t count);
+
+void RunContentionBench();
+void RunDispatchBench();
+void RunOverheadBench();
+void RunScalingBench();
+void RunTimerBench();
+void RunWakeBench();
+
+
+// -----------------------------------------------------------------------------------
+
+#endif //!defined( BENCH_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL )
@@ -0,0 +1,258 @@
+//
+// Copyright 2017 nfactorial
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "profiler.h"
+
+
+// -----------------------------------------------------------------------------------
+
+//! Percentage a benchmark may slow down by, compared with the baseline, before it is reported as a regression.
+static const double kBenchDefaultThreshold = 10.0;
+
+//! \brief  The measurement made by a single benchmark.
+struct BenchResult {
+    std::string name;
+    double nanoPerOp;
+    size_t count;
+};
+
+//! Names of the RAIZE_PROFILER values, indexed by the value.
+static const char *const s_profilerNames[] = {"null", "timing", "tracing"};
+
+//! Every result reported whilst the benchmarks run, in the order they were reported.
+static std::vector<BenchResult> s_results;
+
+
+// -----------------------------------------------------------------------------------
+
+//! \brief  Reports the average time taken by each operation within a benchmark.
+//! \param  name [in] -
+//!         Name of the benchmark, which must be unique so that it may be compared against a baseline.
+//! \param  elapsedNano [in] -
+//!         Total time (in nanoseconds) taken by the benchmark.
+//! \param  count [in] -
+//!         The number of operations performed by the benchmark.
+void BenchReport(const char *name, uint64_t elapsedNano, size_t count) {
+    const double nanoPerOp = static_cast< double >(elapsedNano) / static_cast< double >(count);
+
+    printf("%-32s %10.2f ns/op\n", name, nanoPerOp);
+
+    const BenchResult result = {name, nanoPerOp, count};
+    s_results.push_back(result);
+}
+
+
+// -----------------------------------------------------------------------------------
+
+//! \brief  Writes a string to a JSON file, escaping any characters JSON does not allow within a string.
+static void WriteJsonString(FILE *file, const std::string &value) {
+    fputc('"', file);
+
+    for (const char character : value) {
+        if ('"' == character || '\\' == character) {
+            fputc('\\', file);
+        }
+
+        fputc(character, file);
+    }
+
+    fputc('"', file);
+}
+
+
+//! \brief  Writes every result to a JSON file, which may later be supplied as a baseline.
+//! \param  path [in] -
+//!         Path of the file to be written.
+//! \return <em>True</em> if the file was written otherwise <em>false</em>.
+static bool WriteResults(const char *path) {
+    FILE *file = fopen(path, "w");
+    if (nullptr == file) {
+        return false;
+    }
+
+    fprintf(file, "{\n  \"profiler\": \"%s\",\n  \"results\": [\n", s_profilerNames[RAIZE_PROFILER]);
+
+    for (size_t loop = 0; loop < s_results.size(); ++loop) {
+        fprintf(file, "    {\"name\": ");
+        WriteJsonString(file, s_results[loop].name);
+        fprintf(file, ", \"ns_per_op\": %.4f, \"count\": %llu}%s\n",
+                s_results[loop].nanoPerOp,
+                static_cast< unsigned long long >(s_results[loop].count),
+                (loop + 1 < s_results.size()) ? "," : "");
+    }
+
+    fprintf(file, "  ]\n}\n");
+    return 0 == fclose(file);
+}
+
+
+//! \brief  Reads the results from a file previously written by WriteResults().
+//! \param  path [in] -
+//!         Path of the file to be read.
+//! \param  results [out] -
+//!         Receives the results stored within the file.
+//! \return <em>True</em> if the file was read otherwise <em>false</em>.
+//!
+//! This is not a general JSON parser, it only understands the layout written by WriteResults().
+static bool ReadResults(const char *path, std::vector<BenchResult> &results) {
+    FILE *file = fopen(path, "r");
+    if (nullptr == file) {
+        return false;
+    }
+
+    std::string text;
+    char buffer[4096];
+    size_t bytesRead;
+
+    while (0 != (bytesRead = fread(buffer, 1, sizeof(buffer), file))) {
+        text.append(buffer, bytesRead);
+    }
+
+    fclose(file);
+
+    static const char kNameKey[] = "\"name\": \"";
+    static const char kValueKey[] = "\"ns_per_op\": ";
+
+    size_t position = 0;
+    while (std::string::npos != (position = text.find(kNameKey, position))) {
+        BenchResult result = {std::string(), 0.0, 0};
+
+        for (position += sizeof(kNameKey) - 1; position < text.size() && '"' != text[position]; ++position) {
+            if ('\\' == text[position] && position + 1 < text.size()) {
+                ++position;
+            }
+
+            result.name.push_back(text[position]);
+        }
+
+        position = text.find(kValueKey, position);
+        if (std::string::npos == position) {
+            return false;
+        }
+
+        position += sizeof(kValueKey) - 1;
+        result.nanoPerOp = strtod(text.c_str() + position, nullptr);
+        results.push_back(result);
+    }
+
+    return true;
+}
+
+
+//! \brief  Compares every result against a baseline, reporting the change in each.
+//! \param  baseline [in] -
+//!         The results to compare against.
+//! \param  threshold [in] -
+//!         Percentage a benchmark may slow down by before it is reported as a regression.
+//! \return The number of benchmarks that regressed.
+static size_t CompareResults(const std::vector<BenchResult> &baseline, double threshold) {
+    size_t regressionCount = 0;
+
+    printf("\n%-32s %10s %10s %9s\n", "comparison", "baseline", "current", "change");
+
+    for (const BenchResult &result : s_results) {
+        const BenchResult *previous = nullptr;
+
+        for (const BenchResult &candidate : baseline) {
+            if (candidate.name == result.name) {
+                previous = &candidate;
+                break;
+            }
+        }
+
+        if (nullptr == previous || previous->nanoPerOp <= 0.0) {
+            printf("%-32s %10s %10.2f %9s\n", result.name.c_str(), "-", result.nanoPerOp, "new");
+            continue;
+        }
+
+        const double change = (result.nanoPerOp - previous->nanoPerOp) * 100.0 / previous->nanoPerOp;
+        const bool regressed = change > threshold;
+
+        printf("%-32s %10.2f %10.2f %+8.1f%%%s\n", result.name.c_str(), previous->nanoPerOp, result.nanoPerOp, change, regressed ? "  REGRESSION" : "");
+
+        if (regressed) {
+            ++regressionCount;
+        }
+    }
+
+    return regressionCount;
+}
+
+
+// -----------------------------------------------------------------------------------
+
+static void PrintUsage(const char *program) {
+    printf("usage: %s [--json <path>] [--baseline <path>] [--threshold <percent>]\n", program);
+    printf("  --json <path>           write the results to a JSON file\n");
+    printf("  --baseline <path>       compare the results against a file written by --json\n");
+    printf("  --threshold <percent>   slow down allowed before a result is a regression (default %.0f)\n", kBenchDefaultThreshold);
+}
+
+//! Returns 0 when the benchmarks ran, 1 if any regressed against the baseline and 2 if they could not be run.
+int main(int argc, char *argv[]) {
+    const char *jsonPath = nullptr;
+    const char *baselinePath = nullptr;
+    double threshold = kBenchDefaultThreshold;
+
+    for (int loop = 1; loop < argc; ++loop) {
+        const bool hasValue = loop + 1 < argc;
+
+        if (hasValue && 0 == strcmp(argv[loop], "--json")) {
+            jsonPath = argv[++loop];
+        } else if (hasValue && 0 == strcmp(argv[loop], "--baseline")) {
+            baselinePath = argv[++loop];
+        } else if (hasValue && 0 == strcmp(argv[loop], "--threshold")) {
+            threshold = strtod(argv[++loop], nullptr);
+        } else {
+            PrintUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    // Read the baseline first, so a bad path is reported before spending time on the benchmarks
+    std::vector<BenchResult> baseline;
+    if (nullptr != baselinePath && !ReadResults(baselinePath, baseline)) {
+        printf("failed to read baseline '%s'\n", baselinePath);
+        return 2;
+    }
+
+    printf("profiler: %s\n", s_profilerNames[RAIZE_PROFILER]);
+
+    RunTimerBench();
+    RunDispatchBench();
+    RunOverheadBench();
+    RunScalingBench();
+    RunContentionBench();
+    RunWakeBench();
+
+    if (nullptr != jsonPath && !WriteResults(jsonPath)) {
+        printf("failed to write results to '%s'\n", jsonPath);
+        return 2;
+    }
+
+    if (nullptr != baselinePath && 0 != CompareResults(baseline, threshold)) {
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,110 @@
+//
+// Copyright 2017 nfactorial
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Measures the cost of claiming tasks from a TaskProvider whilst every core is claiming at
+// once. The tasks are never executed, so the time reported is spent acquiring and completing
+// each task within the shared provider.
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "performance_timer.h"
+#include "platform.h"
+#include "task_provider.h"
+
+
+// -----------------------------------------------------------------------------------
+
+static const size_t kContentionTaskCount = 4096;
+static const size_t kContentionFrameCount = 64;
+
+static void ContentionTask() {
+}
+
+
+// -----------------------------------------------------------------------------------
+
+// Claims every task from the provider across the supplied number of threads, then reports the cost of each claim.
+static void BenchClaimMode(const char *name, raize::kTaskClaimMode claimMode, size_t threadCount) {
+    raize::TaskProvider taskProvider;
+
+    if (!taskProvider.initialize(kContentionTaskCount, threadCount)) {
+        return;
+    }
+
+    taskProvider.setClaimMode(claimMode);
+
+    for (size_t loop = 0; loop < kContentionTaskCount; ++loop) {
+        taskProvider.addTask(ContentionTask);
+    }
+
+    uint64_t elapsedNano = 0;
+
+    for (size_t frame = 0; frame < kContentionFrameCount; ++frame) {
+        taskProvider.onBeginProcessing();
+
+        std::atomic<size_t> readyCount(0);
+        std::atomic<bool> start(false);
+        std::vector<std::thread> threads;
+
+        for (unsigned int contextId = 0; contextId < threadCount; ++contextId) {
+            threads.push_back(std::thread([&taskProvider, &readyCount, &start, contextId]() {
+                readyCount.fetch_add(1);
+                while (!start.load(std::memory_order_acquire)) {
+                    RAIZE_CPU_PAUSE();
+                }
+
+                raize::TaskRange range = {0, 0};
+                raize::TaskId taskId;
+                while (raize::kInvalidTaskId != (taskId = taskProvider.acquireTask(contextId, range))) {
+                    taskProvider.completeTask(contextId, taskId);
+                }
+            }));
+        }
+
+        // Only the claiming is timed, not the creation of the threads
+        while (readyCount.load() != threadCount) {
+            std::this_thread::yield();
+        }
+
+        // The timing thread blocks within join() rather than spinning, so it does not compete with the claimers
+        const raize::PerformanceTimer timer;
+        start.store(true, std::memory_order_release);
+
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+
+        elapsedNano += timer.getElapsedTimeNano();
+
+        taskProvider.onEndProcessing();
+    }
+
+    BenchReport(name, elapsedNano, kContentionFrameCount * kContentionTaskCount);
+}
+
+
+// -----------------------------------------------------------------------------------
+
+void RunContentionBench() {
+    const size_t threadCount = std::max< size_t >(2, std::thread::hardware_concurrency());
+
+    BenchClaimMode("nextTask contention stealing", raize::kTaskClaimMode_WorkStealing, threadCount);
+    BenchClaimMode("nextTask contention batched", raize::kTaskClaimMode_Batched, threadCount);
+}
@@ -0,0 +1,199 @@
+//
+// Copyright 2017 nfactorial
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Compares the cost of dispatching task payloads against std::function. Each benchmark
+// invokes the same small piece of work through a different calling mechanism, first
+// directly and then through the scheduler.
+
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "bench.h"
+#include "performance_timer.h"
+#include "scheduler.h"
+#include "task_provider.h"
+
+
+// -----------------------------------------------------------------------------------
+
+static const size_t kBenchTaskCount = 4096;
+static const size_t kBenchIterations = 256;
+
+static float benchData[kBenchTaskCount];
+
+//! Number of distinct functions available to the scheduled function pointer tasks, one per task.
+static const size_t kBenchScaleFunctionCount = 256;
+static_assert(kBenchScaleFunctionCount <= kBenchTaskCount, "Every scale function must have its own element");
+
+
+// -----------------------------------------------------------------------------------
+
+// The closure stored by each task, which could not be expressed with a plain function pointer.
+struct ScaleClosure {
+    float *data;
+    size_t index;
+    float scale;
+
+    void operator()() const {
+        data[index] = data[index] * scale + 1.0f;
+    }
+};
+
+static void ScaleGlobal() {
+    benchData[0] = benchData[0] * 0.5f + 1.0f;
+}
+
+// Each scheduled function pointer task scales its own element, so tasks never share data.
+template< size_t Index >
+static void ScaleElement() {
+    benchData[Index] = benchData[Index] * 0.5f + 1.0f;
+}
+
+template< size_t... Indices >
+static const raize::TaskExecuteFunction *GetScaleFunctions(std::index_sequence< Indices... >) {
+    static const raize::TaskExecuteFunction scaleFunctions[] = {ScaleElement< Indices >...};
+    return scaleFunctions;
+}
+
+static void ScalePayload(void *payload) {
+    (*static_cast< ScaleClosure* >(payload))();
+}
+
+static void ScaleRange(size_t begin, size_t end) {
+    for (size_t loop = begin; loop < end; ++loop) {
+        benchData[loop] = benchData[loop] * 0.5f + 1.0f;
+    }
+}
+
+
+// -----------------------------------------------------------------------------------
+
+// Dispatches tasks the way the task processor does, through the function stored within TaskInfo.
+static uint64_t DispatchTaskInfo(std::vector<raize::TaskInfo> &tasks) {
+    const raize::PerformanceTimer timer;
+
+    for (size_t iteration = 0; iteration < kBenchIterations; ++iteration) {
+        for (raize::TaskInfo &taskInfo : tasks) {
+            if (nullptr != taskInfo.invoke) {
+                taskInfo.invoke(taskInfo.payload.data);
+            } else {
+                taskInfo.execute();
+            }
+        }
+    }
+
+    return timer.getElapsedTimeNano();
+}
+
+static void BenchDirectDispatch() {
+    std::vector<raize::TaskInfo> functionTasks(kBenchTaskCount);
+    std::vector<raize::TaskInfo> payloadTasks(kBenchTaskCount);
+    std::vector< std::function<void()> > stdFunctions;
+
+    stdFunctions.reserve(kBenchTaskCount);
+
+    for (size_t loop = 0; loop < kBenchTaskCount; ++loop) {
+        const ScaleClosure closure = {benchData, loop, 0.5f};
+
+        functionTasks[loop].execute = ScaleGlobal;
+        functionTasks[loop].invoke = nullptr;
+
+        payloadTasks[loop].execute = nullptr;
+        payloadTasks[loop].invoke = ScalePayload;
+        memcpy(payloadTasks[loop].payload.data, &closure, sizeof(closure));
+
+        stdFunctions.push_back(closure);
+    }
+
+    BenchReport("direct function pointer", DispatchTaskInfo(functionTasks), kBenchTaskCount * kBenchIterations);
+    BenchReport("direct task payload", DispatchTaskInfo(payloadTasks), kBenchTaskCount * kBenchIterations);
+
+    const raize::PerformanceTimer timer;
+    for (size_t iteration = 0; iteration < kBenchIterations; ++iteration) {
+        for (const std::function<void()> &function : stdFunctions) {
+            function();
+        }
+    }
+
+    BenchReport("direct std::function", timer.getElapsedTimeNano(), kBenchTaskCount * kBenchIterations);
+}
+
+
+// -----------------------------------------------------------------------------------
+
+// Creates tasks using the supplied function then measures the time taken to execute them.
+template< typename CreateFunction >
+static void BenchScheduler(const char *name, CreateFunction createFunction) {
+    std::unique_ptr<raize::Scheduler> scheduler(new raize::Scheduler);
+
+    if (!scheduler->initialize()) {
+        printf("%-32s failed to initialize\n", name);
+        return;
+    }
+
+    for (size_t loop = 0; loop < kBenchTaskCount; ++loop) {
+        createFunction(*scheduler, loop);
+    }
+
+    scheduler->compile();
+    scheduler->execute();
+
+    const raize::PerformanceTimer timer;
+    for (size_t iteration = 0; iteration < kBenchIterations; ++iteration) {
+        scheduler->execute();
+    }
+
+    BenchReport(name, timer.getElapsedTimeNano(), kBenchTaskCount * kBenchIterations);
+    scheduler->shutdown();
+}
+
+static void BenchScheduledDispatch() {
+    BenchScheduler("scheduled function pointer", [](raize::Scheduler &scheduler, size_t index) {
+        static const raize::TaskExecuteFunction *scaleFunctions = GetScaleFunctions(std::make_index_sequence< kBenchScaleFunctionCount >());
+
+        if (index < kBenchScaleFunctionCount) {
+            scheduler.createTask(scaleFunctions[index]);
+        }
+    });
+
+    BenchScheduler("scheduled task payload", [](raize::Scheduler &scheduler, size_t index) {
+        const ScaleClosure closure = {benchData, index, 0.5f};
+        scheduler.createTask(ScalePayload, &closure, sizeof(closure), nullptr);
+    });
+
+    BenchScheduler("scheduled lambda", [](raize::Scheduler &scheduler, size_t index) {
+        float *data = benchData;
+        scheduler.createTask([data, index]() { data[index] = data[index] * 0.5f + 1.0f; });
+    });
+
+    BenchScheduler("scheduled parallelFor", [](raize::Scheduler &scheduler, size_t index) {
+        if (0 == index) {
+            scheduler.parallelFor(0, kBenchTaskCount, 64, ScaleRange);
+        }
+    });
+}
+
+
+// -----------------------------------------------------------------------------------
+
+void RunDispatchBench() {
+    BenchDirectDispatch();
+    BenchScheduledDispatch();
+}
@@ -0,0 +1,126 @@
+//
+// Copyright 2017 nfactorial
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Measures the fixed costs of the scheduler, which bound how small a task may usefully be.
+// Tasks do no work, so the time reported is spent entirely within the scheduler.
+
+#include <cstdio>
+#include <memory>
+
+#include "bench.h"
+#include "performance_timer.h"
+#include "scheduler.h"
+
+
+// -----------------------------------------------------------------------------------
+
+static const size_t kOverheadFrameCount = 256;
+static const size_t kOverheadRoundTripCount = 10000;
+
+static void EmptyTask() {
+}
+
+
+// -----------------------------------------------------------------------------------
+
+// Creates a scheduler with the default configuration, reporting the benchmark as failed if it could not be initialized.
+static std::unique_ptr<raize::Scheduler> CreateScheduler(const char *name) {
+    std::unique_ptr<raize::Scheduler> scheduler(new raize::Scheduler);
+
+    if (!scheduler->initialize()) {
+        printf("%-32s failed to initialize\n", name);
+        scheduler.reset();
+    }
+
+    return scheduler;
+}
+
+
+// Fills the scheduler with empty tasks, then reports the cost of dispatching each one.
+static void BenchEmptyDispatch() {
+    std::unique_ptr<raize::Scheduler> scheduler = CreateScheduler("empty task dispatch");
+    if (!scheduler) {
+        return;
+    }
+
+    size_t taskCount = 0;
+    while (taskCount < scheduler->getMaximumTasks() && scheduler->createTask(EmptyTask)) {
+        ++taskCount;
+    }
+
+    scheduler->compile();
+    scheduler->execute();
+
+    const raize::PerformanceTimer timer;
+    for (size_t frame = 0; frame < kOverheadFrameCount; ++frame) {
+        scheduler->execute();
+    }
+
+    BenchReport("empty task dispatch", timer.getElapsedTimeNano(), kOverheadFrameCount * taskCount);
+    scheduler->shutdown();
+}
+
+
+// Reports the cost of a frame that has no tasks, which never wakes the worker threads.
+static void BenchZeroTasks() {
+    std::unique_ptr<raize::Scheduler> scheduler = CreateScheduler("execute zero tasks");
+    if (!scheduler) {
+        return;
+    }
+
+    scheduler->execute();
+
+    const raize::PerformanceTimer timer;
+    for (size_t frame = 0; frame < kOverheadRoundTripCount; ++frame) {
+        scheduler->execute();
+    }
+
+    BenchReport("execute zero tasks", timer.getElapsedTimeNano(), kOverheadRoundTripCount);
+    scheduler->shutdown();
+}
+
+
+// Reports the cost of a frame with a single empty task per thread, which wakes and joins every worker.
+static void BenchRoundTrip() {
+    std::unique_ptr<raize::Scheduler> scheduler = CreateScheduler("execute round trip");
+    if (!scheduler) {
+        return;
+    }
+
+    for (size_t loop = 0; loop < scheduler->getThreadCount(); ++loop) {
+        scheduler->createTask(EmptyTask);
+    }
+
+    scheduler->compile();
+    scheduler->execute();
+
+    const raize::PerformanceTimer timer;
+    for (size_t frame = 0; frame < kOverheadRoundTripCount; ++frame) {
+        scheduler->execute();
+    }
+
+    BenchReport("execute round trip", timer.getElapsedTimeNano(), kOverheadRoundTripCount);
+    scheduler->shutdown();
+}
+
+
+// -----------------------------------------------------------------------------------
+
+void RunOverheadBench() {
+    BenchEmptyDispatch();
+    BenchZeroTasks();
+    BenchRoundTrip();
+}
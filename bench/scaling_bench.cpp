@@ -0,0 +1,146 @@
+//
+// Copyright 2017 nfactorial
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Measures how throughput changes with the number of threads, and with the distribution of
+// task durations. Each task spins for a fixed number of iterations, so the ideal result
+// halves the time per task each time the thread count doubles.
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <thread>
+
+#include "bench.h"
+#include "performance_timer.h"
+#include "scheduler.h"
+
+
+// -----------------------------------------------------------------------------------
+
+static const size_t kScalingFrameCount = 64;
+static const uint32_t kScalingUniformWork = 2000;
+
+//! Thread counts are measured individually up to this count, then doubled until the core count is reached.
+static const size_t kScalingLinearThreads = 8;
+
+//! Seed for the generator that chooses task durations, so every run measures the same frames.
+static const uint32_t kScalingSeed = 0x2545f491;
+
+
+// -----------------------------------------------------------------------------------
+
+// The payload stored by each task, describing how long the task runs for.
+struct SpinPayload {
+    uint32_t iterations;
+};
+
+// Spins for the number of iterations stored within the payload.
+static void SpinTask(void *payload) {
+    const uint32_t iterations = static_cast< const SpinPayload* >(payload)->iterations;
+    volatile uint32_t value = 0;
+
+    for (uint32_t loop = 0; loop < iterations; ++loop) {
+        value = value * 1664525 + 1013904223;
+    }
+}
+
+// Linear congruential generator, used so the durations are identical on every platform.
+static uint32_t NextRandom(uint32_t &state) {
+    state = state * 1664525 + 1013904223;
+    return state >> 8;
+}
+
+
+// -----------------------------------------------------------------------------------
+
+// Fills a scheduler with tasks whose durations are chosen by the supplied function, then measures the time taken to execute them.
+template< typename DurationFunction >
+static void BenchWorkload(const char *name, size_t threadCount, DurationFunction durationFunction) {
+    std::unique_ptr<raize::Scheduler> scheduler(new raize::Scheduler);
+
+    if (!scheduler->initialize(threadCount, threadCount, raize::kCallerMode_Participate, nullptr)) {
+        printf("%-32s failed to initialize\n", name);
+        return;
+    }
+
+    uint32_t state = kScalingSeed;
+    size_t taskCount = 0;
+
+    while (taskCount < scheduler->getMaximumTasks()) {
+        const SpinPayload payload = {durationFunction(state)};
+        if (!scheduler->createTask(SpinTask, &payload, sizeof(payload), nullptr)) {
+            break;
+        }
+
+        ++taskCount;
+    }
+
+    scheduler->compile();
+    scheduler->execute();
+
+    const raize::PerformanceTimer timer;
+    for (size_t frame = 0; frame < kScalingFrameCount; ++frame) {
+        scheduler->execute();
+    }
+
+    BenchReport(name, timer.getElapsedTimeNano(), kScalingFrameCount * taskCount);
+    scheduler->shutdown();
+}
+
+
+// -----------------------------------------------------------------------------------
+
+// Every task takes the same time, so any loss of throughput is caused by the scheduler.
+static void BenchThreadScaling(size_t maximumThreads) {
+    for (size_t threadCount = 1; threadCount <= maximumThreads; ) {
+        char name[64];
+        snprintf(name, sizeof(name), "throughput %zu threads", threadCount);
+
+        BenchWorkload(name, threadCount, [](uint32_t &) {
+            return kScalingUniformWork;
+        });
+
+        if (threadCount == maximumThreads) {
+            break;
+        }
+
+        threadCount = std::min(maximumThreads, (threadCount < kScalingLinearThreads) ? threadCount + 1 : threadCount * 2);
+    }
+}
+
+
+// Tasks are drawn from a spread of durations, or a few long tasks amongst many short ones.
+static void BenchDistributions(size_t threadCount) {
+    BenchWorkload("mixed durations", threadCount, [](uint32_t &state) {
+        static const uint32_t durations[] = {kScalingUniformWork / 8, kScalingUniformWork, kScalingUniformWork * 8};
+        return durations[NextRandom(state) % 3];
+    });
+
+    // One task in 32 is a hundred times longer, so the frame is limited by balancing the long tasks
+    BenchWorkload("skewed durations", threadCount, [](uint32_t &state) {
+        return (0 == NextRandom(state) % 32) ? kScalingUniformWork * 25 : kScalingUniformWork / 4;
+    });
+}
+
+
+// -----------------------------------------------------------------------------------
+
+void RunScalingBench() {
+    const size_t maximumThreads = std::max< size_t >(1, std::thread::hardware_concurrency());
+
+    BenchThreadScaling(maximumThreads);
+    BenchDistributions(maximumThreads);
+}
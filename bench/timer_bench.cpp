@@ -0,0 +1,75 @@
+//
+// Copyright 2017 nfactorial
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Measures the cost of timing a single task, which the task processor does for every task it
+// executes. Each benchmark starts a timer and reads the elapsed time, as executeTask() does.
+
+#include <chrono>
+#include <cstdio>
+
+#include "bench.h"
+#include "performance_timer.h"
+
+
+// -----------------------------------------------------------------------------------
+
+static const size_t kTimerIterations = 1000000;
+
+// Accumulates every measurement so the compiler cannot discard the timing.
+static volatile uint64_t timerSink;
+
+
+// -----------------------------------------------------------------------------------
+
+// Times each iteration with a std::chrono clock, as the timer did before it supported the time-stamp counter.
+template< typename Clock >
+static void BenchChronoClock(const char *name) {
+    const raize::PerformanceTimer timer;
+
+    uint64_t total = 0;
+    for (size_t loop = 0; loop < kTimerIterations; ++loop) {
+        const typename Clock::time_point start = Clock::now();
+        total += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+    }
+
+    timerSink = total;
+    BenchReport(name, timer.getElapsedTimeNano(), kTimerIterations);
+}
+
+// Times each iteration with PerformanceTimer, using whichever clock calibration selected.
+static void BenchPerformanceTimer(const char *name) {
+    const raize::PerformanceTimer timer;
+
+    uint64_t total = 0;
+    for (size_t loop = 0; loop < kTimerIterations; ++loop) {
+        const raize::PerformanceTimer taskTimer;
+        total += taskTimer.getElapsedTimeNano();
+    }
+
+    timerSink = total;
+    BenchReport(name, timer.getElapsedTimeNano(), kTimerIterations);
+}
+
+
+// -----------------------------------------------------------------------------------
+
+void RunTimerBench() {
+    const bool tscEnabled = raize::PerformanceTimer::calibrate();
+
+    BenchChronoClock<std::chrono::high_resolution_clock>("timer high_resolution_clock");
+    BenchChronoClock<std::chrono::steady_clock>("timer steady_clock");
+    BenchPerformanceTimer(tscEnabled ? "timer PerformanceTimer (tsc)" : "timer PerformanceTimer (clock)");
+}
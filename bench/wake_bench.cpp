@@ -0,0 +1,85 @@
+//
+// Copyright 2017 nfactorial
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Measures the delay between Scheduler::execute() being called and the worker threads
+// observing the new frame, for each of the wait policies.
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+
+#include "bench.h"
+#include "scheduler.h"
+
+
+// -----------------------------------------------------------------------------------
+
+static const size_t kWakeFrameCount = 200;
+static const uint64_t kWakeSpinBudget = 200000;
+
+static void WakeTask() {
+}
+
+
+// -----------------------------------------------------------------------------------
+
+// Executes a series of short frames separated by a fixed gap, then reports the average wake latency.
+static void BenchWakePolicy(const char *name, raize::kWaitPolicy waitPolicy, std::chrono::microseconds frameGap) {
+    std::unique_ptr<raize::Scheduler> scheduler(new raize::Scheduler);
+
+    if (!scheduler->initialize()) {
+        printf("%-32s failed to initialize\n", name);
+        return;
+    }
+
+    scheduler->setWaitPolicy(waitPolicy, kWakeSpinBudget);
+
+    for (size_t loop = 0; loop < scheduler->getThreadCount(); ++loop) {
+        scheduler->createTask(WakeTask);
+    }
+
+    scheduler->execute();
+    scheduler->resetWakeStatistics();
+
+    for (size_t frame = 0; frame < kWakeFrameCount; ++frame) {
+        std::this_thread::sleep_for(frameGap);
+        scheduler->execute();
+    }
+
+    raize::WakeStatistics wakeStatistics;
+    scheduler->getWakeStatistics(wakeStatistics);
+
+    BenchReport(name, wakeStatistics.totalLatencyNano, (0 != wakeStatistics.wakeCount) ? wakeStatistics.wakeCount : 1);
+    printf("%-32s %10llu spin, %llu yield, %llu block, %llu ns max\n", "",
+           static_cast< unsigned long long >(wakeStatistics.spinWakeCount),
+           static_cast< unsigned long long >(wakeStatistics.yieldWakeCount),
+           static_cast< unsigned long long >(wakeStatistics.blockWakeCount),
+           static_cast< unsigned long long >(wakeStatistics.maximumLatencyNano));
+
+    scheduler->shutdown();
+}
+
+
+// -----------------------------------------------------------------------------------
+
+void RunWakeBench() {
+    const std::chrono::microseconds frameGap(50);
+
+    BenchWakePolicy("wake latency block", raize::kWaitPolicy_Block, frameGap);
+    BenchWakePolicy("wake latency spin", raize::kWaitPolicy_Spin, frameGap);
+    BenchWakePolicy("wake latency adaptive", raize::kWaitPolicy_Adaptive, frameGap);
+}
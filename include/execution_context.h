@@ -23,12 +23,16 @@
 #include <condition_variable>
 #include <stdint.h>
 
+#include "platform.h"
+#include "thread_affinity.h"
 #include "thread_command.h"
 
 
 // -----------------------------------------------------------------------------------
 
 namespace raize {
+    class FrameArena;
+
     //! \brief	An execution context describes a processing unit within the scheduler.
     //!
     //! Whilst an execution unit is typically an individual thread, it should make no
@@ -40,6 +44,9 @@ namespace raize {
         unsigned int contextId;      //!< Identifier for this execution context.
         unsigned int tasksProcessed; //!< Number of tasks we processed this frame
         uint64_t executionSpeed;     //!< How fast did the context take to complete all the supplied tasks in a frame (in milliseconds)
+        char padding[RAIZE_CACHE_LINE_SIZE - sizeof(unsigned int) * 2 - sizeof(uint64_t)];   //!< Keeps the counters written by the owning thread upon their own cache line
+        ThreadPlacement placement;   //!< Where and how the operating system should run the thread, applied when the thread starts
+        FrameArena *frameArena;      //!< Scratch memory for the tasks executed by this context, released as each frame ends
     };
 } // namespace raize
 
@@ -0,0 +1,127 @@
+//
+// Copyright 2017 nfactorial
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#if !defined( FIBER_POOL_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL )
+#define FIBER_POOL_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL
+
+
+// -----------------------------------------------------------------------------------
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#if defined( __linux__ )
+    #include <ucontext.h>
+#endif //defined( __linux__ )
+
+
+// -----------------------------------------------------------------------------------
+
+namespace raize {
+    //! \brief  Function executed upon a fiber.
+    typedef void (*FiberFunction)(void *argument);
+
+    //! \brief  A stackful coroutine, owned by a FiberPool.
+    struct Fiber {
+#if defined( __linux__ )
+        ucontext_t context;
+        ucontext_t *returnContext;                  //!< Context of the thread that resumed the fiber, switched to when the fiber suspends
+#endif //defined( __linux__ )
+        FiberFunction function;
+        void *argument;
+        bool finished;                              //!< Set once the function has returned, the fiber may then be released
+        const std::atomic<uint32_t> *waitCounter;   //!< Counter the suspended fiber is waiting upon, nullptr if the fiber is not waiting
+    };
+
+    //! \brief  Fixed pool of fibers, each with its own stack, used by a single thread.
+    //!
+    //! Every stack is allocated when the pool is initialized, starting a fiber never allocates
+    //! memory. A fiber runs until its function returns or it suspends itself, control then
+    //! returns to the thread that started or resumed it. Fibers are never moved between
+    //! threads, a suspended fiber must be resumed by the thread that owns the pool.
+    //!
+    //! Fibers are implemented with ucontext and are only supported on Linux, initialize()
+    //! fails on other platforms.
+    class FiberPool {
+    public:
+        FiberPool();
+        ~FiberPool();
+
+        bool initialize(size_t fiberCount, size_t stackSize);
+        void shutdown();
+
+        Fiber *acquire();
+        void release(Fiber *fiber);
+
+        void start(Fiber *fiber, FiberFunction function, void *argument);
+        void resume(Fiber *fiber);
+
+        static void suspend(Fiber *fiber);
+
+        bool isInitialized() const;
+        size_t getFiberCount() const;
+        size_t getStackSize() const;
+
+    private:
+        static void fiberEntry(uint32_t fiberHigh, uint32_t fiberLow);
+
+    private:
+        typedef std::vector<Fiber*> FiberList;
+
+#if defined( __linux__ )
+        ucontext_t m_threadContext;                 // Context of the owning thread whilst a fiber is running
+#endif //defined( __linux__ )
+
+        size_t m_fiberCount;
+        size_t m_stackSize;
+        std::unique_ptr<Fiber[]> m_fibers;
+        std::unique_ptr<unsigned char[]> m_stacks;  // Single block containing every fibers stack
+        FiberList m_freeFibers;
+
+        FiberPool(const FiberPool &other);
+
+        FiberPool &operator=(const FiberPool &other);
+    };
+
+
+    //! \brief  Determines whether the pool contains any fibers.
+    //! \return <em>True</em> if the pool has been initialized otherwise <em>false</em>.
+    inline bool FiberPool::isInitialized() const {
+        return 0 != m_fiberCount;
+    }
+
+
+    //! \brief  Retrieves the number of fibers contained within the pool.
+    //! \return The number of fibers contained within the pool.
+    inline size_t FiberPool::getFiberCount() const {
+        return m_fiberCount;
+    }
+
+
+    //! \brief  Retrieves the size (in bytes) of each fibers stack.
+    //! \return The size (in bytes) of each fibers stack.
+    inline size_t FiberPool::getStackSize() const {
+        return m_stackSize;
+    }
+} // namespace raize
+
+
+// -----------------------------------------------------------------------------------
+
+#endif //!defined( FIBER_POOL_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL )
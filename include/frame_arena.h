@@ -0,0 +1,152 @@
+//
+// Copyright 2017 nfactorial
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#if !defined( FRAME_ARENA_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL )
+#define FRAME_ARENA_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL
+
+
+// -----------------------------------------------------------------------------------
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <cassert>
+
+
+// -----------------------------------------------------------------------------------
+
+namespace raize {
+    //! \brief  Describes how much of a FrameArena has been used, for sizing arenas from real workloads.
+    struct ArenaStatistics {
+        size_t capacity;                //!< Size (in bytes) of the arena
+        size_t highWater;               //!< Most bytes allocated within a single frame, since the statistics were reset
+        uint64_t failedAllocations;     //!< Number of allocations that did not fit within the arena
+        bool hugePages;                 //!< Whether the arena is backed by huge pages
+    };
+
+    //! \brief  Linear allocator for scratch memory that only lives until the end of the current frame.
+    //!
+    //! The memory is allocated, and touched, when the arena is initialized so that allocating
+    //! from it never enters the operating system. Allocation moves an offset forward, and
+    //! every allocation is released at once by reset(). The arena is used by a single thread,
+    //! though its statistics may be read by any thread.
+    class FrameArena {
+    public:
+        FrameArena();
+        ~FrameArena();
+
+        bool initialize(size_t capacity);
+        bool initialize(size_t capacity, bool hugePages);
+        void shutdown();
+
+        void *allocate(size_t size);
+        void *allocate(size_t size, size_t alignment);
+        void reset();
+
+        void getStatistics(ArenaStatistics &arenaStatistics) const;
+        void resetStatistics();
+
+        bool isInitialized() const;
+        size_t getCapacity() const;
+        size_t getUsed() const;
+
+    private:
+        unsigned char *m_memory;
+        size_t m_capacity;
+        size_t m_mappedSize;                        // Size of the mapping when the memory was mapped, 0 if it was allocated from the heap
+        size_t m_used;                              // Offset of the next allocation
+        bool m_hugePages;
+
+        // Only written by the owning thread, but may be read by any thread
+        std::atomic<size_t> m_highWater;
+        std::atomic<uint64_t> m_failedAllocations;
+
+        FrameArena(const FrameArena &other);
+
+        FrameArena &operator=(const FrameArena &other);
+    };
+
+
+    //! \brief  Allocates memory suitably aligned for any fundamental type, which remains valid until the arena is reset.
+    //! \param  size [in] -
+    //!         Size (in bytes) of the allocation.
+    //! \return Pointer to the allocated memory, or <em>nullptr</em> if the arena does not have enough space remaining.
+    inline void *FrameArena::allocate(size_t size) {
+        return allocate(size, alignof(max_align_t));
+    }
+
+
+    //! \brief  Allocates memory which remains valid until the arena is reset.
+    //! \param  size [in] -
+    //!         Size (in bytes) of the allocation.
+    //! \param  alignment [in] -
+    //!         Alignment (in bytes) of the allocation, this must be a power of two.
+    //! \return Pointer to the allocated memory, or <em>nullptr</em> if the arena does not have enough space remaining.
+    inline void *FrameArena::allocate(size_t size, size_t alignment) {
+        assert(0 != alignment && 0 == (alignment & (alignment - 1)));
+
+        if (nullptr == m_memory) {
+            return nullptr;
+        }
+
+        const uintptr_t base = reinterpret_cast< uintptr_t >(m_memory);
+        const size_t offset = static_cast< size_t >(((base + m_used + alignment - 1) & ~static_cast< uintptr_t >(alignment - 1)) - base);
+
+        if (offset > m_capacity || size > m_capacity - offset) {
+            m_failedAllocations.store(m_failedAllocations.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        m_used = offset + size;
+        return m_memory + offset;
+    }
+
+
+    //! \brief  Releases every allocation made since the arena was last reset, recording the high-water mark.
+    inline void FrameArena::reset() {
+        if (m_used > m_highWater.load(std::memory_order_relaxed)) {
+            m_highWater.store(m_used, std::memory_order_relaxed);
+        }
+
+        m_used = 0;
+    }
+
+
+    //! \brief  Determines whether the arena has memory to allocate from.
+    //! \return <em>True</em> if the arena has been initialized otherwise <em>false</em>.
+    inline bool FrameArena::isInitialized() const {
+        return nullptr != m_memory;
+    }
+
+
+    //! \brief  Retrieves the size of the arena.
+    //! \return Size (in bytes) of the arena, 0 if it has not been initialized.
+    inline size_t FrameArena::getCapacity() const {
+        return m_capacity;
+    }
+
+
+    //! \brief  Retrieves how much of the arena has been allocated since it was last reset, this may only be called by the owning thread.
+    //! \return The number of bytes allocated, including any padding required for alignment.
+    inline size_t FrameArena::getUsed() const {
+        return m_used;
+    }
+} // namespace raize
+
+
+// -----------------------------------------------------------------------------------
+
+#endif //!defined( FRAME_ARENA_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL )
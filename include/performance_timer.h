@@ -20,14 +20,46 @@
 
 // -----------------------------------------------------------------------------------
 
+#include <stdint.h>
+#include <atomic>
 #include <chrono>
 
+//! This define selects whether the timer reads the processors time-stamp counter, which is
+//! far cheaper than reading the system clock. The counter is only used once calibrate() has
+//! confirmed it is invariant, otherwise the timer falls back to std::chrono::steady_clock.
+//! Define it as 0 as part of your build configuration to always use the system clock.
+#if !defined( RAIZE_TIMER_TSC )
+    #if defined( __x86_64__ ) || defined( __i386__ ) || defined( _M_X64 ) || defined( _M_IX86 )
+        #define RAIZE_TIMER_TSC     1
+    #else
+        #define RAIZE_TIMER_TSC     0
+    #endif
+#endif //!defined( RAIZE_TIMER_TSC )
+
+#if RAIZE_TIMER_TSC
+    #if defined( _MSC_VER )
+        #include <intrin.h>
+    #else
+        #include <x86intrin.h>
+    #endif //defined( _MSC_VER )
+#endif //RAIZE_TIMER_TSC
+
 
 // -----------------------------------------------------------------------------------
 
 namespace raize {
+    //! \brief  Measures elapsed time, using the processors time-stamp counter where it is reliable.
+    //!
+    //! Time is measured in ticks, which are converted to nanoseconds only when an elapsed time
+    //! is requested. Until calibrate() succeeds a tick is one nanosecond of steady_clock, after
+    //! which a tick is one cycle of the invariant time-stamp counter. Calibration happens once
+    //! per process when the first Scheduler is initialized, timers should not be started before
+    //! then as their ticks would be of the wrong kind.
     class PerformanceTimer {
-        typedef std::chrono::high_resolution_clock time_source;
+        typedef std::chrono::steady_clock time_source;
+
+        //! Fractional bits within the fixed point scale that converts ticks to nanoseconds.
+        static const uint32_t kTickScaleBits = 32;
 
     public:
         PerformanceTimer();
@@ -37,8 +69,24 @@ namespace raize {
         uint64_t getElapsedTimeNano() const;
         uint64_t getElapsedTimeMilli() const;
 
+        static uint64_t getTimeNano();
+        static uint64_t getTicks();
+        static uint64_t ticksToNano(uint64_t ticks);
+
+        static bool calibrate();
+        static bool isTscEnabled();
+
     private:
-        time_source::time_point m_start;
+        static void calibrateTsc();
+        static uint64_t readClock();
+
+    private:
+        uint64_t m_start;                           // Ticks when the timer was started
+
+        static std::atomic<bool> s_tscEnabled;      // Set once the time-stamp counter has been calibrated
+        static uint64_t s_tickScale;                // Nanoseconds per tick, with kTickScaleBits fractional bits
+        static uint64_t s_baseTicks;                // Ticks when calibration completed
+        static uint64_t s_baseNano;                 // Clock time (in nanoseconds) when calibration completed
     };
 } // namespace raize
 
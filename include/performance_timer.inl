@@ -23,30 +23,87 @@
 namespace raize {
     //! \brief  Constructor that begins the performance timer for measuring elapsed time.
     inline PerformanceTimer::PerformanceTimer()
-    : m_start(time_source::now())
+    : m_start(getTicks())
     {
     }
 
 
     //! \brief  Resets the timer so it's measurement begins at the current point in time.
     inline void PerformanceTimer::reset() {
-        m_start = time_source::now();
+        m_start = getTicks();
     }
 
 
     //! \brief  Returns the number of milliseconds that have elapsed since the performance timer was created.
     //! \return The number of milliseconds that have elapsed since the performance timer was created.
     inline uint64_t PerformanceTimer::getElapsedTimeMilli() const {
-        const time_source::time_point current = time_source::now();
-        return std::chrono::duration_cast<std::chrono::milliseconds>(current - m_start).count();
+        return getElapsedTimeNano() / 1000000;
     }
 
 
     //! \brief  Returns the number of nanoseconds that have elapsed since the performance timer was created.
     //! \return The number of nanoseconds that have elapsed since the performance timer was created.
     inline uint64_t PerformanceTimer::getElapsedTimeNano() const {
-        const time_source::time_point current = time_source::now();
-        return std::chrono::duration_cast<std::chrono::nanoseconds>(current - m_start).count();
+        return ticksToNano(getTicks() - m_start);
+    }
+
+
+    //! \brief  Returns the current time in nanoseconds, measured from an unspecified point shared by every thread.
+    //! \return The current time in nanoseconds.
+    inline uint64_t PerformanceTimer::getTimeNano() {
+        if (s_tscEnabled.load(std::memory_order_acquire)) {
+            return s_baseNano + ticksToNano(getTicks() - s_baseTicks);
+        }
+
+        return readClock();
+    }
+
+
+    //! \brief  Reads the current tick count, only differences between tick counts are meaningful.
+    //! \return The current tick count.
+    inline uint64_t PerformanceTimer::getTicks() {
+#if RAIZE_TIMER_TSC
+        if (s_tscEnabled.load(std::memory_order_acquire)) {
+            return __rdtsc();
+        }
+#endif //RAIZE_TIMER_TSC
+
+        return readClock();
+    }
+
+
+    //! \brief  Converts a number of ticks into nanoseconds.
+    //! \param  ticks [in] -
+    //!         The number of ticks to be converted, typically the difference between two calls to getTicks().
+    //! \return The number of nanoseconds covered by the ticks.
+    inline uint64_t PerformanceTimer::ticksToNano(uint64_t ticks) {
+        if (!s_tscEnabled.load(std::memory_order_acquire)) {
+            return ticks;
+        }
+
+#if defined( __SIZEOF_INT128__ )
+        return static_cast< uint64_t >((static_cast< unsigned __int128 >(ticks) * s_tickScale) >> kTickScaleBits);
+#else
+        // Split the multiplication so large tick counts do not overflow
+        const uint64_t whole = (ticks >> kTickScaleBits) * s_tickScale;
+        const uint64_t fraction = ((ticks & 0xffffffff) * s_tickScale) >> kTickScaleBits;
+
+        return whole + fraction;
+#endif //defined( __SIZEOF_INT128__ )
+    }
+
+
+    //! \brief  Determines whether the timer is reading the processors time-stamp counter.
+    //! \return <em>True</em> if the time-stamp counter has been calibrated otherwise <em>false</em> if the system clock is used.
+    inline bool PerformanceTimer::isTscEnabled() {
+        return s_tscEnabled.load(std::memory_order_acquire);
+    }
+
+
+    //! \brief  Reads the system clock.
+    //! \return The current time (in nanoseconds) of the steady clock.
+    inline uint64_t PerformanceTimer::readClock() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(time_source::now().time_since_epoch()).count();
     }
 } // namespace raize
 
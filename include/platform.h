@@ -0,0 +1,66 @@
+//
+// Copyright 2017 nfactorial
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#if !defined( PLATFORM_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL )
+#define PLATFORM_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL
+
+
+// -----------------------------------------------------------------------------------
+
+//! This define specifies the size (in bytes) of a cache line on the target platform. Data
+//! written by one thread and read by another is padded to this size so that unrelated
+//! writes do not invalidate each others cache lines. You can override it by defining it
+//! as part of your build configuration.
+#if !defined( RAIZE_CACHE_LINE_SIZE )
+    #define RAIZE_CACHE_LINE_SIZE   64
+#endif //!defined( RAIZE_CACHE_LINE_SIZE )
+
+//! This define specifies the size (in bytes) of the payload stored within each task. Closures
+//! and user data supplied when creating a task are copied into this storage, so it must be
+//! large enough for the biggest payload used by the application. You can override it by
+//! defining it as part of your build configuration.
+#if !defined( RAIZE_TASK_PAYLOAD_SIZE )
+    #define RAIZE_TASK_PAYLOAD_SIZE     48
+#endif //!defined( RAIZE_TASK_PAYLOAD_SIZE )
+
+
+//! This define specifies the largest number of logical processors that may be used when
+//! placing threads on specific cores. You can override it by defining it as part of your
+//! build configuration.
+#if !defined( RAIZE_MAXIMUM_CORES )
+    #define RAIZE_MAXIMUM_CORES     256
+#endif //!defined( RAIZE_MAXIMUM_CORES )
+
+//! This define issues an instruction that tells the processor the calling thread is spinning,
+//! which reduces power consumption and frees resources for any sibling hyper-thread. You can
+//! override it by defining it as part of your build configuration.
+#if !defined( RAIZE_CPU_PAUSE )
+    #if defined( _MSC_VER ) && ( defined( _M_IX86 ) || defined( _M_X64 ) )
+        #include <intrin.h>
+        #define RAIZE_CPU_PAUSE()       _mm_pause()
+    #elif defined( __i386__ ) || defined( __x86_64__ )
+        #define RAIZE_CPU_PAUSE()       __builtin_ia32_pause()
+    #elif defined( __arm__ ) || defined( __aarch64__ )
+        #define RAIZE_CPU_PAUSE()       __asm__ __volatile__( "yield" )
+    #else
+        #define RAIZE_CPU_PAUSE()
+    #endif
+#endif //!defined( RAIZE_CPU_PAUSE )
+
+
+// -----------------------------------------------------------------------------------
+
+#endif //!defined( PLATFORM_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL )
@@ -21,46 +21,146 @@
 // -----------------------------------------------------------------------------------
 
 #include <condition_variable>
+#include <stdint.h>
 #include <atomic>
 #include <mutex>
 
+#include "platform.h"
+
 
 // -----------------------------------------------------------------------------------
 
 namespace raize {
+    //! \brief  Determines how idle worker threads wait for the next command.
+    enum kWaitPolicy {
+        kWaitPolicy_Block,              //!< Workers sleep on a condition variable as soon as they become idle
+        kWaitPolicy_Spin,               //!< Workers spin and then yield for a fixed budget, before sleeping
+        kWaitPolicy_Adaptive,           //!< As kWaitPolicy_Spin, with the budget chosen from the recent gaps between commands
+    };
+
+    //! \brief  Measurements of how quickly worker threads respond to new commands.
+    struct WakeStatistics {
+        uint64_t wakeCount;             //!< Number of times a worker has observed a new command
+        uint64_t spinWakeCount;         //!< Wakes that occurred whilst the worker was spinning
+        uint64_t yieldWakeCount;        //!< Wakes that occurred whilst the worker was yielding
+        uint64_t blockWakeCount;        //!< Wakes that required the worker to be woken from sleep
+        uint64_t totalLatencyNano;      //!< Sum of the time between each command being issued and a worker observing it
+        uint64_t maximumLatencyNano;    //!< Longest time between a command being issued and a worker observing it
+        uint64_t spinBudgetNano;        //!< The spin budget that will be used by the next idle worker
+    };
+
     //! \brief  Implements the synchronization primitives used to manage the worker threads.
+    //!
+    //! Waking a thread that sleeps on a condition variable can take tens of microseconds, which
+    //! delays the start of every frame. The wait policy allows idle workers to spin for a short
+    //! time instead, so a command issued soon after the previous one is noticed immediately.
+    //!
+    //! Commands and their completion are tracked by generation numbers rather than by signals,
+    //! so a notification can never be missed. Workers arrive at the completion barrier with a
+    //! single atomic increment and only the final worker wakes the issuing thread. Mutexes are
+    //! only taken by threads that go to sleep, or to wake a thread that has.
     class ProcessorSync {
     public:
         ProcessorSync();
         ~ProcessorSync();
 
         bool initialize(size_t threadCount);
+        void setThreadCount(size_t threadCount);
 
         void notifyExit();
         void notifyComplete();
         bool notifyExecute(uint64_t timeOut);
 
+        void beginExecute();
+        bool waitComplete(uint64_t timeOut);
+
+        uint64_t getGeneration() const;
+        bool isComplete(uint64_t generation) const;
+
         void waitReady();
-        void waitExecute();
+        uint64_t waitExecute(uint64_t lastGeneration);
 
         void notifyReady();
 
+        void setWaitPolicy(kWaitPolicy waitPolicy, uint64_t spinBudgetNano);
+        kWaitPolicy getWaitPolicy() const;
+
+        void getWakeStatistics(WakeStatistics &wakeStatistics) const;
+        void resetWakeStatistics();
+
     private:
-        std::mutex m_executeMutex;
+        uint64_t getSpinBudget() const;
+        uint64_t recordWake(std::atomic<uint64_t> &wakeCounter);
+        void issueCommand();
+
+        static int64_t getTimestamp();
+
+    private:
+        std::mutex m_executeMutex;          // Only used by workers that have gone to sleep
+        std::mutex m_completionMutex;       // Only used when the issuing thread goes to sleep
         std::mutex m_readyMutex;
 
         std::condition_variable m_readyCondition;
         std::condition_variable m_completionCondition;
         std::condition_variable m_executeCondition;
 
-        size_t m_completionCounter;
+        char m_executePadding[RAIZE_CACHE_LINE_SIZE];
+        std::atomic<uint64_t> m_executeGeneration;  // Incremented each time a command is issued to the worker threads, read by spinning workers
+        char m_generationPadding[RAIZE_CACHE_LINE_SIZE - sizeof(std::atomic<uint64_t>)];
+        std::atomic<size_t> m_completionCounter;    // Number of workers that have completed the current command
+        char m_completionPadding[RAIZE_CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+        std::atomic<uint64_t> m_completedGeneration;    // The most recent generation completed by every worker thread
+        std::atomic<size_t> m_sleepingWorkers;      // Number of workers waiting on the execute condition
+        std::atomic<bool> m_issuerWaiting;          // True whilst the issuing thread waits on the completion condition
+        std::atomic<int64_t> m_executeTimestamp;    // Time (in nanoseconds) the most recent command was issued
+        int64_t m_completeTimestamp;                // Time (in nanoseconds) the previous command completed, only used by the issuing thread
+        uint64_t m_averageGap;                      // Running average of the time between a command completing and the next being issued
+
+        std::atomic<kWaitPolicy> m_waitPolicy;
+        std::atomic<uint64_t> m_spinBudget;         // Fixed budget, or the upper limit of the adaptive budget (in nanoseconds)
+        std::atomic<uint64_t> m_adaptiveBudget;
+
+        std::atomic<uint64_t> m_wakeCount;
+        std::atomic<uint64_t> m_spinWakeCount;
+        std::atomic<uint64_t> m_yieldWakeCount;
+        std::atomic<uint64_t> m_blockWakeCount;
+        std::atomic<uint64_t> m_totalLatency;
+        std::atomic<uint64_t> m_maximumLatency;
+
         size_t m_readyCounter;
         size_t m_totalThreads;
+        size_t m_coreCount;             // Number of hardware threads, used to avoid spinning when the machine is oversubscribed
 
         ProcessorSync(const ProcessorSync &other);
 
         ProcessorSync &operator=(const ProcessorSync &other);
     };
+
+
+    //! \brief  Retrieves how idle worker threads wait for the next command.
+    //! \return The wait policy currently in use.
+    inline kWaitPolicy ProcessorSync::getWaitPolicy() const {
+        return m_waitPolicy.load(std::memory_order_relaxed);
+    }
+
+
+    //! \brief  Retrieves the generation of the most recently issued command.
+    //! \return The generation of the most recently issued command.
+    //!
+    //! This may only be called by the issuing thread, or by a worker thread before it calls
+    //! notifyReady(), as no command is issued until every worker is ready.
+    inline uint64_t ProcessorSync::getGeneration() const {
+        return m_executeGeneration.load(std::memory_order_relaxed);
+    }
+
+
+    //! \brief  Determines whether every worker thread has completed a command.
+    //! \param  generation [in] -
+    //!         Generation of the command, as returned by getGeneration() after the command was issued.
+    //! \return <em>True</em> if the command has been completed otherwise <em>false</em>.
+    inline bool ProcessorSync::isComplete(uint64_t generation) const {
+        return m_completedGeneration.load(std::memory_order_acquire) >= generation;
+    }
 } // namespace raize
 
 
@@ -0,0 +1,96 @@
+//
+// Copyright 2017 nfactorial
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#if !defined( PROFILER_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL )
+#define PROFILER_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL
+
+
+// -----------------------------------------------------------------------------------
+
+#include <stdint.h>
+
+#include "performance_timer.h"
+
+
+// -----------------------------------------------------------------------------------
+
+//! Values accepted by the RAIZE_PROFILER define.
+#define RAIZE_PROFILER_NULL         0       //!< Nothing is measured, tasks are executed with a bare call
+#define RAIZE_PROFILER_TIMING       1       //!< The duration of every task is measured, see Scheduler::getStatistics()
+#define RAIZE_PROFILER_TRACING      2       //!< As RAIZE_PROFILER_TIMING, and tasks may also be traced, see Scheduler::initializeTracing()
+
+//! This define selects the instrumentation compiled into the task processors. Hosts may define
+//! it as RAIZE_PROFILER_NULL as part of their master build configuration, so that executing a
+//! task costs nothing beyond calling its function. The raize library and the host must be
+//! built with the same value.
+#if !defined( RAIZE_PROFILER )
+    #define RAIZE_PROFILER      RAIZE_PROFILER_TRACING
+#endif //!defined( RAIZE_PROFILER )
+
+
+// -----------------------------------------------------------------------------------
+
+namespace raize {
+    //! \brief  Instrumentation policy that measures nothing.
+    //!
+    //! Every measurement is a constant, so the compiler removes the instrumentation entirely.
+    struct NullProfiler {
+        static const bool kTiming = false;          //!< Whether task durations and completion times are measured
+        static const bool kTracing = false;         //!< Whether tasks may be recorded within trace buffers
+
+        static uint64_t getTicks() {
+            return 0;
+        }
+
+        static uint64_t getElapsedNano(uint64_t) {
+            return 0;
+        }
+    };
+
+    //! \brief  Instrumentation policy that measures the duration of every task.
+    struct TimingProfiler {
+        static const bool kTiming = true;
+        static const bool kTracing = false;
+
+        static uint64_t getTicks() {
+            return PerformanceTimer::getTicks();
+        }
+
+        static uint64_t getElapsedNano(uint64_t startTicks) {
+            return PerformanceTimer::ticksToNano(PerformanceTimer::getTicks() - startTicks);
+        }
+    };
+
+    //! \brief  Instrumentation policy that measures the duration of every task, and supports tracing.
+    struct TracingProfiler : public TimingProfiler {
+        static const bool kTracing = true;
+    };
+
+#if RAIZE_PROFILER == RAIZE_PROFILER_NULL
+    typedef NullProfiler Profiler;
+#elif RAIZE_PROFILER == RAIZE_PROFILER_TIMING
+    typedef TimingProfiler Profiler;
+#elif RAIZE_PROFILER == RAIZE_PROFILER_TRACING
+    typedef TracingProfiler Profiler;
+#else
+    #error RAIZE_PROFILER must be RAIZE_PROFILER_NULL, RAIZE_PROFILER_TIMING or RAIZE_PROFILER_TRACING
+#endif //RAIZE_PROFILER == RAIZE_PROFILER_NULL
+} // namespace raize
+
+
+// -----------------------------------------------------------------------------------
+
+#endif //!defined( PROFILER_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL )
@@ -0,0 +1,51 @@
+//
+// Copyright 2017 nfactorial
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#if !defined( RESOURCE_ACCESS_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL )
+#define RESOURCE_ACCESS_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL
+
+
+// -----------------------------------------------------------------------------------
+
+#include <stdint.h>
+
+
+// -----------------------------------------------------------------------------------
+
+namespace raize {
+    //! \brief  Application defined identifier for a piece of data accessed by tasks.
+    //!
+    //! Raize attaches no meaning to the value, it is only compared against the identifiers
+    //! declared by other tasks.
+    typedef uint32_t ResourceId;
+
+    //! \brief  Describes how a task accesses a resource.
+    enum kResourceAccess {
+        kResourceAccess_Read,           //!< The task only reads the resource, any number of readers may run together
+        kResourceAccess_Write,          //!< The task modifies the resource, it must not run alongside any other task using the resource
+    };
+
+    //! \brief  Declares a single resource used by a task.
+    struct ResourceAccess {
+        ResourceId resource;            //!< The resource being accessed
+        kResourceAccess access;         //!< How the resource is accessed
+    };
+} // namespace raize
+
+
+// -----------------------------------------------------------------------------------
+
+#endif //!defined( RESOURCE_ACCESS_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL )
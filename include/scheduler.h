@@ -22,7 +22,9 @@
 
 #include <stdint.h>
 #include <array>
+#include <memory>
 
+#include "performance_timer.h"
 #include "processor_sync.h"
 #include "task_processor.h"
 #include "task_provider.h"
@@ -31,42 +33,82 @@
 // -----------------------------------------------------------------------------------
 
 //! This define specifies the maximum number of threads the scheduler will support
-//! at run time, you can override it by redefining it here or defining it as part
-//! of your build configuration.
+//! at run time when no maximum is supplied to Scheduler::initialize(), you can override
+//! it by redefining it here or defining it as part of your build configuration.
 #if !defined( RAIZE_SCHEDULER_MAXIMUM_THREADS )
     #define RAIZE_SCHEDULER_MAXIMUM_THREADS    4
 #endif //!defined( RAIZE_SCHEDULER_MAXIMUM_THREADS )
 
+//! This define specifies the number of task lists the scheduler cycles between when frames
+//! are submitted with executeAsync(). Whilst one list is being processed the application
+//! builds the next, so at least two lists are required.
+#if !defined( RAIZE_SCHEDULER_TASK_LISTS )
+    #define RAIZE_SCHEDULER_TASK_LISTS    2
+#endif //!defined( RAIZE_SCHEDULER_TASK_LISTS )
+
+#if RAIZE_SCHEDULER_TASK_LISTS < 2
+    #error RAIZE_SCHEDULER_TASK_LISTS must be at least 2
+#endif //RAIZE_SCHEDULER_TASK_LISTS < 2
+
+//! This define specifies the number of frames recorded within each histogram of the rolling
+//! statistics window. The percentiles reported by getStatistics() cover between one and two
+//! multiples of this number of recent frames.
+#if !defined( RAIZE_STATISTICS_WINDOW_FRAMES )
+    #define RAIZE_STATISTICS_WINDOW_FRAMES    128
+#endif //!defined( RAIZE_STATISTICS_WINDOW_FRAMES )
+
 
 // -----------------------------------------------------------------------------------
 
 //!< \brief Class responsible for managing all the threads and tasks within the application.
 //!
-//! The Raize scheduler supports a maximum number of threads as defined by the RAIZE_SCHEDULER_MAXIMUM_THREADS
-//! define. This define allows the application to specify a per-platform constant for the number of supported
-//! threads.
-//!
-//! On platforms that have a varying number of of threads (such as home desktop machines) the define should be
-//! set to a reasonable maximum number. The title is then free to determine the number of cores it wishes
-//! to make use of at run-time and supply the correct amount to the initialize method.
+//! The Raize scheduler supports a maximum number of threads, which is reserved when the scheduler is
+//! initialized. By default this is the RAIZE_SCHEDULER_MAXIMUM_THREADS define, which allows the application
+//! to specify a per-platform constant for the number of supported threads.
 //!
-//! For example, a title may reasonably specify a maximum of 16 threads on a home machine, then determine
-//! the host machine has only 2 cores at run-time.
+//! On platforms that have a varying number of of threads (such as home desktop machines) the maximum may
+//! instead be determined at run-time. The number of threads in use may then be changed between frames with
+//! resize(), for example to give up cores whilst other processes need them.
 //!
 //! \code
 //! void exmaple()
 //! {
 //!     raize::Scheduler scheduler;
 //!
-//!     scheduler.initialize( min( getNumProcessorCores(), RAIZE_SCHEDULER_MAXIMUM_THREADS ) );
+//!     scheduler.initialize( getNumProcessorCores(), getNumProcessorCores(), raize::kCallerMode_Wait, nullptr );
+//!
+//!     // Later, when the machine is under pressure
+//!     scheduler.shrink( 2 );
 //! }
 //! \endcode
 //!
 //! Note that it is left to the application author to implement getNumProcessorCores in the above example.
 //!
 namespace raize {
+    //! \brief  Determines whether the thread that calls Scheduler::execute() helps to process the tasks.
+    enum kCallerMode {
+        kCallerMode_Wait,               //!< The calling thread sleeps until the worker threads have processed every task
+        kCallerMode_Participate,        //!< The calling thread processes tasks alongside the worker threads, one fewer worker thread is created
+    };
+
+    //! \brief  Determines what the scheduler does when a frame is not completed within its time out.
+    enum kHangPolicy {
+        kHangPolicy_Return,             //!< The call returns false and the frame remains in flight, the next call waits for it to complete
+        kHangPolicy_Wait,               //!< The time out is ignored and the scheduler keeps waiting for the frame, reporting long tasks meanwhile
+        kHangPolicy_Shutdown,           //!< The scheduler is shut down, which still waits for the running tasks to return
+    };
+
+    //! \brief  Called by the thread waiting for a frame for each task that has exceeded the watchdog budget.
+    typedef void (*LongTaskFunction)(const LongTaskReport &longTask);
+
+    //! \brief  Identifies a frame submitted by Scheduler::executeAsync(), used to poll or wait for its completion.
+    struct FrameHandle {
+        uint64_t generation;            //!< Generation of the command that processes the frame, 0 if the frame completed during submission
+    };
+
     class Scheduler {
-        typedef std::array<TaskProcessor, RAIZE_SCHEDULER_MAXIMUM_THREADS> TaskProcessorList;
+        typedef std::unique_ptr<TaskProcessor[]> TaskProcessorList;
+        typedef std::array<TaskProvider, RAIZE_SCHEDULER_TASK_LISTS> TaskListArray;
 
     public:
         Scheduler();
@@ -74,28 +116,159 @@ namespace raize {
 
         bool initialize();
         bool initialize(size_t threadCount);
+        bool initialize(size_t threadCount, kCallerMode callerMode);
+        bool initialize(size_t threadCount, kCallerMode callerMode, const ThreadPlacement *placements);
+        bool initialize(size_t threadCount, size_t maximumThreadCount, kCallerMode callerMode, const ThreadPlacement *placements);
+
+        bool resize(size_t threadCount);
+        bool grow(size_t threadCount);
+        bool shrink(size_t threadCount);
+
+        bool initializeFibers(size_t fiberCount, size_t stackSize);
+
+        bool initializeArenas(size_t capacity);
+        bool initializeArenas(size_t capacity, bool hugePages);
+        void shutdownArenas();
+
+        bool initializeTracing(size_t eventCapacity);
+        void shutdownTracing();
+        bool writeTrace(FILE *file, size_t frameCount);
 
         void shutdown();
 
         bool execute();
         bool execute(uint64_t timeOut);
 
+        bool executeAsync(FrameHandle &frameHandle);
+        bool executeAsync(FrameHandle &frameHandle, uint64_t timeOut);
+
+        bool isFrameComplete(const FrameHandle &frameHandle) const;
+        bool waitFrame(const FrameHandle &frameHandle);
+        bool waitFrame(const FrameHandle &frameHandle, uint64_t timeOut);
+
         bool createTask(TaskExecuteFunction taskFunction);
+        bool createTask(TaskExecuteFunction taskFunction, TaskId *taskId);
+        bool createTask(TaskExecuteFunction taskFunction, kTaskPriority priority, TaskId *taskId);
+        bool createTask(TaskExecuteFunction taskFunction, const TaskId *dependencies, size_t dependencyCount, TaskId *taskId);
+        bool createTask(TaskExecuteFunction taskFunction, const TaskId *dependencies, size_t dependencyCount, const ResourceAccess *accesses, size_t accessCount, TaskId *taskId);
+        bool createTask(TaskPayloadFunction taskFunction, const void *payload, size_t payloadSize, TaskId *taskId);
+        bool createTask(TaskPayloadFunction taskFunction, const void *payload, size_t payloadSize, kTaskPriority priority, TaskId *taskId);
+        bool createTask(TaskPayloadFunction taskFunction, const void *payload, size_t payloadSize, const TaskId *dependencies, size_t dependencyCount, TaskId *taskId);
+
+        template< typename Callable > bool createTask(const Callable &callable);
+        template< typename Callable > bool createTask(const Callable &callable, TaskId *taskId);
+        template< typename Callable > bool createTask(const Callable &callable, kTaskPriority priority, TaskId *taskId);
+        template< typename Callable > bool createTask(const Callable &callable, const TaskId *dependencies, size_t dependencyCount, TaskId *taskId);
+
+        bool submitTask(TaskExecuteFunction taskFunction);
+        bool submitTask(TaskExecuteFunction taskFunction, kTaskPriority priority, TaskId *taskId);
+        bool submitTask(TaskPayloadFunction taskFunction, const void *payload, size_t payloadSize, TaskId *taskId);
+        template< typename Callable > bool submitTask(const Callable &callable);
+
+        static bool spawnTask(TaskExecuteFunction taskFunction);
+        static bool spawnTask(TaskPayloadFunction taskFunction, const void *payload, size_t payloadSize);
+        template< typename Callable > static bool spawnTask(const Callable &callable);
+
+        static void waitForCounter(const std::atomic<uint32_t> &counter);
+
+        static ExecutionContext *getCurrentContext();
+        static void *allocateFrameMemory(size_t size);
+        static void *allocateFrameMemory(size_t size, size_t alignment);
+
+        bool parallelFor(size_t begin, size_t end, size_t grainSize, RangeExecuteFunction rangeFunction);
+        bool parallelFor(size_t begin, size_t end, size_t grainSize, RangeExecuteFunction rangeFunction, const TaskId *dependencies, size_t dependencyCount, TaskId *taskId);
+
+        bool setTaskPriority(TaskId taskId, kTaskPriority priority);
+
+        bool compile();
+
+        void setTaskClaimMode(kTaskClaimMode claimMode);
+        void setWaitPolicy(kWaitPolicy waitPolicy, uint64_t spinBudgetNano);
+
+        void setHangPolicy(kHangPolicy hangPolicy);
+        void setWatchdog(uint64_t budgetNano, LongTaskFunction longTaskFunction);
+        size_t findLongTasks(uint64_t budgetNano, LongTaskReport *longTasks, size_t longTaskCapacity) const;
+
+        void getWakeStatistics(WakeStatistics &wakeStatistics) const;
+        void resetWakeStatistics();
+
+        void getPriorityStatistics(kTaskPriority priority, PriorityStatistics &priorityStatistics) const;
+        void resetPriorityStatistics();
+
+        void getStatistics(SchedulerStatistics &statistics) const;
+        bool getContextStatistics(size_t contextId, ContextStatistics &contextStatistics) const;
+        void resetStatistics();
+
+        bool getArenaStatistics(size_t contextId, ArenaStatistics &arenaStatistics) const;
+        void resetArenaStatistics();
 
         size_t getThreadCount() const;
+        size_t getWorkerCount() const;
+        size_t getMaximumThreadCount() const;
+        kCallerMode getCallerMode() const;
         size_t getMaximumTasks() const;
         uint64_t getExecutionTime() const;
 
     private:
+        bool initializeThreads(size_t threadCount, size_t maximumThreadCount, kCallerMode callerMode, const ThreadPlacement *placements, size_t placementCount);
+        bool startWorkers(size_t workerCount);
+        void stopWorkers(size_t workerCount);
+        void prepareContext(size_t contextId);
+        void releaseContext(size_t contextId);
+        void describeContext(size_t contextId, ExecutionContext &executionContext) const;
+
         bool executeTasks(TaskProvider &taskProvider, uint64_t timeOut);
+        void postExecute(TaskProvider &taskProvider);
+        bool waitTasks(uint64_t timeOut);
+        void reportLongTasks() const;
+        bool completeFrame(uint64_t timeOut);
+        bool waitBuildList();
+
+        void beginFrame();
+        void endFrame();
+
+        template< typename Callable > static void invokeCallable(void *payload);
 
     private:
         uint64_t m_executionTime;            // How long did it take to process the entire graph (in milliseconds)
-        size_t m_threadCount;              // Number of threads in use
+        size_t m_threadCount;              // Number of threads in use, including the calling thread when it participates
+        size_t m_workerCount;              // Number of threads created by the scheduler
+        size_t m_maximumThreadCount;       // Number of execution contexts reserved by initialize()
+        kCallerMode m_callerMode;
+        kHangPolicy m_hangPolicy;
+
+        uint64_t m_taskBudgetNano;          // Tasks executing for longer than this are reported whilst waiting for a frame
+        LongTaskFunction m_longTaskFunction;    // Receives the long tasks, nullptr if the watchdog is disabled
+
+        size_t m_buildList;                 // Index of the task list that receives new tasks
+        size_t m_pendingList;               // Index of the task list submitted by executeAsync(), only valid whilst m_framePending is set
+        bool m_framePending;
+        uint64_t m_pendingGeneration;
+        PerformanceTimer m_frameTimer;      // Started when a frame is submitted by executeAsync()
+
+        uint64_t m_frameBeginNano;          // When the frame being processed began
+
+        TraceBuffer m_frameTrace;           // Records the span of each frame, when tracing is enabled
+        uint32_t m_traceFrame;              // Number of frames completed since tracing was enabled
+
+        size_t m_fiberCount;                // Fibers given to each context by initializeFibers(), 0 if tasks run upon their threads
+        size_t m_fiberStackSize;
+
+        size_t m_arenaCapacity;             // Size of each contexts arena given by initializeArenas(), 0 if arenas are not in use
+        bool m_arenaHugePages;
+
+        // Only written by the thread that submits frames, but may be read by any thread
+        Histogram m_frameDurations[kRaizeStatisticsWindows];
+        uint32_t m_statisticsWindow;        // Number of the rolling window receiving frame durations
+        uint32_t m_windowFrames;            // Number of frames recorded within the current window
+        std::atomic<uint64_t> m_frameCount;
+        std::atomic<uint64_t> m_totalFrameNano;
+        PerformanceTimer m_statisticsTimer; // Started when the statistics were last reset
 
-        TaskProvider m_taskProvider;
+        TaskListArray m_taskLists;
         ProcessorSync m_syncObject;
-        TaskProcessorList m_taskProcessors;
+        TaskProcessorList m_taskProcessors;            // One processor for each of the m_maximumThreadCount contexts
+        std::unique_ptr<ThreadPlacement[]> m_placements;    // Placement of each context, applied as its thread starts
 
         Scheduler(const Scheduler &other);
 
@@ -110,6 +283,27 @@ namespace raize {
     }
 
 
+    //! \brief  Retrieves the number of worker threads created by the scheduler.
+    //! \return The number of worker threads created by the scheduler.
+    inline size_t Scheduler::getWorkerCount() const {
+        return m_workerCount;
+    }
+
+
+    //! \brief  Retrieves the largest number of threads the scheduler may be resized to.
+    //! \return The maximum number of threads supplied when the scheduler was initialized.
+    inline size_t Scheduler::getMaximumThreadCount() const {
+        return m_maximumThreadCount;
+    }
+
+
+    //! \brief  Retrieves whether the thread that calls execute() helps to process the tasks.
+    //! \return The mode the scheduler was initialized with.
+    inline kCallerMode Scheduler::getCallerMode() const {
+        return m_callerMode;
+    }
+
+
     //! \brief  Returns the time (in milliseconds) taken to execute the previous execution phase of the task graph.
     //! \return The time (in milliseconds) the scheduler took to complete the last execution phase.
     inline uint64_t Scheduler::getExecutionTime() const {
@@ -118,6 +312,11 @@ namespace raize {
 } // namespace raize
 
 
+// -----------------------------------------------------------------------------------
+
+#include "scheduler.inl"
+
+
 // -----------------------------------------------------------------------------------
 
 #endif //!defined( SCHEDULER_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL )
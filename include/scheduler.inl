@@ -0,0 +1,127 @@
+//
+// Copyright 2017 nfactorial
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#if !defined( SCHEDULER_INL_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL )
+#define SCHEDULER_INL_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL
+
+
+// -----------------------------------------------------------------------------------
+
+#include <type_traits>
+
+
+// -----------------------------------------------------------------------------------
+
+namespace raize {
+    //! \brief  Creates a new task that invokes a copy of the supplied callable object.
+    //! \param  callable [in] -
+    //!         The object invoked when the task is executed, typically a lambda.
+    //! \return <i>True</i> if the task was successfully created otherwise <i>false</i>.
+    template< typename Callable >
+    inline bool Scheduler::createTask(const Callable &callable) {
+        return createTask(callable, nullptr, 0, nullptr);
+    }
+
+    //! \brief  Creates a new task that invokes a copy of the supplied callable object.
+    //! \param  callable [in] -
+    //!         The object invoked when the task is executed, typically a lambda.
+    //! \param  taskId [out] -
+    //!         Receives the identifier of the new task, may be <i>nullptr</i> if the identifier is not required.
+    //! \return <i>True</i> if the task was successfully created otherwise <i>false</i>.
+    template< typename Callable >
+    inline bool Scheduler::createTask(const Callable &callable, TaskId *taskId) {
+        return createTask(callable, nullptr, 0, taskId);
+    }
+
+    //! \brief  Creates a new task that invokes a copy of the supplied callable object.
+    //! \param  callable [in] -
+    //!         The object invoked when the task is executed, typically a lambda.
+    //! \param  priority [in] -
+    //!         The priority class of the new task.
+    //! \param  taskId [out] -
+    //!         Receives the identifier of the new task, may be <i>nullptr</i> if the identifier is not required.
+    //! \return <i>True</i> if the task was successfully created otherwise <i>false</i>.
+    template< typename Callable >
+    inline bool Scheduler::createTask(const Callable &callable, kTaskPriority priority, TaskId *taskId) {
+        static_assert(sizeof(Callable) <= kRaizeTaskPayloadSize, "Callable is too large for the task payload, increase RAIZE_TASK_PAYLOAD_SIZE");
+        static_assert(alignof(Callable) <= alignof(TaskPayload), "Callable requires a greater alignment than the task payload provides");
+        static_assert(std::is_trivially_copyable< Callable >::value, "Callable must be trivially copyable, as the payload is never destroyed");
+
+        return createTask(&Scheduler::invokeCallable< Callable >, &callable, sizeof(Callable), priority, taskId);
+    }
+
+    //! \brief  Creates a new task that invokes a copy of the supplied callable object.
+    //! \param  callable [in] -
+    //!         The object invoked when the task is executed, typically a lambda.
+    //! \param  dependencies [in] -
+    //!         Identifiers of previously created tasks that must complete before the new task is executed, may be <i>nullptr</i>.
+    //! \param  dependencyCount [in] -
+    //!         The number of entries within the dependencies array.
+    //! \param  taskId [out] -
+    //!         Receives the identifier of the new task, may be <i>nullptr</i> if the identifier is not required.
+    //! \return <i>True</i> if the task was successfully created otherwise <i>false</i>.
+    //!
+    //! The callable is copied into the payload stored within the task, so creating the task
+    //! never allocates memory. Callables that do not fit within RAIZE_TASK_PAYLOAD_SIZE, or that
+    //! cannot be copied byte for byte, are rejected at compile time.
+    template< typename Callable >
+    inline bool Scheduler::createTask(const Callable &callable, const TaskId *dependencies, size_t dependencyCount, TaskId *taskId) {
+        static_assert(sizeof(Callable) <= kRaizeTaskPayloadSize, "Callable is too large for the task payload, increase RAIZE_TASK_PAYLOAD_SIZE");
+        static_assert(alignof(Callable) <= alignof(TaskPayload), "Callable requires a greater alignment than the task payload provides");
+        static_assert(std::is_trivially_copyable< Callable >::value, "Callable must be trivially copyable, as the payload is never destroyed");
+
+        return createTask(&Scheduler::invokeCallable< Callable >, &callable, sizeof(Callable), dependencies, dependencyCount, taskId);
+    }
+
+    //! \brief  Submits a task that invokes a copy of the supplied callable object, from any thread.
+    //! \param  callable [in] -
+    //!         The object invoked when the task is executed, typically a lambda.
+    //! \return <i>True</i> if the task was submitted otherwise <i>false</i> if the task list is full.
+    template< typename Callable >
+    inline bool Scheduler::submitTask(const Callable &callable) {
+        static_assert(sizeof(Callable) <= kRaizeTaskPayloadSize, "Callable is too large for the task payload, increase RAIZE_TASK_PAYLOAD_SIZE");
+        static_assert(alignof(Callable) <= alignof(TaskPayload), "Callable requires a greater alignment than the task payload provides");
+        static_assert(std::is_trivially_copyable< Callable >::value, "Callable must be trivially copyable, as the payload is never destroyed");
+
+        return submitTask(&Scheduler::invokeCallable< Callable >, &callable, sizeof(Callable), nullptr);
+    }
+
+    //! \brief  Spawns a task that invokes a copy of the supplied callable object, from within a running task.
+    //! \param  callable [in] -
+    //!         The object invoked when the task is executed, typically a lambda.
+    //! \return <i>True</i> if the task was spawned otherwise <i>false</i>.
+    template< typename Callable >
+    inline bool Scheduler::spawnTask(const Callable &callable) {
+        static_assert(sizeof(Callable) <= kRaizeTaskPayloadSize, "Callable is too large for the task payload, increase RAIZE_TASK_PAYLOAD_SIZE");
+        static_assert(alignof(Callable) <= alignof(TaskPayload), "Callable requires a greater alignment than the task payload provides");
+        static_assert(std::is_trivially_copyable< Callable >::value, "Callable must be trivially copyable, as the payload is never destroyed");
+
+        return spawnTask(&Scheduler::invokeCallable< Callable >, &callable, sizeof(Callable));
+    }
+
+    //! \brief  Invokes a callable object stored within a tasks payload.
+    //! \param  payload [in] -
+    //!         The payload containing the callable object.
+    template< typename Callable >
+    inline void Scheduler::invokeCallable(void *payload) {
+        (*static_cast< Callable* >(payload))();
+    }
+} // namespace raize
+
+
+// -----------------------------------------------------------------------------------
+
+#endif //!defined( SCHEDULER_INL_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL )
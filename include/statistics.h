@@ -0,0 +1,147 @@
+//
+// Copyright 2017 nfactorial
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#if !defined( STATISTICS_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL )
+#define STATISTICS_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL
+
+
+// -----------------------------------------------------------------------------------
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+
+// -----------------------------------------------------------------------------------
+
+namespace raize {
+    //! Durations are recorded into a set of histograms that are rotated as frames complete, the
+    //! oldest histogram being cleared, so statistics cover a rolling window of recent frames.
+    static const uint32_t kRaizeStatisticsWindows = 2;
+
+    //! \brief  Summary of a set of durations recorded within a Histogram.
+    struct DurationStatistics {
+        uint64_t count;                 //!< Number of durations recorded
+        uint64_t p50Nano;               //!< Median duration
+        uint64_t p95Nano;
+        uint64_t p99Nano;
+        uint64_t maximumNano;           //!< Longest duration, to the precision of the histogram
+    };
+
+    //! \brief  Describes how an execution context spent its time since the statistics were last reset.
+    struct ContextStatistics {
+        uint64_t busyNano;              //!< Time spent executing tasks
+        uint64_t waitNano;              //!< Time spent within a frame without a task to execute, such as waiting for dependencies
+        uint64_t idleNano;              //!< Time spent outside of any frame
+        uint64_t tasksProcessed;        //!< Number of tasks and range chunks executed
+    };
+
+    //! \brief  Describes work that an execution context has been executing for longer than expected.
+    struct LongTaskReport {
+        uint64_t elapsedNano;           //!< Time the work has been executing for, so far
+        uint32_t taskId;                //!< The registered task, the range task a chunk belongs to, or the registered task that spawned the work
+        uint32_t contextId;             //!< The execution context executing the work
+        uint32_t kind;                  //!< The kTraceEvent describing the work
+    };
+
+    //! \brief  Measurements of the scheduler as a whole.
+    struct SchedulerStatistics {
+        DurationStatistics frameDuration;   //!< Durations of the frames within the rolling window
+        DurationStatistics taskDuration;    //!< Durations of the tasks and range chunks within the rolling window
+        uint64_t frameCount;                //!< Number of frames completed since the statistics were last reset
+        uint64_t totalTaskNano;             //!< Time spent executing tasks by every context since the statistics were last reset
+        uint64_t totalFrameNano;            //!< Time spent processing frames since the statistics were last reset
+        double parallelSpeedup;             //!< The total task time divided by the total frame time
+    };
+
+    //! \brief  Fixed size histogram of durations, with buckets spaced logarithmically.
+    //!
+    //! Similar to an HDR histogram, values are grouped by their highest set bit and each group is
+    //! divided into kHistogramSubBuckets linear buckets. Every value is therefore stored to within
+    //! 1/kHistogramSubBuckets of its true value, whatever its magnitude, in a fixed amount of memory.
+    //!
+    //! Recording is lock-free and intended for a single writing thread, any thread may read the
+    //! histogram whilst it is being written.
+    class Histogram {
+    public:
+        static const uint32_t kHistogramSubBucketBits = 4;
+        static const uint32_t kHistogramSubBuckets = 1 << kHistogramSubBucketBits;
+        static const uint32_t kHistogramBucketCount = (64 - kHistogramSubBucketBits + 1) * kHistogramSubBuckets;
+
+        Histogram();
+        ~Histogram();
+
+        void record(uint64_t value);
+        void clear();
+        void merge(const Histogram &other);
+
+        uint64_t getCount() const;
+        uint64_t getPercentile(double fraction) const;
+        void getStatistics(DurationStatistics &durationStatistics) const;
+
+        static uint32_t getBucketIndex(uint64_t value);
+        static uint64_t getBucketValue(uint32_t bucket);
+
+    private:
+        std::atomic<uint64_t> m_counts[kHistogramBucketCount];
+
+        Histogram(const Histogram &other);
+
+        Histogram &operator=(const Histogram &other);
+    };
+
+
+    //! \brief  Adds a value to the histogram, this may only be called by a single thread at a time.
+    //! \param  value [in] -
+    //!         The value to be recorded.
+    inline void Histogram::record(uint64_t value) {
+        std::atomic<uint64_t> &count = m_counts[getBucketIndex(value)];
+
+        // Only one thread writes, so the increment need not be a locked instruction
+        count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+
+    //! \brief  Determines the bucket a value is recorded within.
+    //! \param  value [in] -
+    //!         The value whose bucket is required.
+    //! \return Index of the bucket holding the value.
+    inline uint32_t Histogram::getBucketIndex(uint64_t value) {
+        if (value < kHistogramSubBuckets) {
+            return static_cast< uint32_t >(value);
+        }
+
+        // Values below 2^kHistogramSubBucketBits are stored exactly, above that each power of two has its own group
+#if defined( __GNUC__ )
+        const uint32_t highestBit = 63 - static_cast< uint32_t >(__builtin_clzll(value));
+#else
+        uint32_t highestBit = 63;
+        while (0 == (value >> highestBit)) {
+            --highestBit;
+        }
+#endif //defined( __GNUC__ )
+
+        const uint32_t shift = highestBit - kHistogramSubBucketBits;
+        const uint32_t subBucket = static_cast< uint32_t >(value >> shift) & (kHistogramSubBuckets - 1);
+
+        return (shift + 1) * kHistogramSubBuckets + subBucket;
+    }
+} // namespace raize
+
+
+// -----------------------------------------------------------------------------------
+
+#endif //!defined( STATISTICS_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL )
@@ -0,0 +1,157 @@
+//
+// Copyright 2017 nfactorial
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#if !defined( TASK_GRAPH_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL )
+#define TASK_GRAPH_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL
+
+
+// -----------------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "task_info.h"
+
+
+// -----------------------------------------------------------------------------------
+
+namespace raize {
+    //! \brief  Compiled form of the dependencies between the registered tasks, replayed every frame.
+    //!
+    //! Tasks are registered with their dependencies stored as linked lists of edges, which is
+    //! convenient to build but slow to walk. Once the task list is known, the graph compiles
+    //! the edges into flat arrays (each task's successors are stored contiguously) along with
+    //! the list of tasks that are ready at the start of a frame, grouped by priority class.
+    //!
+    //! The predecessor counters are never reset between frames. Instead they accumulate, and a
+    //! task is released when its counter reaches its predecessor count multiplied by the number
+    //! of frames processed since compilation. Beginning a frame therefore costs nothing beyond
+    //! incrementing the frame number, no matter how many tasks have dependencies.
+    //!
+    //! All storage is reserved when the graph is initialized, compiling never allocates memory.
+    //!
+    class TaskGraph {
+    public:
+        TaskGraph();
+        ~TaskGraph();
+
+        bool initialize(size_t taskCapacity, size_t dependencyCapacity);
+        void shutdown();
+
+        bool compile(const TaskInfo *tasks, size_t taskCount, const TaskEdge *edges);
+        void invalidate();
+
+        void beginFrame();
+
+        bool releaseSuccessor(TaskId successor);
+
+        const TaskId *getSuccessorsBegin(TaskId taskId) const;
+        const TaskId *getSuccessorsEnd(TaskId taskId) const;
+
+        TaskId getReadyTask(size_t position) const;
+        size_t getReadyClassBegin(uint32_t priority) const;
+
+        size_t getReadyCount() const;
+        size_t getTaskCount() const;
+        bool isCompiled() const;
+
+    private:
+        typedef std::vector<uint32_t> OffsetList;
+        typedef std::vector<TaskId> TaskIdList;
+
+        bool m_compiled;
+        uint64_t m_frame;                   //!< Number of frames begun since the graph was compiled
+        size_t m_taskCount;
+
+        OffsetList m_successorOffsets;      //!< Position of each tasks first successor, with a final entry marking the end
+        OffsetList m_predecessorCounts;
+        TaskIdList m_successors;
+        TaskIdList m_readyTasks;            //!< Tasks that have no predecessors, ordered by priority then by the order they were registered
+        size_t m_readyClassOffsets[kTaskPriority_Count + 1];    //!< Position of each priority class within the ready list
+        std::unique_ptr<std::atomic<uint64_t>[]> m_arrivals;
+
+        TaskGraph(const TaskGraph &other);
+
+        TaskGraph &operator=(const TaskGraph &other);
+    };
+
+
+    //! \brief  Records the completion of one of a tasks predecessors within the current frame.
+    //! \param  successor [in] -
+    //!         The task whose predecessor has completed.
+    //! \return <em>True</em> if every predecessor has now completed and the task may begin, otherwise <em>false</em>.
+    inline bool TaskGraph::releaseSuccessor(TaskId successor) {
+        const uint64_t arrivals = m_arrivals[successor].fetch_add(1, std::memory_order_acq_rel) + 1;
+        return arrivals == m_frame * m_predecessorCounts[successor];
+    }
+
+    //! \brief  Retrieves the first of the tasks that depend upon the specified task.
+    //! \param  taskId [in] -
+    //!         The task whose successors are required.
+    //! \return Pointer to the first successor of the task.
+    inline const TaskId *TaskGraph::getSuccessorsBegin(TaskId taskId) const {
+        return m_successors.data() + m_successorOffsets[taskId];
+    }
+
+    //! \brief  Retrieves the end of the list of tasks that depend upon the specified task.
+    //! \param  taskId [in] -
+    //!         The task whose successors are required.
+    //! \return Pointer one past the final successor of the task.
+    inline const TaskId *TaskGraph::getSuccessorsEnd(TaskId taskId) const {
+        return m_successors.data() + m_successorOffsets[taskId + 1];
+    }
+
+    //! \brief  Retrieves one of the tasks that are ready to begin at the start of a frame.
+    //! \param  position [in] -
+    //!         Position of the task within the ready list.
+    //! \return Identifier of the ready task.
+    inline TaskId TaskGraph::getReadyTask(size_t position) const {
+        return m_readyTasks[position];
+    }
+
+    //! \brief  Retrieves the position of the first ready task belonging to a priority class.
+    //! \param  priority [in] -
+    //!         The priority class whose tasks are required, kTaskPriority_Count retrieves the end of the final class.
+    //! \return Position within the ready list of the first task of the priority class.
+    inline size_t TaskGraph::getReadyClassBegin(uint32_t priority) const {
+        return m_readyClassOffsets[priority];
+    }
+
+    //! \brief  Retrieves the number of tasks that are ready to begin at the start of a frame.
+    //! \return The number of tasks that are ready to begin at the start of a frame.
+    inline size_t TaskGraph::getReadyCount() const {
+        return m_readyTasks.size();
+    }
+
+    //! \brief  Retrieves the number of tasks contained within the compiled graph.
+    //! \return The number of tasks contained within the compiled graph.
+    inline size_t TaskGraph::getTaskCount() const {
+        return m_taskCount;
+    }
+
+    //! \brief  Determines whether the graph has been compiled since it was last invalidated.
+    //! \return <em>True</em> if the graph may be replayed otherwise <em>false</em>.
+    inline bool TaskGraph::isCompiled() const {
+        return m_compiled;
+    }
+} // namespace raize
+
+
+// -----------------------------------------------------------------------------------
+
+#endif //!defined( TASK_GRAPH_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL )
@@ -20,24 +20,71 @@
 
 // -----------------------------------------------------------------------------------
 
+#include <stddef.h>
 #include <stdint.h>
 #include <atomic>
 
+#include "platform.h"
+
 
 // -----------------------------------------------------------------------------------
 
 namespace raize {
     typedef void ( *TaskExecuteFunction )();
+    typedef void ( *RangeExecuteFunction )(size_t begin, size_t end);
+    typedef void ( *TaskPayloadFunction )(void *payload);
+
+    //! The maximum number of bytes that may be stored within a tasks payload.
+    static const size_t kRaizeTaskPayloadSize = RAIZE_TASK_PAYLOAD_SIZE;
+
+    //! \brief  Storage for the data supplied when a task is created, held within the task itself.
+    //!
+    //! The payload is copied byte for byte when the task is created and is never destroyed, so
+    //! it may only contain trivially copyable data.
+    struct TaskPayload {
+        alignas(max_align_t) unsigned char data[kRaizeTaskPayloadSize];
+    };
+
+    //! \brief  Priority classes a task may belong to, tasks in a higher class are handed out first.
+    enum kTaskPriority {
+        kTaskPriority_Critical,         //!< Latency critical work, such as input handling, that should finish early in the frame
+        kTaskPriority_High,
+        kTaskPriority_Normal,           //!< The priority given to tasks that do not specify one
+        kTaskPriority_Low,              //!< Work that may finish late in the frame without consequence
+
+        kTaskPriority_Count,            //!< Number of priority classes, not a valid priority
+    };
+
+    //! \brief  Identifies a task registered with the scheduler, used when declaring dependencies between tasks.
+    typedef uint32_t TaskId;
+
+    //! Value used to represent a task identifier that does not refer to any task.
+    static const TaskId kInvalidTaskId = 0xffffffff;
 
     //! \brief  Defines a single task registered with the scheduler.
     //!
-    //! This will be expanded on greatly in the future, currently it's a simple function
-    //! call. But we'll want a dependency graph and parameters supported eventually.
-    //! This will start to be fleshed out once the core framework is processing these
-    //! simple tasks.
+    //! A task may depend upon any number of previously created tasks, it will not begin
+    //! executing until all of those tasks have completed within the current frame. The
+    //! dependencies are stored as a list of successors on each predecessor, so a finishing
+    //! task can release the tasks that were waiting upon it.
+    //!
+    //! Tasks are only read whilst a frame is processed. Measurements are recorded separately by
+    //! each execution context, so a worker never writes to the cache lines other workers are
+    //! reading entry points from, see TaskProvider::getTaskDuration().
     struct TaskInfo {
-        uint64_t executionSpeed; //!< How longs did the task take to complete
         TaskExecuteFunction execute;
+        TaskPayloadFunction invoke;     //!< When not nullptr, called with the payload in place of the execute function
+        uint32_t predecessorCount;      //!< Number of tasks that must complete before this task may begin
+        uint32_t firstSuccessor;        //!< Index of the first TaskEdge listing the tasks that depend upon us
+        uint32_t rangeIndex;            //!< For tasks created by parallelFor, index of the range being processed otherwise kInvalidTaskId
+        uint32_t priority;              //!< The kTaskPriority class the task belongs to
+        TaskPayload payload;            //!< Data supplied when the task was created, passed to the invoke function
+    };
+
+    //! \brief  Links a task to one of the tasks that depend upon it.
+    struct TaskEdge {
+        TaskId successor;               //!< The task that depends upon the owner of this edge
+        uint32_t next;                  //!< Index of the next edge belonging to the same task, or kInvalidTaskId
     };
 } // namespace raize
 
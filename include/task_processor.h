@@ -20,17 +20,27 @@
 
 // -----------------------------------------------------------------------------------
 
+#include <atomic>
 #include <thread>
+#include <vector>
 
 #include "execution_context.h"
+#include "fiber_pool.h"
+#include "frame_arena.h"
+#include "platform.h"
+#include "statistics.h"
+#include "task_info.h"
+#include "trace_buffer.h"
 
 
 // -----------------------------------------------------------------------------------
 
 namespace raize {
-    struct TaskInfo;
-
     class ProcessorSync;
+    class TaskProvider;
+
+    //! Value of TaskProcessor::m_activeWork whilst the processor is not executing any work.
+    static const uint64_t kRaizeIdleWork = ~static_cast< uint64_t >(0);
 
     //! \brief Manages the processing of a single thread within the scheduler.
     class TaskProcessor {
@@ -39,30 +49,157 @@ namespace raize {
         ~TaskProcessor();
 
         void join();
+        bool initialize(const ExecutionContext &executionContext);
         bool initialize(const ExecutionContext &executionContext, ProcessorSync *syncObject);
 
+        bool initializeFibers(size_t fiberCount, size_t stackSize);
+        void shutdownFibers();
+
+        bool initializeTracing(size_t eventCapacity);
+        void shutdownTracing();
+        void setTraceFrame(uint32_t frame);
+        const TraceBuffer &getTraceBuffer() const;
+
+        bool initializeArena(size_t capacity, bool hugePages);
+        void shutdownArena();
+        FrameArena &getFrameArena();
+        const FrameArena &getFrameArena() const;
+
+        void beginStatisticsWindow(uint32_t window);
+        void resetStatistics();
+        void getContextStatistics(ContextStatistics &contextStatistics) const;
+        void mergeTaskDurations(Histogram &histogram) const;
+        bool getActiveWork(LongTaskReport &longTask) const;
+
         void postCommand(const ThreadCommand &threadCommand);
+        void processTasks(TaskProvider *taskProvider);
+        void processTasks(TaskProvider *taskProvider, bool untilComplete);
+
+        static bool spawnTask(TaskExecuteFunction executeFunc);
+        static bool spawnTask(TaskPayloadFunction invokeFunc, const void *payload, size_t payloadSize);
+        static void waitForCounter(const std::atomic<uint32_t> &counter);
+        static ExecutionContext *getCurrentContext();
 
     private:
         void executeTaskList();
 
-        bool executeTask(TaskInfo *taskInfo);
+        bool executeTask(TaskInfo *taskInfo, uint64_t startTicks, uint64_t &elapsedNano);
+        void recordTask(uint64_t elapsedNano);
+        void beginWork(TaskId taskId, kTraceEvent kind, uint64_t startTicks);
+        void endWork();
+        void executeChunk(TaskProvider *taskProvider, TaskId workId);
+        void executeWork(TaskProvider *taskProvider, TaskId workId);
+
+        void processThreadTasks(TaskProvider *taskProvider, bool untilComplete);
+        void processFiberTasks(TaskProvider *taskProvider, bool untilComplete);
+        void executeFiber(TaskProvider *taskProvider, TaskId workId);
+        void switchToFiber(TaskProvider *taskProvider, Fiber *fiber, TaskId workId);
+        void resumeFibers(TaskProvider *taskProvider);
+
+        static void fiberExecute(void *argument);
 
         void threadExecute();
 
         static void threadEntry(TaskProcessor *self);
 
     private:
+        char m_leadingPadding[RAIZE_CACHE_LINE_SIZE];  //!< Processors are allocated together, padding keeps each ones state off its neighbours cache lines
+
         ThreadCommand m_threadCommand;  //!< The current operation being performed by this execution context
         ExecutionContext m_executionContext;
         ProcessorSync *m_syncObject;
 
+        FiberPool m_fiberPool;
+        std::vector<Fiber*> m_waitingFibers;    //!< Suspended fibers, resumed once the counter they wait upon reaches zero
+        std::vector<TaskId> m_waitingWork;      //!< The work being processed by each of the suspended fibers
+        TaskProvider *m_fiberProvider;          //!< Provider of the work being started upon a fiber
+        TaskId m_fiberWork;                     //!< The work being started upon a fiber
+
+        TraceBuffer m_traceBuffer;              //!< Records the work processed by the thread, when tracing is enabled
+        uint32_t m_traceFrame;                  //!< Number of the frame being processed, stored within each trace event
+
+        FrameArena m_frameArena;                //!< Scratch memory for the processors tasks, see ExecutionContext::frameArena
+
+        // Only written by the processors own thread, but may be read by any thread
+        Histogram m_taskDurations[kRaizeStatisticsWindows];
+        uint32_t m_statisticsWindow;            //!< The histogram receiving task durations
+        std::atomic<uint64_t> m_busyNano;       //!< Time spent executing tasks
+        std::atomic<uint64_t> m_activeNano;     //!< Time spent processing frames
+        std::atomic<uint64_t> m_tasksTotal;
+
+        // Published as each piece of work begins and ends, so a watchdog may see what the thread is executing
+        std::atomic<uint64_t> m_activeWork;     //!< Kind and identifier of the work being executed, kRaizeIdleWork when idle
+        std::atomic<uint64_t> m_activeTicks;    //!< When the work being executed began, see PerformanceTimer::getTicks()
+
         std::thread m_thread;
 
+        char m_trailingPadding[RAIZE_CACHE_LINE_SIZE];
+
         TaskProcessor(const TaskProcessor &other);
 
         TaskProcessor &operator=(const TaskProcessor &other);
     };
+
+
+    //! \brief  Sets the frame number stored within the trace events recorded by the processor.
+    //! \param  frame [in] -
+    //!         Number of the frame about to be processed, this must not be called whilst the processor is processing tasks.
+    inline void TaskProcessor::setTraceFrame(uint32_t frame) {
+        m_traceFrame = frame;
+    }
+
+
+    //! \brief  Records the measurements of a completed task, only called by the processors own thread.
+    //! \param  elapsedNano [in] -
+    //!         Time (in nanoseconds) taken to execute the task.
+    inline void TaskProcessor::recordTask(uint64_t elapsedNano) {
+        m_taskDurations[m_statisticsWindow].record(elapsedNano);
+
+        m_busyNano.store(m_busyNano.load(std::memory_order_relaxed) + elapsedNano, std::memory_order_relaxed);
+        m_tasksTotal.store(m_tasksTotal.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+
+    //! \brief  Publishes the work the processor has begun executing, only called by the processors own thread.
+    //! \param  taskId [in] -
+    //!         The registered task responsible for the work.
+    //! \param  kind [in] -
+    //!         Describes the work being executed.
+    //! \param  startTicks [in] -
+    //!         When the work began, see PerformanceTimer::getTicks().
+    //!
+    //! The start is stored first, so a reader that sees the work also sees a start no older than its own.
+    inline void TaskProcessor::beginWork(TaskId taskId, kTraceEvent kind, uint64_t startTicks) {
+        m_activeTicks.store(startTicks, std::memory_order_relaxed);
+        m_activeWork.store((static_cast< uint64_t >(kind) << 32) | taskId, std::memory_order_release);
+    }
+
+
+    //! \brief  Publishes that the processor is no longer executing any work, only called by the processors own thread.
+    inline void TaskProcessor::endWork() {
+        m_activeWork.store(kRaizeIdleWork, std::memory_order_relaxed);
+    }
+
+
+    //! \brief  Retrieves the arena the processors tasks allocate scratch memory from.
+    //! \return The processors arena, which is only initialized when arenas have been enabled.
+    inline FrameArena &TaskProcessor::getFrameArena() {
+        return m_frameArena;
+    }
+
+
+    //! \brief  Retrieves the arena the processors tasks allocate scratch memory from.
+    //! \return The processors arena, which is only initialized when arenas have been enabled.
+    inline const FrameArena &TaskProcessor::getFrameArena() const {
+        return m_frameArena;
+    }
+
+
+    //! \brief  Retrieves the buffer holding the work recorded by the processor.
+    //! \return The processors trace buffer, which is only initialized when tracing has been enabled.
+    inline const TraceBuffer &TaskProcessor::getTraceBuffer() const {
+        return m_traceBuffer;
+    }
 } // namespace raize
 
 
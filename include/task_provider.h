@@ -20,25 +20,116 @@
 
 // -----------------------------------------------------------------------------------
 
+#include <cassert>
 #include <cstdio>
 #include <vector>
 #include <atomic>
+#include <memory>
 
+#include "performance_timer.h"
+#include "resource_access.h"
+#include "task_graph.h"
 #include "task_info.h"
+#include "task_queue.h"
 
 
 // -----------------------------------------------------------------------------------
 
 namespace raize {
+    //! \brief  Describes how execution contexts claim tasks from the TaskProvider.
+    enum kTaskClaimMode {
+        kTaskClaimMode_WorkStealing,    //!< Tasks are divided between per-context queues, idle contexts steal from each other
+        kTaskClaimMode_Batched,         //!< Contexts reserve shrinking blocks of contiguous tasks from a shared atomic index
+    };
+
+    //! \brief  A contiguous block of the frames ready list claimed by an execution context, [first, last).
+    struct TaskRange {
+        size_t first;       //!< Position of the first claimed entry within the ready list
+        size_t last;        //!< Position one past the final claimed entry within the ready list
+    };
+
+    //! \brief  A portion of a parallelFor range, [begin, end), being processed by an execution context.
+    struct TaskChunk {
+        TaskId task;        //!< The range task the chunk belongs to
+        size_t begin;       //!< First index within the chunk
+        size_t end;         //!< Index one past the final entry within the chunk
+    };
+
+    //! \brief  Measurements of when the tasks within a priority class completed, relative to the start of their frame.
+    struct PriorityStatistics {
+        uint64_t taskCount;                 //!< Number of tasks completed
+        uint64_t totalCompletionNano;       //!< Sum of the time each task completed, measured from the start of its frame
+        uint64_t maximumCompletionNano;     //!< The latest any task completed, measured from the start of its frame
+    };
+
     //! \brief Provides an API for obtaining a tasks to be processed by a thread.
     //!
     //! The task provider has a maximum number of tasks it can contain and nomore. This should
     //! be set to some definite maximum, the reason for this is to avoid fragmenting the heap
     //! at run-time.
     //!
+    //! Tasks are handed out through a set of work-stealing queues, one for each execution
+    //! context that processes tasks. When processing begins the task list is divided between
+    //! the queues, each context then works through its own queue and steals from a randomly
+    //! chosen context once it has run out of work. This avoids all contexts contending on a
+    //! single shared index.
+    //!
+    //! Alternatively, the provider may be switched to a batched claiming mode. Each call to
+    //! claimTasks() then reserves a block of tasks with a single atomic increment, the size
+    //! of the block shrinks as the list drains (similar to OpenMP's guided schedule) so that
+    //! the final tasks are still spread across all contexts.
+    //!
+    //! Tasks may depend upon previously added tasks. Each task keeps an atomic count of its
+    //! unfinished predecessors for the current frame, only tasks with no predecessors are
+    //! made available when processing begins. When a task completes, any successor whose
+    //! count reaches zero is pushed straight onto the completing contexts queue. This allows
+    //! an entire dependency graph to be processed within a single frame.
+    //!
+    //! The dependencies are compiled into a TaskGraph the first time the tasks are processed
+    //! after the task list changes (or when compile() is called). Subsequent frames replay the
+    //! compiled graph, so beginning a frame does not depend upon the number of dependencies.
+    //!
+    //! Range tasks (see addRangeTask()) cover a span of indices that is split recursively
+    //! whilst being processed. The context that acquires the range keeps halving it, pushing
+    //! the upper half onto its own queue where other contexts may steal it, until the chunk it
+    //! holds is no larger than the grain size. The range task only completes (releasing its
+    //! successors) once every chunk has been processed. Chunks are allocated from a fixed pool
+    //! per context, should the pool run out the remaining range is simply processed unsplit.
+    //!
+    //! Instead of (or as well as) naming the tasks it depends upon, a task may declare the
+    //! resources it reads and writes. The provider turns these declarations into dependencies
+    //! on earlier tasks, in the order the tasks were added: a writer waits for the previous
+    //! writer and every reader since, whilst a reader only waits for the previous writer.
+    //! Readers of the same resource are therefore free to run concurrently.
+    //!
+    //! Every task belongs to a priority class. Each context owns one queue per class and always
+    //! serves its highest non-empty class first, stealing likewise. The ready list is grouped by
+    //! class so batched claiming also hands out the most important tasks first. To stop lower
+    //! classes starving, every kRaizePriorityAgingInterval-th task a context pops is taken from
+    //! its lowest non-empty class instead.
+    //!
+    //! A running task may spawn further tasks (see spawnTask()). Spawned tasks are allocated
+    //! from a fixed pool per context and pushed onto the spawning contexts queue, inheriting the
+    //! priority of their parent. Every task keeps a join count of its unfinished children, a
+    //! task is only completed (releasing its successors, or its own parent) once it and every
+    //! child it spawned have finished. Work spawned from a frame therefore always completes
+    //! within that frame.
+    //!
+    //! Independent tasks may also be submitted by any number of threads at once (see
+    //! submitTask()). Each submitter reserves a slot within the task table with an atomic
+    //! increment, fills it in and publishes it with release ordering. The thread that builds
+    //! and processes frames collects the published slots into the task list, in slot order,
+    //! when it next begins processing. No lock is taken by either side.
+    //!
     class TaskProvider {
-        typedef std::vector<TaskInfo> TaskList;
-        typedef TaskList::iterator TaskIterator;
+        //! Set within work identifiers that refer to a chunk of a range task rather than a task.
+        static const uint32_t kChunkFlag = 0x80000000;
+
+        //! Set within work identifiers that refer to a task spawned whilst processing the frame.
+        static const uint32_t kSpawnFlag = 0x40000000;
+
+        //! Set within a join count once the work itself has finished, the remaining bits count unfinished children.
+        static const uint32_t kJoinFinished = 0x80000000;
 
     public:
         TaskProvider();
@@ -47,20 +138,214 @@ namespace raize {
         void shutdown();
 
         bool initialize(size_t taskCapacity);
+        bool initialize(size_t taskCapacity, size_t queueCount);
+        bool initialize(size_t taskCapacity, size_t queueCount, size_t dependencyCapacity);
 
         bool addTask(TaskExecuteFunction executeFunc);
+        bool addTask(TaskExecuteFunction executeFunc, kTaskPriority priority, TaskId *taskId);
+        bool addTask(TaskExecuteFunction executeFunc, const TaskId *dependencies, size_t dependencyCount, TaskId *taskId);
+        bool addTask(TaskExecuteFunction executeFunc, const TaskId *dependencies, size_t dependencyCount, const ResourceAccess *accesses, size_t accessCount, TaskId *taskId);
+        bool addTask(TaskPayloadFunction invokeFunc, const void *payload, size_t payloadSize, kTaskPriority priority, TaskId *taskId);
+        bool addTask(TaskPayloadFunction invokeFunc, const void *payload, size_t payloadSize, const TaskId *dependencies, size_t dependencyCount, const ResourceAccess *accesses, size_t accessCount, TaskId *taskId);
+        bool addRangeTask(RangeExecuteFunction executeFunc, size_t begin, size_t end, size_t grainSize, const TaskId *dependencies, size_t dependencyCount, TaskId *taskId);
+
+        bool submitTask(TaskExecuteFunction executeFunc);
+        bool submitTask(TaskExecuteFunction executeFunc, kTaskPriority priority, TaskId *taskId);
+        bool submitTask(TaskPayloadFunction invokeFunc, const void *payload, size_t payloadSize, kTaskPriority priority, TaskId *taskId);
+        size_t collectSubmissions();
+
+        bool spawnTask(unsigned int contextId, TaskId parentId, TaskExecuteFunction executeFunc);
+        bool spawnTask(unsigned int contextId, TaskId parentId, TaskPayloadFunction invokeFunc, const void *payload, size_t payloadSize);
+
+        bool setTaskPriority(TaskId taskId, kTaskPriority priority);
+        void clearTasks();
+
+        void setClaimMode(kTaskClaimMode claimMode);
+        void setClaimMode(kTaskClaimMode claimMode, size_t minimumBatchSize);
+
+        bool compile();
 
         void onEndProcessing();
         size_t onBeginProcessing();
 
         TaskInfo *nextTask();
+        TaskInfo *nextTask(unsigned int contextId);
+
+        TaskId acquireTask(unsigned int contextId, TaskRange &range);
+        TaskId pollTask(unsigned int contextId, TaskRange &range);
+        bool hasRemainingTasks() const;
+        void completeTask(unsigned int contextId, TaskId taskId);
+
+        bool claimTasks(unsigned int contextId, TaskRange &range);
+
+        bool isRangeWork(TaskId workId) const;
+        bool isSpawnedWork(TaskId workId) const;
+        TaskInfo *getSpawnedTask(TaskId workId);
+        TaskId getRegisteredTask(TaskId workId) const;
+
+        TaskChunk acquireChunk(unsigned int contextId, TaskId workId);
+        bool splitChunk(unsigned int contextId, TaskChunk &chunk);
+        void completeChunk(unsigned int contextId, const TaskChunk &chunk, uint64_t elapsedNano);
+        RangeExecuteFunction getRangeFunction(TaskId taskId) const;
+
+        TaskInfo *getTask(size_t taskIndex);
+        TaskId getReadyTask(size_t position) const;
+
+        void recordDuration(unsigned int contextId, TaskId taskId, uint64_t elapsedNano);
+        uint64_t getTaskDuration(TaskId taskId) const;
 
         size_t getMaximumTasks() const;
+        size_t getTaskCount() const;
+        size_t getMaximumDependencies() const;
+        size_t getMaximumResourceAccesses() const;
+        size_t getRangeGrainSize(TaskId taskId) const;
+        size_t getQueueCount() const;
+        bool setContextCount(size_t contextCount);
+        size_t getContextCount() const;
+        kTaskClaimMode getClaimMode() const;
+
+        void getPriorityStatistics(kTaskPriority priority, PriorityStatistics &priorityStatistics) const;
+        void resetPriorityStatistics();
+
+    private:
+        bool insertTask(TaskInfo &taskInfo, const TaskId *dependencies, size_t dependencyCount, const ResourceAccess *accesses, size_t accessCount, TaskId *taskId);
+        bool addDependency(TaskId dependency);
+        bool addResourceDependencies(const ResourceAccess &resourceAccess, TaskId taskCount);
+
+        bool reserveTask(TaskId &taskId);
+        bool publishTask(const TaskInfo &taskInfo, TaskId *taskId);
+        void commitTask(TaskId taskId);
+
+        bool claimBatch(size_t maximumBatchSize, TaskRange &range);
+
+        TaskId findTask(unsigned int contextId, TaskRange &range);
+        TaskId waitTask(unsigned int contextId, TaskRange &range);
+
+        bool insertSpawn(unsigned int contextId, TaskId parentId, const TaskInfo &taskInfo);
+        void finishWork(unsigned int contextId, TaskId workId);
+        void resetContextPriorities(unsigned int contextId);
+        uint32_t getWorkPriority(TaskId workId) const;
+        std::atomic<uint32_t> &getJoinCount(TaskId workId);
+
+        bool pushTask(unsigned int contextId, uint32_t workId, uint32_t priority);
+        uint32_t popTask(unsigned int contextId);
+        uint32_t popOwnTask(unsigned int contextId);
+        uint32_t stealTask(unsigned int contextId);
+
+        TaskQueue &getQueue(unsigned int contextId, uint32_t priority);
 
     private:
-        std::atomic<unsigned int> m_taskAcquire;
-        size_t m_nextTask;
-        TaskList m_tasks;
+        //! \brief  Locates the resources declared by a task within the access list.
+        struct AccessRange {
+            uint32_t first;         //!< Index of the tasks first entry within the access list
+            uint32_t count;         //!< Number of resources declared by the task
+        };
+
+        //! \brief  Static description of a range task.
+        struct RangeInfo {
+            RangeExecuteFunction execute;
+            size_t begin;
+            size_t end;
+            size_t minimumGrainSize;        //!< Grain size requested by the application
+            size_t grainSize;               //!< Grain size adapted from the previous frames timing
+        };
+
+        //! \brief  Per-frame state of a range task, updated by every context processing one of its chunks.
+        struct RangeState {
+            std::atomic<uint32_t> pendingChunks;
+            std::atomic<uint64_t> elapsedNano;
+            char padding[RAIZE_CACHE_LINE_SIZE - sizeof(std::atomic<uint32_t>) - sizeof(std::atomic<uint64_t>)];
+        };
+
+        //! \brief  State only accessed by the owning execution context.
+        struct ContextState {
+            uint32_t chunkCount;            //!< Number of chunks allocated from the contexts pool this frame
+            uint32_t popCount;              //!< Number of tasks popped from the contexts own queues, used for aging
+            uint32_t spawnCount;            //!< Number of tasks spawned from the contexts pool this frame
+            uint32_t timingCount;           //!< Number of durations recorded within the contexts timing block this frame
+            char padding[RAIZE_CACHE_LINE_SIZE - sizeof(uint32_t) * 4];
+        };
+
+        //! \brief  Duration of a task executed by a context, held until the frame ends.
+        struct TaskTiming {
+            uint64_t elapsedNano;
+            TaskId taskId;
+        };
+
+        //! \brief  A task spawned by a running task.
+        struct SpawnedTask {
+            TaskInfo taskInfo;
+            TaskId parent;                          //!< The work that spawned the task, which cannot complete before it
+            TaskId root;                            //!< The registered task whose work ultimately spawned the task
+            std::atomic<uint32_t> joinCount;        //!< See kJoinFinished
+        };
+
+        //! \brief  Completion times of the tasks within a priority class, merged from every context as each frame ends.
+        struct PriorityState {
+            std::atomic<uint64_t> taskCount;
+            std::atomic<uint64_t> totalCompletion;
+            std::atomic<uint64_t> maximumCompletion;
+        };
+
+        //! \brief  Completion times of the tasks within a priority class, recorded by a single context this frame.
+        struct PriorityTiming {
+            uint64_t taskCount;
+            uint64_t totalCompletion;
+            uint64_t maximumCompletion;
+        };
+
+        //! \brief  Completion times recorded by a single context, held until the frame ends.
+        struct ContextPriorities {
+            PriorityTiming classes[kTaskPriority_Count];
+            char padding[RAIZE_CACHE_LINE_SIZE - (sizeof(PriorityTiming) * kTaskPriority_Count) % RAIZE_CACHE_LINE_SIZE];
+        };
+
+        typedef std::vector<TaskEdge> EdgeList;
+        typedef std::vector<TaskId> ReadyList;
+        typedef std::vector<ResourceAccess> AccessList;
+        typedef std::vector<AccessRange> AccessRangeList;
+        typedef std::vector<RangeInfo> RangeList;
+
+        // Shared between all contexts whilst processing in batched mode
+        std::atomic<size_t> m_nextTask;
+        char m_nextTaskPadding[RAIZE_CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+
+        // Number of tasks that have not yet completed within the current frame
+        std::atomic<size_t> m_remainingTasks;
+        char m_remainingTasksPadding[RAIZE_CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+
+        // Number of slots within the task table handed out, shared between every submitting thread
+        std::atomic<uint32_t> m_reservedTasks;
+        char m_reservedTasksPadding[RAIZE_CACHE_LINE_SIZE - sizeof(std::atomic<uint32_t>)];
+
+        kTaskClaimMode m_claimMode;
+        size_t m_minimumBatchSize;
+        size_t m_queueCount;
+        size_t m_contextCount;                          // Number of contexts processing tasks, which may be fewer than the number of queues
+        std::unique_ptr<TaskQueue[]> m_queues;          // Each context owns one queue per priority class
+        std::unique_ptr<ContextState[]> m_contextStates;
+        std::unique_ptr<TaskChunk[]> m_chunks;          // Each context owns a contiguous block of chunks
+        std::unique_ptr<RangeState[]> m_rangeStates;
+        std::unique_ptr<SpawnedTask[]> m_spawns;        // Each context owns a contiguous block of spawned tasks
+        std::unique_ptr<std::atomic<uint32_t>[]> m_joinCounts;      // Join count of each registered task, zero between frames
+        std::unique_ptr<TaskTiming[]> m_timingStorage;
+        TaskTiming *m_timings;                          // Each context owns a cache line aligned block within m_timingStorage
+        size_t m_timingStride;                          // Number of timings within each contexts block
+        std::unique_ptr<uint64_t[]> m_taskDurations;    // Duration of each registered task, only written as a frame ends
+        std::unique_ptr<ContextPriorities[]> m_contextPriorities;  // Each context records the completion times of its own tasks
+        RangeList m_ranges;
+        TaskGraph m_graph;
+        std::unique_ptr<TaskInfo[]> m_tasks;
+        std::unique_ptr<std::atomic<bool>[]> m_publishedTasks;     // Set once a submitted slot has been filled in, cleared as it is collected
+        size_t m_taskCapacity;
+        size_t m_taskCount;                 // Number of tasks within the task list, only changed by the building thread
+        bool m_processing;                  // Set from onBeginProcessing() until onEndProcessing(), whilst the task list must not change
+        EdgeList m_edges;
+        ReadyList m_newDependencies;        // Scratch storage used whilst adding a task
+        AccessList m_accesses;
+        AccessRangeList m_accessRanges;     // Only read when adding tasks, kept apart from the task list
+        PriorityState m_priorityStates[kTaskPriority_Count];
+        PerformanceTimer m_frameTimer;      // Started when processing begins, measures when each task completes
 
         TaskProvider(const TaskProvider &other);
 
@@ -70,7 +355,172 @@ namespace raize {
     //! \brief  Retrieves the maximum number of tasks that may be queued within the task provider.
     //! \return The maximum number of tasks that may be queued within the task provider.
     inline size_t TaskProvider::getMaximumTasks() const {
-        return m_tasks.capacity();
+        return m_taskCapacity;
+    }
+
+    //! \brief  Retrieves the number of tasks within the task list, this does not include submissions that have not been collected.
+    //! \return The number of tasks within the task list.
+    inline size_t TaskProvider::getTaskCount() const {
+        return m_taskCount;
+    }
+
+    //! \brief  Retrieves one of the queues owned by an execution context.
+    //! \param  contextId [in] -
+    //!         Identifier of the execution context that owns the queue.
+    //! \param  priority [in] -
+    //!         The priority class held by the queue.
+    //! \return The queue holding the contexts work of the specified priority.
+    inline TaskQueue &TaskProvider::getQueue(unsigned int contextId, uint32_t priority) {
+        return m_queues[contextId * kTaskPriority_Count + priority];
+    }
+
+    //! \brief  Retrieves the task stored at the specified index, typically one contained within a claimed TaskRange.
+    //! \param  taskIndex [in] -
+    //!         Index of the task to be retrieved.
+    //! \return Pointer to the task at the specified index.
+    inline TaskInfo *TaskProvider::getTask(size_t taskIndex) {
+        return &m_tasks[taskIndex];
+    }
+
+    //! \brief  Records how long a registered task took to execute, within the calling contexts own timing block.
+    //! \param  contextId [in] -
+    //!         Identifier of the execution context that executed the task.
+    //! \param  taskId [in] -
+    //!         Identifier of the registered task.
+    //! \param  elapsedNano [in] -
+    //!         Time (in nanoseconds) taken to execute the task.
+    //!
+    //! The durations are merged into the task table by onEndProcessing(), so contexts never
+    //! write to memory shared with other contexts whilst the frame is processed.
+    inline void TaskProvider::recordDuration(unsigned int contextId, TaskId taskId, uint64_t elapsedNano) {
+        assert(contextId < m_queueCount);
+
+        ContextState &contextState = m_contextStates[contextId];
+        if (contextState.timingCount < m_timingStride) {
+            TaskTiming &taskTiming = m_timings[contextId * m_timingStride + contextState.timingCount++];
+
+            taskTiming.elapsedNano = elapsedNano;
+            taskTiming.taskId = taskId;
+        }
+    }
+
+    //! \brief  Retrieves a task from the frames ready list, typically one contained within a claimed TaskRange.
+    //! \param  position [in] -
+    //!         Position within the ready list of the task to be retrieved.
+    //! \return Identifier of the task at the specified position.
+    inline TaskId TaskProvider::getReadyTask(size_t position) const {
+        return m_graph.getReadyTask(position);
+    }
+
+    //! \brief  Retrieves the next task to be processed by an execution context, waiting for dependencies if necessary.
+    //! \param  contextId [in] -
+    //!         Identifier of the execution context requesting a task.
+    //! \param  range [in/out] -
+    //!         Block of tasks previously claimed by the context, this should be empty when the frame begins.
+    //! \return Identifier of the task to be processed, or kInvalidTaskId once every task in the frame has completed.
+    inline TaskId TaskProvider::acquireTask(unsigned int contextId, TaskRange &range) {
+        // A previously claimed block is walked without touching any shared state
+        if (range.first < range.last) {
+            return m_graph.getReadyTask(range.first++);
+        }
+
+        return waitTask(contextId, range);
+    }
+
+    //! \brief  Retrieves the next task to be processed by an execution context, without waiting.
+    //! \param  contextId [in] -
+    //!         Identifier of the execution context requesting a task.
+    //! \param  range [in/out] -
+    //!         Block of tasks previously claimed by the context, this should be empty when the frame begins.
+    //! \return Identifier of the task to be processed, or kInvalidTaskId if no task is currently available.
+    //!
+    //! Unlike acquireTask(), this method returns immediately when no task is available, see hasRemainingTasks().
+    inline TaskId TaskProvider::pollTask(unsigned int contextId, TaskRange &range) {
+        if (range.first < range.last) {
+            return m_graph.getReadyTask(range.first++);
+        }
+
+        return (0 != m_queueCount) ? findTask(contextId, range) : kInvalidTaskId;
+    }
+
+    //! \brief  Determines whether any task within the current frame has yet to complete.
+    //! \return <em>True</em> if the frame is still being processed otherwise <em>false</em>.
+    inline bool TaskProvider::hasRemainingTasks() const {
+        return 0 != m_remainingTasks.load(std::memory_order_acquire);
+    }
+
+    //! \brief  Retrieves the maximum number of dependencies that may be declared between tasks.
+    //! \return The maximum number of dependencies that may be declared between tasks.
+    inline size_t TaskProvider::getMaximumDependencies() const {
+        return m_edges.capacity();
+    }
+
+    //! \brief  Determines whether a work identifier returned by acquireTask() refers to part of a range task.
+    //! \param  workId [in] -
+    //!         The identifier returned by acquireTask().
+    //! \return <em>True</em> if the work should be processed as a TaskChunk otherwise <em>false</em>.
+    inline bool TaskProvider::isRangeWork(TaskId workId) const {
+        if (0 != (workId & kSpawnFlag)) {
+            return false;
+        }
+
+        return (0 != (workId & kChunkFlag)) || (kInvalidTaskId != m_tasks[workId].rangeIndex);
+    }
+
+    //! \brief  Determines whether a work identifier returned by acquireTask() refers to a spawned task.
+    //! \param  workId [in] -
+    //!         The identifier returned by acquireTask().
+    //! \return <em>True</em> if the work should be retrieved with getSpawnedTask() otherwise <em>false</em>.
+    inline bool TaskProvider::isSpawnedWork(TaskId workId) const {
+        return (0 == (workId & kChunkFlag)) && (0 != (workId & kSpawnFlag));
+    }
+
+    //! \brief  Retrieves a task spawned during the current frame.
+    //! \param  workId [in] -
+    //!         Identifier returned by acquireTask(), for which isSpawnedWork() returned <em>true</em>.
+    //! \return Pointer to the spawned task.
+    inline TaskInfo *TaskProvider::getSpawnedTask(TaskId workId) {
+        return &m_spawns[workId & ~kSpawnFlag].taskInfo;
+    }
+
+    //! \brief  Retrieves the registered task responsible for a piece of work, for reporting purposes.
+    //! \param  workId [in] -
+    //!         Identifier returned by acquireTask(), which must not refer to a chunk.
+    //! \return The task itself, or for spawned tasks the registered task that ultimately spawned it.
+    inline TaskId TaskProvider::getRegisteredTask(TaskId workId) const {
+        return isSpawnedWork(workId) ? m_spawns[workId & ~kSpawnFlag].root : workId;
+    }
+
+    //! \brief  Retrieves the function that processes a range task.
+    //! \param  taskId [in] -
+    //!         The range task, typically the task member of a TaskChunk.
+    //! \return The function that processes the range task.
+    inline RangeExecuteFunction TaskProvider::getRangeFunction(TaskId taskId) const {
+        return m_ranges[m_tasks[taskId].rangeIndex].execute;
+    }
+
+    //! \brief  Retrieves the maximum number of resource accesses that may be declared by all tasks.
+    //! \return The maximum number of resource accesses that may be declared by all tasks.
+    inline size_t TaskProvider::getMaximumResourceAccesses() const {
+        return m_accesses.capacity();
+    }
+
+    //! \brief  Retrieves the method used by execution contexts to claim tasks from the provider.
+    //! \return The method used by execution contexts to claim tasks from the provider.
+    inline kTaskClaimMode TaskProvider::getClaimMode() const {
+        return m_claimMode;
+    }
+
+    //! \brief  Retrieves the number of work-stealing queues tasks are distributed between.
+    //! \return The number of work-stealing queues tasks are distributed between.
+    inline size_t TaskProvider::getQueueCount() const {
+        return m_queueCount;
+    }
+
+    //! \brief  Retrieves the number of execution contexts tasks are distributed between.
+    //! \return The number of execution contexts tasks are distributed between, see setContextCount().
+    inline size_t TaskProvider::getContextCount() const {
+        return m_contextCount;
     }
 } // namespace raize
 
@@ -0,0 +1,89 @@
+//
+// Copyright 2017 nfactorial
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#if !defined( TASK_QUEUE_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL )
+#define TASK_QUEUE_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL
+
+
+// -----------------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+
+#include "platform.h"
+
+
+// -----------------------------------------------------------------------------------
+
+namespace raize {
+    //! \brief  Fixed capacity work-stealing deque, based on the Chase-Lev algorithm.
+    //!
+    //! Each execution context owns a single queue. The owner pushes and pops task indices
+    //! at the bottom of the queue, whilst other contexts that have run out of work steal
+    //! from the top. Only the owner may call push() and pop(), any thread may call steal().
+    //!
+    //! The queue does not grow, its storage is allocated once when initialize() is called.
+    //!
+    class TaskQueue {
+    public:
+        static const uint32_t kEmpty = 0xffffffff;      //!< Returned when the queue contained no entries
+        static const uint32_t kAbort = 0xfffffffe;      //!< Returned by steal() when it lost a race with another thread
+
+        TaskQueue();
+        ~TaskQueue();
+
+        bool initialize(size_t capacity, uint32_t seed);
+
+        void reset();
+
+        bool push(uint32_t taskIndex);
+        uint32_t pop();
+        uint32_t steal();
+
+        uint32_t nextRandom();
+
+        size_t getCapacity() const;
+
+    private:
+        // Written by thieves
+        std::atomic<int64_t> m_top;
+        char m_topPadding[RAIZE_CACHE_LINE_SIZE - sizeof(std::atomic<int64_t>)];
+
+        // Written by the owner only
+        std::atomic<int64_t> m_bottom;
+        uint32_t m_randomState;
+        char m_bottomPadding[RAIZE_CACHE_LINE_SIZE - sizeof(std::atomic<int64_t>) - sizeof(uint32_t)];
+
+        // Read-only whilst processing
+        int64_t m_mask;
+        std::unique_ptr<std::atomic<uint32_t>[]> m_buffer;
+
+        TaskQueue(const TaskQueue &other);
+
+        TaskQueue &operator=(const TaskQueue &other);
+    };
+} // namespace raize
+
+
+// -----------------------------------------------------------------------------------
+
+#include "task_queue.inl"
+
+
+// -----------------------------------------------------------------------------------
+
+#endif //!defined( TASK_QUEUE_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL )
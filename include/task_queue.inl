@@ -0,0 +1,114 @@
+//
+// Copyright 2017 nfactorial
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#if !defined( TASK_QUEUE_INL_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL )
+#define TASK_QUEUE_INL_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL
+
+
+// -----------------------------------------------------------------------------------
+
+namespace raize {
+    //! \brief  Adds a task to the bottom of the queue, this may only be called by the owning context.
+    //! \param  taskIndex [in] -
+    //!         Index of the task to be added to the queue.
+    //! \return <em>True</em> if the task was added otherwise <em>false</em> if the queue was full.
+    inline bool TaskQueue::push(uint32_t taskIndex) {
+        const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+        const int64_t top = m_top.load(std::memory_order_acquire);
+
+        if (bottom - top > m_mask) {
+            return false;
+        }
+
+        m_buffer[bottom & m_mask].store(taskIndex, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+
+        return true;
+    }
+
+
+    //! \brief  Removes the most recently pushed task from the queue, this may only be called by the owning context.
+    //! \return Index of the task that was removed, or kEmpty if the queue contained no tasks.
+    inline uint32_t TaskQueue::pop() {
+        const int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+        m_bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = m_top.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return kEmpty;
+        }
+
+        uint32_t taskIndex = m_buffer[bottom & m_mask].load(std::memory_order_relaxed);
+        if (top == bottom) {
+            // Last entry in the queue, we must race any thieves for it
+            if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                taskIndex = kEmpty;
+            }
+
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+
+        return taskIndex;
+    }
+
+
+    //! \brief  Removes the oldest task from the queue, this may be called from any thread.
+    //! \return Index of the task that was removed, kEmpty if the queue contained no tasks or kAbort if another thread won the race for the task.
+    inline uint32_t TaskQueue::steal() {
+        int64_t top = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t bottom = m_bottom.load(std::memory_order_acquire);
+
+        if (top >= bottom) {
+            return kEmpty;
+        }
+
+        const uint32_t taskIndex = m_buffer[top & m_mask].load(std::memory_order_relaxed);
+        if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return kAbort;
+        }
+
+        return taskIndex;
+    }
+
+
+    //! \brief  Generates a pseudo-random value used by the owning context to select a victim when stealing.
+    //! \return The next value in the queue owners random sequence.
+    inline uint32_t TaskQueue::nextRandom() {
+        // xorshift32, good enough for spreading thieves across the available queues
+        uint32_t state = m_randomState;
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        m_randomState = state;
+        return state;
+    }
+
+
+    //! \brief  Retrieves the maximum number of tasks the queue may contain.
+    //! \return The maximum number of tasks the queue may contain.
+    inline size_t TaskQueue::getCapacity() const {
+        return m_buffer ? static_cast< size_t >(m_mask + 1) : 0;
+    }
+} // namespace raize
+
+
+// -----------------------------------------------------------------------------------
+
+#endif //!defined( TASK_QUEUE_INL_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL )
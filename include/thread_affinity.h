@@ -0,0 +1,67 @@
+//
+// Copyright 2017 nfactorial
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#if !defined( THREAD_AFFINITY_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL )
+#define THREAD_AFFINITY_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL
+
+
+// -----------------------------------------------------------------------------------
+
+#include <stddef.h>
+#include <bitset>
+
+#include "platform.h"
+
+
+// -----------------------------------------------------------------------------------
+
+namespace raize {
+    //! \brief  Set of logical processors a thread may run upon, indexed by the operating system processor number.
+    typedef std::bitset<RAIZE_MAXIMUM_CORES> CoreSet;
+
+    //! Value used to represent a thread that has no preferred NUMA node.
+    static const int kRaizeAnyNumaNode = -1;
+
+    //! \brief  The operating system scheduling class a thread is placed in.
+    enum kSchedulingClass {
+        kSchedulingClass_Default,       //!< Normal time shared scheduling, the priority is used as the nice value
+        kSchedulingClass_Batch,         //!< Time shared scheduling for throughput rather than latency, the priority is used as the nice value
+        kSchedulingClass_Idle,          //!< Only runs when the processor would otherwise be idle
+        kSchedulingClass_RealTime,      //!< First in first out real time scheduling, the priority is the real time priority
+    };
+
+    //! \brief  Describes where and how the operating system should run a thread.
+    //!
+    //! Placement is a request, platforms that do not support a setting ignore it and applying
+    //! the placement reports the failure. An empty core set allows the thread to run anywhere.
+    struct ThreadPlacement {
+        CoreSet cores;                      //!< Processors the thread may run upon, empty if the thread may run on any processor
+        int numaNode;                       //!< NUMA node the thread should run upon and allocate from, or kRaizeAnyNumaNode
+        kSchedulingClass schedulingClass;   //!< The scheduling class the thread is placed in
+        int priority;                       //!< Nice value or real time priority, depending upon the scheduling class
+    };
+
+    void resetThreadPlacement(ThreadPlacement &placement);
+    bool isDefaultThreadPlacement(const ThreadPlacement &placement);
+
+    bool applyThreadPlacement(const ThreadPlacement &placement);
+
+    size_t getPhysicalCorePlacements(ThreadPlacement *placements, size_t placementCount);
+} // namespace raize
+
+
+// -----------------------------------------------------------------------------------
+
+#endif //!defined( THREAD_AFFINITY_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL )
@@ -0,0 +1,137 @@
+//
+// Copyright 2017 nfactorial
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#if !defined( TRACE_BUFFER_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL )
+#define TRACE_BUFFER_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL
+
+
+// -----------------------------------------------------------------------------------
+
+#include <stddef.h>
+#include <stdint.h>
+#include <cstdio>
+#include <atomic>
+#include <memory>
+
+
+// -----------------------------------------------------------------------------------
+
+namespace raize {
+    //! \brief  Describes the work covered by a TraceEvent.
+    enum kTraceEvent {
+        kTraceEvent_Task,               //!< A task registered with the scheduler
+        kTraceEvent_Spawned,            //!< A task spawned by a running task
+        kTraceEvent_Chunk,              //!< A chunk of a range task created by parallelFor
+        kTraceEvent_Frame,              //!< An entire frame, from submission until every task completed
+    };
+
+    //! \brief  A single span of time recorded by a TraceBuffer.
+    struct TraceEvent {
+        uint64_t beginNano;             //!< When the work began, see PerformanceTimer::getTimeNano()
+        uint64_t endNano;               //!< When the work finished, see PerformanceTimer::getTimeNano()
+        uint32_t workId;                //!< Identifier of the task, or the range task a chunk belongs to
+        uint32_t contextId;             //!< The execution context that processed the work
+        uint32_t frame;                 //!< Number of the frame the work belonged to
+        uint32_t kind;                  //!< The kTraceEvent describing the work
+    };
+
+    //! \brief  Fixed size ring of trace events, written by a single thread.
+    //!
+    //! Every event is stored when the buffer is initialized, recording never allocates memory
+    //! or takes a lock. Once the buffer is full each new event overwrites the oldest. Events
+    //! are written only by the owning thread and must only be read whilst that thread is not
+    //! recording, for example between frames.
+    class TraceBuffer {
+    public:
+        TraceBuffer();
+        ~TraceBuffer();
+
+        bool initialize(size_t eventCapacity);
+        void shutdown();
+
+        void record(const TraceEvent &traceEvent);
+        void clear();
+
+        const TraceEvent &getEvent(size_t index) const;
+
+        bool isInitialized() const;
+        size_t getCapacity() const;
+        size_t getEventCount() const;
+
+    private:
+        std::unique_ptr<TraceEvent[]> m_events;
+        size_t m_capacityMask;                      // Capacity is a power of two, so positions wrap with a mask
+        std::atomic<uint64_t> m_recorded;           // Total number of events recorded since the buffer was cleared
+
+        TraceBuffer(const TraceBuffer &other);
+
+        TraceBuffer &operator=(const TraceBuffer &other);
+    };
+
+    bool writeChromeTrace(FILE *file, const TraceBuffer *const *buffers, size_t bufferCount, uint32_t firstFrame);
+
+
+    //! \brief  Stores an event, overwriting the oldest event once the buffer is full.
+    //! \param  traceEvent [in] -
+    //!         The event to be stored.
+    inline void TraceBuffer::record(const TraceEvent &traceEvent) {
+        const uint64_t recorded = m_recorded.load(std::memory_order_relaxed);
+
+        m_events[recorded & m_capacityMask] = traceEvent;
+        m_recorded.store(recorded + 1, std::memory_order_release);
+    }
+
+
+    //! \brief  Retrieves one of the events held within the buffer.
+    //! \param  index [in] -
+    //!         Index of the event, 0 is the oldest event still held and getEventCount() - 1 the newest.
+    //! \return The requested event.
+    inline const TraceEvent &TraceBuffer::getEvent(size_t index) const {
+        const uint64_t recorded = m_recorded.load(std::memory_order_acquire);
+        const uint64_t first = recorded - getEventCount();
+
+        return m_events[(first + index) & m_capacityMask];
+    }
+
+
+    //! \brief  Determines whether the buffer has storage for events.
+    //! \return <em>True</em> if the buffer has been initialized otherwise <em>false</em>.
+    inline bool TraceBuffer::isInitialized() const {
+        return nullptr != m_events;
+    }
+
+
+    //! \brief  Retrieves the maximum number of events held by the buffer.
+    //! \return The maximum number of events held by the buffer.
+    inline size_t TraceBuffer::getCapacity() const {
+        return isInitialized() ? m_capacityMask + 1 : 0;
+    }
+
+
+    //! \brief  Retrieves the number of events currently held by the buffer.
+    //! \return The number of events currently held, which never exceeds the capacity.
+    inline size_t TraceBuffer::getEventCount() const {
+        const uint64_t recorded = m_recorded.load(std::memory_order_acquire);
+        const size_t capacity = getCapacity();
+
+        return (recorded < capacity) ? static_cast< size_t >(recorded) : capacity;
+    }
+} // namespace raize
+
+
+// -----------------------------------------------------------------------------------
+
+#endif //!defined( TRACE_BUFFER_HEADER_INCLUDED_FEBRUARY_2017_NFACTORIAL )
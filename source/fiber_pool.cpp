@@ -0,0 +1,193 @@
+//
+// Copyright 2017 nfactorial
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <cassert>
+#include "fiber_pool.h"
+
+
+// -----------------------------------------------------------------------------------
+
+namespace raize {
+    //! Stacks are rounded up to a multiple of this size, as required by the x86-64 and AArch64 ABIs.
+    static const size_t kRaizeStackAlignment = 16;
+
+    //! The smallest stack we allow, anything less would not survive calling into the C library.
+    static const size_t kRaizeMinimumStackSize = 16384;
+
+
+    // -----------------------------------------------------------------------------------
+
+    FiberPool::FiberPool()
+    : m_fiberCount(0)
+    , m_stackSize(0)
+    {
+    }
+
+    FiberPool::~FiberPool() {
+        shutdown();
+    }
+
+
+    //! \brief  Allocates the fibers and their stacks.
+    //! \param  fiberCount [in] -
+    //!         The number of fibers contained within the pool.
+    //! \param  stackSize [in] -
+    //!         Size (in bytes) of each fibers stack.
+    //! \return <em>True</em> if the pool was initialized otherwise <em>false</em> if fibers are not supported or the parameters are invalid.
+    bool FiberPool::initialize(size_t fiberCount, size_t stackSize) {
+#if defined( __linux__ )
+        if (0 != m_fiberCount || 0 == fiberCount || stackSize < kRaizeMinimumStackSize) {
+            return false;
+        }
+
+        stackSize = (stackSize + kRaizeStackAlignment - 1) & ~(kRaizeStackAlignment - 1);
+
+        m_fibers.reset(new Fiber[fiberCount]);
+        m_stacks.reset(new unsigned char[fiberCount * stackSize]);
+        m_freeFibers.reserve(fiberCount);
+
+        for (size_t loop = 0; loop < fiberCount; ++loop) {
+            Fiber &fiber = m_fibers[loop];
+
+            fiber.returnContext = nullptr;
+            fiber.function = nullptr;
+            fiber.argument = nullptr;
+            fiber.finished = true;
+            fiber.waitCounter = nullptr;
+
+            if (0 != getcontext(&fiber.context)) {
+                shutdown();
+                return false;
+            }
+
+            fiber.context.uc_stack.ss_sp = m_stacks.get() + loop * stackSize;
+            fiber.context.uc_stack.ss_size = stackSize;
+            fiber.context.uc_link = nullptr;
+
+            // makecontext only passes int sized arguments, so the pointer is split in two
+            const uint64_t address = reinterpret_cast< uintptr_t >(&fiber);
+            makecontext(&fiber.context, reinterpret_cast< void (*)() >(&FiberPool::fiberEntry), 2, static_cast< uint32_t >(address >> 32), static_cast< uint32_t >(address));
+
+            m_freeFibers.push_back(&fiber);
+        }
+
+        m_fiberCount = fiberCount;
+        m_stackSize = stackSize;
+        return true;
+#else
+        (void)fiberCount;
+        (void)stackSize;
+        return false;
+#endif //defined( __linux__ )
+    }
+
+
+    //! \brief  Releases the fibers and their stacks, no fiber may be running or suspended.
+    void FiberPool::shutdown() {
+        m_freeFibers.clear();
+        m_stacks.reset();
+        m_fibers.reset();
+
+        m_fiberCount = 0;
+        m_stackSize = 0;
+    }
+
+
+    //! \brief  Takes an idle fiber from the pool.
+    //! \return Pointer to the fiber, or <em>nullptr</em> if every fiber is in use.
+    Fiber *FiberPool::acquire() {
+        if (m_freeFibers.empty()) {
+            return nullptr;
+        }
+
+        Fiber *fiber = m_freeFibers.back();
+        m_freeFibers.pop_back();
+        return fiber;
+    }
+
+
+    //! \brief  Returns a finished fiber to the pool.
+    //! \param  fiber [in] -
+    //!         The fiber to be released, its function must have returned.
+    void FiberPool::release(Fiber *fiber) {
+        assert(nullptr != fiber && fiber->finished);
+        m_freeFibers.push_back(fiber);
+    }
+
+
+    //! \brief  Runs a function upon a fiber, returning once the function completes or the fiber suspends.
+    //! \param  fiber [in] -
+    //!         An idle fiber taken from the pool.
+    //! \param  function [in] -
+    //!         The function to be run upon the fiber.
+    //! \param  argument [in] -
+    //!         Value passed to the function.
+    void FiberPool::start(Fiber *fiber, FiberFunction function, void *argument) {
+        assert(nullptr != fiber && fiber->finished);
+
+        fiber->function = function;
+        fiber->argument = argument;
+        fiber->finished = false;
+
+        resume(fiber);
+    }
+
+
+    //! \brief  Continues running a suspended fiber, returning once its function completes or it suspends again.
+    //! \param  fiber [in] -
+    //!         The fiber to be resumed.
+    void FiberPool::resume(Fiber *fiber) {
+#if defined( __linux__ )
+        fiber->returnContext = &m_threadContext;
+        swapcontext(&m_threadContext, &fiber->context);
+#else
+        (void)fiber;
+#endif //defined( __linux__ )
+    }
+
+
+    //! \brief  Suspends the calling fiber, returning control to the thread that resumed it.
+    //! \param  fiber [in] -
+    //!         The fiber currently running on the calling thread.
+    void FiberPool::suspend(Fiber *fiber) {
+#if defined( __linux__ )
+        swapcontext(&fiber->context, fiber->returnContext);
+#else
+        (void)fiber;
+#endif //defined( __linux__ )
+    }
+
+
+    //! \brief  Entry point of every fiber, runs each function the fiber is started with.
+    //! \param  fiberHigh [in] -
+    //!         Upper 32 bits of the address of the fiber.
+    //! \param  fiberLow [in] -
+    //!         Lower 32 bits of the address of the fiber.
+    void FiberPool::fiberEntry(uint32_t fiberHigh, uint32_t fiberLow) {
+        Fiber *fiber = reinterpret_cast< Fiber* >((static_cast< uint64_t >(fiberHigh) << 32) | fiberLow);
+
+        // The fiber is reused rather than recreated, so it never returns from this function
+        for (;;) {
+            fiber->function(fiber->argument);
+            fiber->finished = true;
+
+            suspend(fiber);
+        }
+    }
+
+    // -----------------------------------------------------------------------------------
+
+} // namespace raize
@@ -0,0 +1,159 @@
+//
+// Copyright 2017 nfactorial
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <cstring>
+#include "frame_arena.h"
+
+#if defined( __linux__ )
+    #include <sys/mman.h>
+#endif //defined( __linux__ )
+
+
+// -----------------------------------------------------------------------------------
+
+namespace raize {
+#if defined( __linux__ )
+    //! Size (in bytes) of a huge page, mapped arenas are rounded up to a multiple of this size.
+    static const size_t kRaizeHugePageSize = 2 * 1024 * 1024;
+#endif //defined( __linux__ )
+
+
+    // -----------------------------------------------------------------------------------
+
+    FrameArena::FrameArena()
+    : m_memory(nullptr)
+    , m_capacity(0)
+    , m_mappedSize(0)
+    , m_used(0)
+    , m_hugePages(false)
+    , m_highWater(0)
+    , m_failedAllocations(0)
+    {
+    }
+
+    FrameArena::~FrameArena() {
+        shutdown();
+    }
+
+
+    //! \brief  Allocates the memory the arena hands out.
+    //! \param  capacity [in] -
+    //!         Size (in bytes) of the arena.
+    //! \return <em>True</em> if the arena was initialized otherwise <em>false</em> if the memory could not be allocated.
+    bool FrameArena::initialize(size_t capacity) {
+        return initialize(capacity, false);
+    }
+
+
+    //! \brief  Allocates the memory the arena hands out, optionally from huge pages.
+    //! \param  capacity [in] -
+    //!         Size (in bytes) of the arena.
+    //! \param  hugePages [in] -
+    //!         Whether the arena should be backed by huge pages, which reduces TLB misses for large arenas.
+    //! \return <em>True</em> if the arena was initialized otherwise <em>false</em> if the memory could not be allocated.
+    //!
+    //! Huge pages are a request. On Linux the arena is mapped from the reserved huge page pool,
+    //! or failing that transparent huge pages are requested for an ordinary mapping. Other
+    //! platforms allocate the arena from the heap. See ArenaStatistics::hugePages.
+    bool FrameArena::initialize(size_t capacity, bool hugePages) {
+        shutdown();
+
+        if (0 == capacity) {
+            return false;
+        }
+
+#if defined( __linux__ )
+        if (hugePages) {
+            const size_t mappedSize = (capacity + kRaizeHugePageSize - 1) & ~(kRaizeHugePageSize - 1);
+
+            void *memory = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (MAP_FAILED != memory) {
+                m_hugePages = true;
+            } else {
+                memory = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (MAP_FAILED == memory) {
+                    return false;
+                }
+
+#if defined( MADV_HUGEPAGE )
+                m_hugePages = (0 == madvise(memory, mappedSize, MADV_HUGEPAGE));
+#endif //defined( MADV_HUGEPAGE )
+            }
+
+            m_memory = static_cast< unsigned char* >(memory);
+            m_mappedSize = mappedSize;
+        }
+#else
+        (void)hugePages;
+#endif //defined( __linux__ )
+
+        if (nullptr == m_memory) {
+            m_memory = new unsigned char[capacity];
+        }
+
+        // Touch every page now, so the first frame does not fault them in
+        memset(m_memory, 0, capacity);
+
+        m_capacity = capacity;
+        m_used = 0;
+
+        resetStatistics();
+        return true;
+    }
+
+
+    //! \brief  Releases the memory of the arena, every allocation becomes invalid.
+    void FrameArena::shutdown() {
+        if (nullptr != m_memory) {
+#if defined( __linux__ )
+            if (0 != m_mappedSize) {
+                munmap(m_memory, m_mappedSize);
+            } else {
+                delete [] m_memory;
+            }
+#else
+            delete [] m_memory;
+#endif //defined( __linux__ )
+        }
+
+        m_memory = nullptr;
+        m_capacity = 0;
+        m_mappedSize = 0;
+        m_used = 0;
+        m_hugePages = false;
+    }
+
+
+    //! \brief  Retrieves how much of the arena has been used, may be called from any thread.
+    //! \param  arenaStatistics [out] -
+    //!         Receives the measurements, the high-water mark only includes frames that have ended.
+    void FrameArena::getStatistics(ArenaStatistics &arenaStatistics) const {
+        arenaStatistics.capacity = m_capacity;
+        arenaStatistics.highWater = m_highWater.load(std::memory_order_relaxed);
+        arenaStatistics.failedAllocations = m_failedAllocations.load(std::memory_order_relaxed);
+        arenaStatistics.hugePages = m_hugePages;
+    }
+
+
+    //! \brief  Discards the high-water mark and failed allocation count, this must not be called whilst the arena is in use.
+    void FrameArena::resetStatistics() {
+        m_highWater.store(0, std::memory_order_relaxed);
+        m_failedAllocations.store(0, std::memory_order_relaxed);
+    }
+
+    // -----------------------------------------------------------------------------------
+
+} // namespace raize
@@ -0,0 +1,112 @@
+//
+// Copyright 2017 nfactorial
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <mutex>
+#include <thread>
+#include "performance_timer.h"
+
+#if RAIZE_TIMER_TSC && !defined( _MSC_VER )
+    #include <cpuid.h>
+#endif //RAIZE_TIMER_TSC && !defined( _MSC_VER )
+
+
+// -----------------------------------------------------------------------------------
+
+namespace raize {
+    //! Time (in nanoseconds) the time-stamp counter is measured against the steady clock during calibration.
+    static const uint64_t kRaizeCalibrationNano = 20000000;
+
+    //! Ensures calibration is only performed once, however many schedulers are initialized.
+    static std::once_flag s_calibrateOnce;
+
+    std::atomic<bool> PerformanceTimer::s_tscEnabled(false);
+    uint64_t PerformanceTimer::s_tickScale = 0;
+    uint64_t PerformanceTimer::s_baseTicks = 0;
+    uint64_t PerformanceTimer::s_baseNano = 0;
+
+
+    // -----------------------------------------------------------------------------------
+
+#if RAIZE_TIMER_TSC
+    //! \brief  Determines whether the time-stamp counter runs at a constant rate, regardless of power state.
+    //! \return <em>True</em> if the processor reports an invariant time-stamp counter otherwise <em>false</em>.
+    static bool IsInvariantTsc() {
+        unsigned int registers[4] = {0, 0, 0, 0};
+
+#if defined( _MSC_VER )
+        __cpuid(reinterpret_cast< int* >(registers), 0x80000000);
+        if (registers[0] < 0x80000007) {
+            return false;
+        }
+
+        __cpuid(reinterpret_cast< int* >(registers), 0x80000007);
+#else
+        if (0 == __get_cpuid(0x80000007, &registers[0], &registers[1], &registers[2], &registers[3])) {
+            return false;
+        }
+#endif //defined( _MSC_VER )
+
+        // Bit 8 of EDX reports the invariant TSC
+        return 0 != (registers[3] & (1 << 8));
+    }
+#endif //RAIZE_TIMER_TSC
+
+
+    //! \brief  Switches the timer to the processors time-stamp counter, if it is invariant.
+    //! \return <em>True</em> if the time-stamp counter is in use otherwise <em>false</em> if the system clock is used.
+    //!
+    //! The rate of the counter is measured against the steady clock, which takes a short time
+    //! (around 20 milliseconds) the first time this method is called. Subsequent calls return
+    //! straight away. Timers must not be running whilst the first call is made.
+    bool PerformanceTimer::calibrate() {
+        std::call_once(s_calibrateOnce, &PerformanceTimer::calibrateTsc);
+
+        return isTscEnabled();
+    }
+
+
+    //! \brief  Measures the rate of the time-stamp counter, enabling it if it is suitable.
+    void PerformanceTimer::calibrateTsc() {
+#if RAIZE_TIMER_TSC
+        if (!IsInvariantTsc()) {
+            return;
+        }
+
+        const uint64_t clockBegin = readClock();
+        const uint64_t ticksBegin = __rdtsc();
+
+        std::this_thread::sleep_for(std::chrono::nanoseconds(kRaizeCalibrationNano));
+
+        const uint64_t ticksEnd = __rdtsc();
+        const uint64_t clockEnd = readClock();
+
+        if (ticksEnd <= ticksBegin || clockEnd <= clockBegin) {
+            return;
+        }
+
+        s_tickScale = ((clockEnd - clockBegin) << kTickScaleBits) / (ticksEnd - ticksBegin);
+        s_baseTicks = ticksEnd;
+        s_baseNano = clockEnd;
+
+        if (0 != s_tickScale) {
+            s_tscEnabled.store(true, std::memory_order_release);
+        }
+#endif //RAIZE_TIMER_TSC
+    }
+
+    // -----------------------------------------------------------------------------------
+
+} // namespace raize
@@ -14,19 +14,47 @@
 // limitations under the License.
 //
 
+#include <thread>
+
 #include "../include/scheduler.h"
+#include "../include/performance_timer.h"
+#include "../include/platform.h"
 #include "../include/processor_sync.h"
 
 
 // -----------------------------------------------------------------------------------
 
 namespace raize {
+    //! Number of times a spinning worker checks for a new command between reading the clock.
+    static const size_t kRaizeSpinIterations = 64;
+
+    //! The spin budget used when none is specified, or the limit of the adaptive budget (in nanoseconds).
+    static const uint64_t kRaizeDefaultSpinBudget = 200000;
+
+
     // -----------------------------------------------------------------------------------
 
     ProcessorSync::ProcessorSync()
-    : m_completionCounter(0)
+    : m_executeGeneration(0)
+    , m_completionCounter(0)
+    , m_completedGeneration(0)
+    , m_sleepingWorkers(0)
+    , m_issuerWaiting(false)
+    , m_executeTimestamp(0)
+    , m_completeTimestamp(0)
+    , m_averageGap(0)
+    , m_waitPolicy(kWaitPolicy_Block)
+    , m_spinBudget(kRaizeDefaultSpinBudget)
+    , m_adaptiveBudget(0)
+    , m_wakeCount(0)
+    , m_spinWakeCount(0)
+    , m_yieldWakeCount(0)
+    , m_blockWakeCount(0)
+    , m_totalLatency(0)
+    , m_maximumLatency(0)
     , m_readyCounter(0)
     , m_totalThreads(0)
+    , m_coreCount(0)
     {
     }
 
@@ -41,14 +69,32 @@ namespace raize {
     bool ProcessorSync::initialize(size_t threadCount) {
         if (0 == m_totalThreads) {
             m_totalThreads = threadCount;
+            m_coreCount = std::thread::hardware_concurrency();
             m_readyCounter = 0;
-            m_completionCounter = 0;
+            m_completionCounter.store(0, std::memory_order_relaxed);
             return true;
         }
 
         return false;
     }
 
+    //! \brief  Changes the number of worker threads managed by the synchronization object.
+    //! \param  threadCount [in] -
+    //!         The number of worker threads that respond to subsequent commands.
+    //!
+    //! This may only be called by the issuing thread whilst no command is being processed. Any
+    //! threads being removed must already have exited, threads being added report themselves
+    //! with notifyReady() and waitReady() returns once they have all done so.
+    void ProcessorSync::setThreadCount(size_t threadCount) {
+        std::unique_lock<std::mutex> lock(m_readyMutex);
+
+        if (m_readyCounter > threadCount) {
+            m_readyCounter = threadCount;
+        }
+
+        m_totalThreads = threadCount;
+    }
+
     //! \brief  Notifies the synchronization object that a task processor is ready for use.
     void ProcessorSync::notifyReady() {
         std::unique_lock<std::mutex> lock(m_readyMutex);
@@ -62,26 +108,72 @@ namespace raize {
     //! Calling code should use this method instead of notifyExecute() for the Exit command as
     //! notifyExit() will <em>not</em> wait for the completion condition to be raised.
     void ProcessorSync::notifyExit() {
-        std::unique_lock<std::mutex> lock(m_executeMutex);
-        m_completionCounter = 0;
-        m_executeCondition.notify_all();
+        issueCommand();
     }
 
     //! \brief	Signals that a thread has completed processing of its current operation, when all threads have completed the completion signal is raised.
+    //!
+    //! Only the final thread to complete publishes the completed generation, and it only takes the
+    //! mutex when the issuing thread is already asleep waiting for it.
     void ProcessorSync::notifyComplete() {
-        std::unique_lock<std::mutex> lock(m_executeMutex);
-        if (++m_completionCounter == m_totalThreads) {
-            m_completionCondition.notify_one();
+        if (m_completionCounter.fetch_add(1, std::memory_order_acq_rel) + 1 == m_totalThreads) {
+            m_completedGeneration.store(m_executeGeneration.load(std::memory_order_relaxed), std::memory_order_seq_cst);
+
+            if (m_issuerWaiting.load(std::memory_order_seq_cst)) {
+                std::unique_lock<std::mutex> lock(m_completionMutex);
+                m_completionCondition.notify_one();
+            }
         }
     }
 
     //! \brief	This method waits until an execute loop is issued for a command on the dependent threads.
     //!
+    //! \param  lastGeneration [in] -
+    //!         The generation returned by the previous call to waitExecute(), or by getGeneration() for the first call.
+    //! \return The generation of the command that woke the thread.
+    //!
     //! Worker threads call waitExecute() when they have no work to be performed, this will put them
-    //! to sleep until a new operation has been provided.
-    void ProcessorSync::waitExecute() {
+    //! to sleep until a new operation has been provided. The generation ensures a command issued
+    //! before the worker began waiting is not missed.
+    uint64_t ProcessorSync::waitExecute(uint64_t lastGeneration) {
+        const uint64_t spinBudget = getSpinBudget();
+
+        if (0 != spinBudget) {
+            const PerformanceTimer timer;
+
+            // Spin for the budget, checking the clock only occasionally as reading it is not free
+            do {
+                for (size_t loop = 0; loop < kRaizeSpinIterations; ++loop) {
+                    if (lastGeneration != m_executeGeneration.load(std::memory_order_acquire)) {
+                        return recordWake(m_spinWakeCount);
+                    }
+
+                    RAIZE_CPU_PAUSE();
+                }
+            } while (timer.getElapsedTimeNano() < spinBudget);
+
+            // Then yield for the same duration, allowing other threads to use the core
+            do {
+                if (lastGeneration != m_executeGeneration.load(std::memory_order_acquire)) {
+                    return recordWake(m_yieldWakeCount);
+                }
+
+                std::this_thread::yield();
+            } while (timer.getElapsedTimeNano() < spinBudget * 2);
+        }
+
+        // The issuing thread only wakes sleeping workers, so we must register before checking the generation
         std::unique_lock<std::mutex> lock(m_executeMutex);
-        m_executeCondition.wait(lock);
+        m_sleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+
+        while (lastGeneration == m_executeGeneration.load(std::memory_order_seq_cst)) {
+            m_executeCondition.wait(lock);
+        }
+
+        m_sleepingWorkers.fetch_sub(1, std::memory_order_relaxed);
+        lock.unlock();
+
+        return recordWake(m_blockWakeCount);
     }
 
     //! \brief	Sends a signal to all worker threads that a new command has been issued for processing, then waits for them to complete with a timeout.
@@ -94,15 +186,64 @@ namespace raize {
     //!
     //! \return	<em>True</em> if the threads completed successfully otherwise <em>false</em>
     bool ProcessorSync::notifyExecute(uint64_t timeOut) {
-        std::unique_lock<std::mutex> lock(m_executeMutex);
-        m_completionCounter = 0;
-        m_executeCondition.notify_all();
+        beginExecute();
+        return waitComplete(timeOut);
+    }
+
+    //! \brief	Sends a signal to all worker threads that a new command has been issued for processing, without waiting for them to complete.
+    //!
+    //! This allows the calling thread to take part in the command, it must call waitComplete() once it has finished.
+    void ProcessorSync::beginExecute() {
+        const int64_t timestamp = getTimestamp();
 
-        if (0 != timeOut)
-            return (std::cv_status::no_timeout ==
-                    m_completionCondition.wait_for(lock, std::chrono::milliseconds(timeOut)));
+        if (0 != m_completeTimestamp) {
+            const uint64_t gap = static_cast< uint64_t >(timestamp - m_completeTimestamp);
 
-        m_completionCondition.wait(lock);
+            m_averageGap = (0 != m_averageGap) ? (m_averageGap * 3 + gap) / 4 : gap;
+
+            // Spin slightly longer than the gap we expect, so idle workers catch the next command.
+            // If the gap is longer than we are willing to spin, spinning would only waste the core.
+            const uint64_t predictedBudget = m_averageGap + m_averageGap / 4;
+            // Spinning is also pointless when the workers and issuing thread do not each have a core.
+            const bool spinPermitted = m_totalThreads < m_coreCount && predictedBudget <= m_spinBudget.load(std::memory_order_relaxed);
+            m_adaptiveBudget.store(spinPermitted ? predictedBudget : 0, std::memory_order_relaxed);
+        }
+
+        issueCommand();
+    }
+
+    //! \brief	Waits for all worker threads to complete the command issued by beginExecute().
+    //! \param	timeOut [in] -
+    //!			Maximum duration (in milliseconds) the sync object should wait before giving up, if this value is 0 the sync object will wait indefinitely.
+    //! \return	<em>True</em> if the threads completed successfully otherwise <em>false</em>
+    bool ProcessorSync::waitComplete(uint64_t timeOut) {
+        const uint64_t generation = m_executeGeneration.load(std::memory_order_relaxed);
+
+        if (0 != m_totalThreads && generation != m_completedGeneration.load(std::memory_order_acquire)) {
+            std::unique_lock<std::mutex> lock(m_completionMutex);
+
+            // The final worker only wakes us if it sees this flag, so it must be raised before we check the generation
+            m_issuerWaiting.store(true, std::memory_order_seq_cst);
+
+            const auto completed = [this, generation]() {
+                return generation == m_completedGeneration.load(std::memory_order_seq_cst);
+            };
+
+            bool result = true;
+            if (0 != timeOut) {
+                result = m_completionCondition.wait_for(lock, std::chrono::milliseconds(timeOut), completed);
+            } else {
+                m_completionCondition.wait(lock, completed);
+            }
+
+            m_issuerWaiting.store(false, std::memory_order_relaxed);
+
+            if (!result) {
+                return false;
+            }
+        }
+
+        m_completeTimestamp = getTimestamp();
         return true;
     }
 
@@ -114,6 +255,100 @@ namespace raize {
         }
     }
 
+    //! \brief  Selects how idle worker threads wait for the next command.
+    //! \param  waitPolicy [in] -
+    //!         The method idle workers use to wait for the next command.
+    //! \param  spinBudgetNano [in] -
+    //!         Time (in nanoseconds) a worker spins, and then yields, before sleeping. For the adaptive policy this is the largest budget that will be chosen.
+    //!
+    //! Spinning keeps a core busy whilst there is no work, so the budget should be small compared
+    //! to the frame time. Once the budget has been spent, the worker yields for the same duration.
+    void ProcessorSync::setWaitPolicy(kWaitPolicy waitPolicy, uint64_t spinBudgetNano) {
+        m_spinBudget.store(spinBudgetNano, std::memory_order_relaxed);
+        m_waitPolicy.store(waitPolicy, std::memory_order_relaxed);
+    }
+
+    //! \brief  Retrieves the measurements of how quickly worker threads respond to new commands.
+    //! \param  wakeStatistics [out] -
+    //!         Receives the measurements recorded since the statistics were last reset.
+    void ProcessorSync::getWakeStatistics(WakeStatistics &wakeStatistics) const {
+        wakeStatistics.wakeCount = m_wakeCount.load(std::memory_order_relaxed);
+        wakeStatistics.spinWakeCount = m_spinWakeCount.load(std::memory_order_relaxed);
+        wakeStatistics.yieldWakeCount = m_yieldWakeCount.load(std::memory_order_relaxed);
+        wakeStatistics.blockWakeCount = m_blockWakeCount.load(std::memory_order_relaxed);
+        wakeStatistics.totalLatencyNano = m_totalLatency.load(std::memory_order_relaxed);
+        wakeStatistics.maximumLatencyNano = m_maximumLatency.load(std::memory_order_relaxed);
+        wakeStatistics.spinBudgetNano = getSpinBudget();
+    }
+
+    //! \brief  Discards the measurements recorded by the worker threads.
+    void ProcessorSync::resetWakeStatistics() {
+        m_wakeCount.store(0, std::memory_order_relaxed);
+        m_spinWakeCount.store(0, std::memory_order_relaxed);
+        m_yieldWakeCount.store(0, std::memory_order_relaxed);
+        m_blockWakeCount.store(0, std::memory_order_relaxed);
+        m_totalLatency.store(0, std::memory_order_relaxed);
+        m_maximumLatency.store(0, std::memory_order_relaxed);
+    }
+
+    //! \brief  Determines how long an idle worker should spin before sleeping.
+    //! \return The time (in nanoseconds) an idle worker should spin, 0 if the worker should sleep immediately.
+    uint64_t ProcessorSync::getSpinBudget() const {
+        switch (m_waitPolicy.load(std::memory_order_relaxed)) {
+            case kWaitPolicy_Block:
+                break;
+
+            case kWaitPolicy_Spin:
+                return m_spinBudget.load(std::memory_order_relaxed);
+
+            case kWaitPolicy_Adaptive:
+                return m_adaptiveBudget.load(std::memory_order_relaxed);
+        }
+
+        return 0;
+    }
+
+    //! \brief  Records that a worker has observed a new command.
+    //! \param  wakeCounter [in] -
+    //!         The counter for the method the worker was using to wait.
+    //! \return The generation of the command that woke the thread.
+    uint64_t ProcessorSync::recordWake(std::atomic<uint64_t> &wakeCounter) {
+        const uint64_t generation = m_executeGeneration.load(std::memory_order_acquire);
+        const int64_t latency = getTimestamp() - m_executeTimestamp.load(std::memory_order_relaxed);
+        const uint64_t latencyNano = (latency > 0) ? static_cast< uint64_t >(latency) : 0;
+
+        m_wakeCount.fetch_add(1, std::memory_order_relaxed);
+        wakeCounter.fetch_add(1, std::memory_order_relaxed);
+        m_totalLatency.fetch_add(latencyNano, std::memory_order_relaxed);
+
+        uint64_t maximumLatency = m_maximumLatency.load(std::memory_order_relaxed);
+        while (latencyNano > maximumLatency && !m_maximumLatency.compare_exchange_weak(maximumLatency, latencyNano, std::memory_order_relaxed)) {
+        }
+
+        return generation;
+    }
+
+    //! \brief  Publishes a new command to the worker threads and wakes any that are sleeping.
+    //!
+    //! Workers that are spinning observe the new generation without any further action, the
+    //! mutex is only taken when at least one worker has gone to sleep.
+    void ProcessorSync::issueCommand() {
+        m_completionCounter.store(0, std::memory_order_relaxed);
+        m_executeTimestamp.store(getTimestamp(), std::memory_order_relaxed);
+        m_executeGeneration.fetch_add(1, std::memory_order_seq_cst);
+
+        if (0 != m_sleepingWorkers.load(std::memory_order_seq_cst)) {
+            std::unique_lock<std::mutex> lock(m_executeMutex);
+            m_executeCondition.notify_all();
+        }
+    }
+
+    //! \brief  Retrieves the current time, comparable between threads.
+    //! \return The current time (in nanoseconds) since an unspecified epoch.
+    int64_t ProcessorSync::getTimestamp() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
     // -----------------------------------------------------------------------------------
 
 } //namespace raize
@@ -14,7 +14,9 @@
 // limitations under the License.
 //
 
+#include <algorithm>
 #include <cassert>
+#include <vector>
 #include "scheduler.h"
 #include "performance_timer.h"
 
@@ -37,6 +39,26 @@ namespace raize {
     Scheduler::Scheduler()
     : m_executionTime(0)
     , m_threadCount(0)
+    , m_workerCount(0)
+    , m_maximumThreadCount(0)
+    , m_callerMode(kCallerMode_Wait)
+    , m_hangPolicy(kHangPolicy_Return)
+    , m_taskBudgetNano(0)
+    , m_longTaskFunction(nullptr)
+    , m_buildList(0)
+    , m_pendingList(0)
+    , m_framePending(false)
+    , m_pendingGeneration(0)
+    , m_frameBeginNano(0)
+    , m_traceFrame(0)
+    , m_fiberCount(0)
+    , m_fiberStackSize(0)
+    , m_arenaCapacity(0)
+    , m_arenaHugePages(false)
+    , m_statisticsWindow(0)
+    , m_windowFrames(0)
+    , m_frameCount(0)
+    , m_totalFrameNano(0)
     {
     }
 
@@ -56,56 +78,519 @@ namespace raize {
     //!         The number of threads the scheduler will make use of, this must be less than or equal to RAIZE_SCHEDULER_MAXIMUM_THREADS.
     //! \return <em>True</em> if the scheduler initializes successfully otherwise <em>false</em>.
     bool Scheduler::initialize(size_t threadCount) {
+        return initialize(threadCount, kCallerMode_Wait);
+    }
+
+
+    //! \brief  Prepares the scheduler for use by the application.
+    //! \param  threadCount [in] -
+    //!         The number of threads that will process tasks, this must be less than or equal to RAIZE_SCHEDULER_MAXIMUM_THREADS.
+    //! \param  callerMode [in] -
+    //!         Whether the thread that calls execute() processes tasks alongside the worker threads.
+    //! \return <em>True</em> if the scheduler initializes successfully otherwise <em>false</em>.
+    //!
+    //! When the calling thread participates it counts towards threadCount, so only threadCount - 1
+    //! worker threads are created and the machine is not oversubscribed. The calling thread then
+    //! only sleeps whilst the workers finish their final tasks, rather than for the entire frame.
+    bool Scheduler::initialize(size_t threadCount, kCallerMode callerMode) {
+        return initialize(threadCount, callerMode, nullptr);
+    }
+
+
+    //! \brief  Prepares the scheduler for use by the application, placing each worker thread as requested.
+    //! \param  threadCount [in] -
+    //!         The number of threads that will process tasks, this must be less than or equal to RAIZE_SCHEDULER_MAXIMUM_THREADS.
+    //! \param  callerMode [in] -
+    //!         Whether the thread that calls execute() processes tasks alongside the worker threads.
+    //! \param  placements [in] -
+    //!         Array of threadCount placements, one for each execution context, may be <em>nullptr</em> to leave placement to the operating system.
+    //! \return <em>True</em> if the scheduler initializes successfully otherwise <em>false</em>.
+    //!
+    //! Placements are applied by each worker thread as it starts. When the calling thread
+    //! participates, its placement (the final entry) is not applied, as the thread belongs to the
+    //! application. Use getPhysicalCorePlacements() to place one worker on each physical core.
+    //!
+    //! The first scheduler initialized within the process calibrates PerformanceTimer against
+    //! the steady clock, which delays initialization by around 20 milliseconds.
+    bool Scheduler::initialize(size_t threadCount, kCallerMode callerMode, const ThreadPlacement *placements) {
+        return initializeThreads(threadCount, RAIZE_SCHEDULER_MAXIMUM_THREADS, callerMode, placements, threadCount);
+    }
+
+
+    //! \brief  Prepares the scheduler for use by the application, reserving storage for a number of threads it may later be resized to.
+    //! \param  threadCount [in] -
+    //!         The number of threads that will process tasks, this must be less than or equal to maximumThreadCount.
+    //! \param  maximumThreadCount [in] -
+    //!         The largest number of threads the scheduler may be resized to, see resize().
+    //! \param  callerMode [in] -
+    //!         Whether the thread that calls execute() processes tasks alongside the worker threads.
+    //! \param  placements [in] -
+    //!         Array of maximumThreadCount placements, one for each execution context, may be <em>nullptr</em> to leave placement to the operating system.
+    //! \return <em>True</em> if the scheduler initializes successfully otherwise <em>false</em>.
+    //!
+    //! The maximum is not limited by RAIZE_SCHEDULER_MAXIMUM_THREADS, every context it requires
+    //! is allocated here so that resizing the scheduler does not allocate memory for its queues.
+    bool Scheduler::initialize(size_t threadCount, size_t maximumThreadCount, kCallerMode callerMode, const ThreadPlacement *placements) {
+        return initializeThreads(threadCount, maximumThreadCount, callerMode, placements, maximumThreadCount);
+    }
+
+
+    //! \brief  Prepares the scheduler for use, reserving the execution contexts and starting the worker threads.
+    //! \param  threadCount [in] -
+    //!         The number of threads that will process tasks.
+    //! \param  maximumThreadCount [in] -
+    //!         The number of execution contexts to be reserved.
+    //! \param  callerMode [in] -
+    //!         Whether the thread that calls execute() processes tasks alongside the worker threads.
+    //! \param  placements [in] -
+    //!         Placements of the first placementCount execution contexts, may be <em>nullptr</em>.
+    //! \param  placementCount [in] -
+    //!         The number of entries within the placements array.
+    //! \return <em>True</em> if the scheduler initializes successfully otherwise <em>false</em>.
+    bool Scheduler::initializeThreads(size_t threadCount, size_t maximumThreadCount, kCallerMode callerMode, const ThreadPlacement *placements, size_t placementCount) {
         assert(0 == m_threadCount);
         assert(0 != threadCount);
 
-        if (0 != m_threadCount) {
+        if (0 != m_threadCount || 0 == threadCount || threadCount > maximumThreadCount) {
             //Log( "TaskProcessorCollection::initialize - Collection was already initialized.\n" );
             return false;
         }
 
-        m_syncObject.initialize(threadCount);
+        // Timers read the time-stamp counter once it is calibrated, this only takes time on the first call
+        PerformanceTimer::calibrate();
+
+        const size_t workerCount = (kCallerMode_Participate == callerMode) ? threadCount - 1 : threadCount;
+
+        m_syncObject.initialize(workerCount);
 
-        if (!m_taskProvider.initialize(kRaizeDefaultMaximumTasks)) {
+        // Every queue the scheduler may be resized to use is allocated up front
+        for (size_t loop = 0; loop < m_taskLists.size(); ++loop) {
+            if (!m_taskLists[loop].initialize(kRaizeDefaultMaximumTasks, maximumThreadCount) || !m_taskLists[loop].setContextCount(threadCount)) {
+                return false;
+            }
+        }
+
+        m_taskProcessors.reset(new TaskProcessor[maximumThreadCount]);
+        m_placements.reset(new ThreadPlacement[maximumThreadCount]);
+        m_maximumThreadCount = maximumThreadCount;
+
+        for (size_t loop = 0; loop < maximumThreadCount; ++loop) {
+            if (nullptr != placements && loop < placementCount) {
+                m_placements[loop] = placements[loop];
+            } else {
+                resetThreadPlacement(m_placements[loop]);
+            }
+        }
+
+        m_buildList = 0;
+        m_fiberCount = 0;
+        m_fiberStackSize = 0;
+        m_arenaCapacity = 0;
+        m_arenaHugePages = false;
+
+        m_callerMode = callerMode;
+        m_threadCount = threadCount;
+
+        if (!startWorkers(workerCount)) {
+            shutdown();
             return false;
         }
 
-        for (; m_threadCount < threadCount; ++m_threadCount) {
+        if (kCallerMode_Participate == callerMode) {
             ExecutionContext executionContext;
 
-            executionContext.contextId = static_cast< unsigned int >(m_threadCount);
-            executionContext.executionSpeed = 0;
-            executionContext.tasksProcessed = 0;
+            // The calling thread always uses the final execution context
+            describeContext(workerCount, executionContext);
+            m_taskProcessors[workerCount].initialize(executionContext);
+        }
+
+        m_syncObject.waitReady();
 
-            if (!m_taskProcessors[m_threadCount].initialize(executionContext, &m_syncObject)) {
-                shutdown();
+        resetStatistics();
+        return true;
+    }
+
+
+    //! \brief  Changes the number of threads processing tasks, this must not be called whilst a task is executing.
+    //! \param  threadCount [in] -
+    //!         The number of threads that will process tasks, this must not exceed getMaximumThreadCount().
+    //! \return <em>True</em> if the scheduler was resized otherwise <em>false</em> if the thread count is invalid or a thread failed to start.
+    //!
+    //! Any frame submitted by executeAsync() is completed first. Registered tasks are unaffected,
+    //! subsequent frames distribute them between the new number of threads. Worker threads are
+    //! removed from the end, and any new workers are all started before waiting for them to
+    //! become ready. When the calling thread participates it moves to the new final context.
+    //!
+    //! Contexts brought into use receive the fibers, arena and trace buffer configured for the
+    //! other contexts, their statistics begin empty. Contexts taken out of use release their
+    //! fibers, arenas and trace buffers, and are no longer included within the statistics.
+    bool Scheduler::resize(size_t threadCount) {
+        assert(0 != m_threadCount);
+
+        if (0 == m_threadCount || 0 == threadCount || threadCount > m_maximumThreadCount) {
+            return false;
+        }
+
+        if (m_framePending && !completeFrame(kRaizeExecutionTimeout)) {
+            return false;
+        }
+
+        if (threadCount == m_threadCount) {
+            return true;
+        }
+
+        const size_t workerCount = (kCallerMode_Participate == m_callerMode) ? threadCount - 1 : threadCount;
+
+        for (size_t loop = m_threadCount; loop < threadCount; ++loop) {
+            prepareContext(loop);
+        }
+
+        if (workerCount < m_workerCount) {
+            stopWorkers(workerCount);
+        }
+
+        for (size_t loop = threadCount; loop < m_threadCount; ++loop) {
+            releaseContext(loop);
+        }
+
+        for (size_t loop = 0; loop < m_taskLists.size(); ++loop) {
+            m_taskLists[loop].setContextCount(threadCount);
+        }
+
+        m_threadCount = threadCount;
+
+        if (!startWorkers(workerCount)) {
+            shutdown();
+            return false;
+        }
+
+        if (kCallerMode_Participate == m_callerMode) {
+            ExecutionContext executionContext;
+
+            describeContext(workerCount, executionContext);
+            m_taskProcessors[workerCount].initialize(executionContext);
+        }
+
+        m_syncObject.waitReady();
+        return true;
+    }
+
+
+    //! \brief  Adds threads to those processing tasks, this must not be called whilst a task is executing.
+    //! \param  threadCount [in] -
+    //!         The number of threads to be added.
+    //! \return <em>True</em> if the threads were added otherwise <em>false</em> if the maximum would be exceeded, see resize().
+    bool Scheduler::grow(size_t threadCount) {
+        if (threadCount > m_maximumThreadCount - m_threadCount) {
+            return false;
+        }
+
+        return resize(m_threadCount + threadCount);
+    }
+
+
+    //! \brief  Removes threads from those processing tasks, this must not be called whilst a task is executing.
+    //! \param  threadCount [in] -
+    //!         The number of threads to be removed, at least one thread always remains.
+    //! \return <em>True</em> if the threads were removed otherwise <em>false</em> if too many were requested, see resize().
+    bool Scheduler::shrink(size_t threadCount) {
+        if (threadCount >= m_threadCount) {
+            return false;
+        }
+
+        return resize(m_threadCount - threadCount);
+    }
+
+
+    //! \brief  Starts worker threads until the requested number are running, then sets the number of threads the sync object expects.
+    //! \param  workerCount [in] -
+    //!         The number of worker threads that should be running.
+    //! \return <em>True</em> if every thread was started otherwise <em>false</em>.
+    //!
+    //! Threads are not waited upon individually, they each prepare themselves in parallel and
+    //! the caller waits for them all with ProcessorSync::waitReady().
+    bool Scheduler::startWorkers(size_t workerCount) {
+        m_syncObject.setThreadCount(workerCount);
+
+        for (; m_workerCount < workerCount; ++m_workerCount) {
+            ExecutionContext executionContext;
+            describeContext(m_workerCount, executionContext);
+
+            if (!m_taskProcessors[m_workerCount].initialize(executionContext, &m_syncObject)) {
+                // The threads that did start must be ready before they can be told to exit
+                m_syncObject.setThreadCount(m_workerCount);
+                m_syncObject.waitReady();
                 return false;
             }
         }
 
-        m_syncObject.waitReady();
         return true;
     }
 
 
+    //! \brief  Stops the worker threads beyond the requested number, waiting for them to exit.
+    //! \param  workerCount [in] -
+    //!         The number of worker threads that should remain running.
+    //!
+    //! The remaining workers are woken by the exit command, find they have no command of their
+    //! own and go back to waiting.
+    void Scheduler::stopWorkers(size_t workerCount) {
+        const ThreadCommand threadCommand = {kThreadCommand_Exit, nullptr};
+
+        for (size_t loop = workerCount; loop < m_workerCount; ++loop)
+            m_taskProcessors[loop].postCommand(threadCommand);
+
+        m_syncObject.notifyExit();
+
+        for (size_t loop = workerCount; loop < m_workerCount; ++loop)
+            m_taskProcessors[loop].join();
+
+        m_workerCount = workerCount;
+        m_syncObject.setThreadCount(workerCount);
+    }
+
+
+    //! \brief  Prepares an execution context that is about to be brought into use by resize().
+    //! \param  contextId [in] -
+    //!         Identifier of the execution context.
+    //!
+    //! Should the contexts fibers fail to be created, its tasks run upon its own thread. Should
+    //! its arena fail to be allocated, its tasks receive <em>nullptr</em> from allocateFrameMemory().
+    void Scheduler::prepareContext(size_t contextId) {
+        TaskProcessor &taskProcessor = m_taskProcessors[contextId];
+
+        taskProcessor.resetStatistics();
+        taskProcessor.beginStatisticsWindow(m_statisticsWindow);
+
+        if (0 != m_fiberCount) {
+            taskProcessor.initializeFibers(m_fiberCount, m_fiberStackSize);
+        }
+
+        if (0 != m_arenaCapacity) {
+            taskProcessor.initializeArena(m_arenaCapacity, m_arenaHugePages);
+        }
+
+        if (m_frameTrace.isInitialized()) {
+            taskProcessor.initializeTracing(m_frameTrace.getCapacity());
+        }
+    }
+
+
+    //! \brief  Releases the resources of an execution context that has been taken out of use by resize().
+    //! \param  contextId [in] -
+    //!         Identifier of the execution context.
+    void Scheduler::releaseContext(size_t contextId) {
+        m_taskProcessors[contextId].shutdownFibers();
+        m_taskProcessors[contextId].shutdownArena();
+        m_taskProcessors[contextId].shutdownTracing();
+    }
+
+
+    //! \brief  Describes the environment of an execution context, before its processor is initialized.
+    //! \param  contextId [in] -
+    //!         Identifier of the execution context.
+    //! \param  executionContext [out] -
+    //!         Receives the description of the execution context.
+    void Scheduler::describeContext(size_t contextId, ExecutionContext &executionContext) const {
+        assert(contextId < m_maximumThreadCount);
+
+        executionContext.contextId = static_cast< unsigned int >(contextId);
+        executionContext.executionSpeed = 0;
+        executionContext.tasksProcessed = 0;
+        executionContext.placement = m_placements[contextId];
+    }
+
+
+    //! \brief  Runs every task upon a fiber, allowing tasks to wait for other work without blocking their thread.
+    //! \param  fiberCount [in] -
+    //!         The number of fibers created for each thread, which limits the number of tasks each thread may have waiting.
+    //! \param  stackSize [in] -
+    //!         Size (in bytes) of each fibers stack.
+    //! \return <em>True</em> if the fibers were created otherwise <em>false</em> if fibers are not supported upon this platform.
+    //!
+    //! Every stack is allocated by this method, running tasks upon fibers never allocates memory.
+    //! This must be called after initialize() and whilst the scheduler is not executing. See
+    //! waitForCounter() for how a task waits.
+    bool Scheduler::initializeFibers(size_t fiberCount, size_t stackSize) {
+        assert(0 != m_threadCount);
+
+        if (m_framePending && !completeFrame(kRaizeExecutionTimeout)) {
+            return false;
+        }
+
+        for (size_t loop = 0; loop < m_threadCount; ++loop) {
+            if (!m_taskProcessors[loop].initializeFibers(fiberCount, stackSize)) {
+                for (size_t processor = 0; processor <= loop; ++processor) {
+                    m_taskProcessors[processor].shutdownFibers();
+                }
+
+                m_fiberCount = 0;
+                m_fiberStackSize = 0;
+                return false;
+            }
+        }
+
+        // Remembered so contexts brought into use by resize() receive the same fibers
+        m_fiberCount = fiberCount;
+        m_fiberStackSize = stackSize;
+        return true;
+    }
+
+
+    //! \brief  Gives each thread an arena that its tasks allocate scratch memory from, see allocateFrameMemory().
+    //! \param  capacity [in] -
+    //!         Size (in bytes) of each threads arena.
+    //! \return <em>True</em> if the arenas were allocated otherwise <em>false</em>.
+    bool Scheduler::initializeArenas(size_t capacity) {
+        return initializeArenas(capacity, false);
+    }
+
+
+    //! \brief  Gives each thread an arena that its tasks allocate scratch memory from, see allocateFrameMemory().
+    //! \param  capacity [in] -
+    //!         Size (in bytes) of each threads arena.
+    //! \param  hugePages [in] -
+    //!         Whether the arenas should be backed by huge pages, where the platform supports them.
+    //! \return <em>True</em> if the arenas were allocated otherwise <em>false</em>.
+    //!
+    //! Every arena is allocated and touched by this method, so allocating from an arena never
+    //! enters the operating system. Every allocation is released at once as each frame ends.
+    //! This must be called after initialize() and whilst the scheduler is not executing. Use
+    //! getArenaStatistics() to size the arenas from the memory tasks actually use.
+    bool Scheduler::initializeArenas(size_t capacity, bool hugePages) {
+        assert(0 != m_threadCount);
+
+        if (m_framePending && !completeFrame(kRaizeExecutionTimeout)) {
+            return false;
+        }
+
+        for (size_t loop = 0; loop < m_threadCount; ++loop) {
+            if (!m_taskProcessors[loop].initializeArena(capacity, hugePages)) {
+                shutdownArenas();
+                return false;
+            }
+        }
+
+        // Remembered so contexts brought into use by resize() receive the same arena
+        m_arenaCapacity = capacity;
+        m_arenaHugePages = hugePages;
+        return true;
+    }
+
+
+    //! \brief  Releases every threads arena, this must not be called whilst the scheduler is executing.
+    void Scheduler::shutdownArenas() {
+        for (size_t loop = 0; loop < m_maximumThreadCount; ++loop) {
+            m_taskProcessors[loop].shutdownArena();
+        }
+
+        m_arenaCapacity = 0;
+        m_arenaHugePages = false;
+    }
+
+
+    //! \brief  Begins recording when each thread starts and finishes every piece of work, along with the span of each frame.
+    //! \param  eventCapacity [in] -
+    //!         The number of events held by each threads trace buffer, older events are overwritten once it is full.
+    //! \return <em>True</em> if tracing was enabled otherwise <em>false</em> if tracing was not compiled in, see RAIZE_PROFILER.
+    //!
+    //! Each thread records into its own preallocated buffer, recording never allocates memory or
+    //! takes a lock. This must be called after initialize() and whilst the scheduler is not
+    //! executing. See writeTrace() for viewing the recorded events.
+    bool Scheduler::initializeTracing(size_t eventCapacity) {
+        assert(0 != m_threadCount);
+
+        if (m_framePending && !completeFrame(kRaizeExecutionTimeout)) {
+            return false;
+        }
+
+        shutdownTracing();
+
+        if (!m_frameTrace.initialize(eventCapacity)) {
+            return false;
+        }
+
+        for (size_t loop = 0; loop < m_threadCount; ++loop) {
+            if (!m_taskProcessors[loop].initializeTracing(eventCapacity)) {
+                shutdownTracing();
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+
+    //! \brief  Stops recording trace events and releases the trace buffers.
+    void Scheduler::shutdownTracing() {
+        for (size_t loop = 0; loop < m_maximumThreadCount; ++loop) {
+            m_taskProcessors[loop].shutdownTracing();
+        }
+
+        m_frameTrace.shutdown();
+        m_traceFrame = 0;
+    }
+
+
+    //! \brief  Writes the most recent frames as a Chrome trace, which may be viewed with chrome://tracing or Perfetto.
+    //! \param  file [in] -
+    //!         The file the JSON trace is written to.
+    //! \param  frameCount [in] -
+    //!         The number of completed frames to be written, fewer are written if the trace buffers no longer hold them.
+    //! \return <em>True</em> if the trace was written otherwise <em>false</em> if tracing is not enabled or the file could not be written.
+    //!
+    //! Any frame submitted by executeAsync() is completed before the trace is written. Each
+    //! thread is shown as its own row, with an additional row showing the span of each frame.
+    bool Scheduler::writeTrace(FILE *file, size_t frameCount) {
+        if (nullptr == file || !m_frameTrace.isInitialized()) {
+            return false;
+        }
+
+        if (m_framePending && !completeFrame(kRaizeExecutionTimeout)) {
+            return false;
+        }
+
+        std::vector<const TraceBuffer*> buffers(m_threadCount + 1);
+        for (size_t loop = 0; loop < m_threadCount; ++loop) {
+            buffers[loop] = &m_taskProcessors[loop].getTraceBuffer();
+        }
+
+        buffers[m_threadCount] = &m_frameTrace;
+
+        const uint32_t firstFrame = (frameCount < m_traceFrame) ? m_traceFrame - static_cast< uint32_t >(frameCount) : 0;
+        return writeChromeTrace(file, buffers.data(), buffers.size(), firstFrame);
+    }
+
+
     //! \brief  Terminates all threads and closes the scheduler.
     void Scheduler::shutdown() {
         if (0 != m_threadCount) {
-            const ThreadCommand threadCommand = {kThreadCommand_Exit, nullptr};
-
-            // Send exit command to all child threads
-            for (size_t loop = 0; loop < m_threadCount; ++loop)
-                m_taskProcessors[loop].postCommand(threadCommand);
+            // The workers must finish any frame still in flight before they can exit, however long it takes
+            if (m_framePending) {
+                m_framePending = false;
+                m_syncObject.waitComplete(0);
+            }
 
-            m_syncObject.notifyExit();
+            // Send exit command to all child threads, and wait for them to exit
+            stopWorkers(0);
 
-            // And wait for them to exit
             for (size_t loop = 0; loop < m_threadCount; ++loop)
-                m_taskProcessors[loop].join();
+                m_taskProcessors[loop].shutdownFibers();
+
+            shutdownArenas();
+            shutdownTracing();
 
             m_threadCount = 0;
+            m_fiberCount = 0;
+            m_fiberStackSize = 0;
 
-            m_taskProvider.shutdown();
+            m_taskProcessors.reset();
+            m_placements.reset();
+            m_maximumThreadCount = 0;
+
+            for (size_t loop = 0; loop < m_taskLists.size(); ++loop) {
+                m_taskLists[loop].shutdown();
+            }
         }
     }
 
@@ -115,51 +600,821 @@ namespace raize {
     //!         The function to be called when the task is to be executed.
     //! \return <i>True</i> if the task was successfully created otherwise <i>false</i>.
     bool Scheduler::createTask(TaskExecuteFunction taskFunction) {
-        return m_taskProvider.addTask(taskFunction);
+        if (!waitBuildList()) {
+            return false;
+        }
+
+        return m_taskLists[m_buildList].addTask(taskFunction);
+    }
+
+    //! \brief  Creates a new task for processing within the scheduler.
+    //! \param  taskFunction [in] -
+    //!         The function to be called when the task is to be executed.
+    //! \param  taskId [out] -
+    //!         Receives the identifier of the new task, which may be used when declaring dependencies for subsequent tasks.
+    //! \return <i>True</i> if the task was successfully created otherwise <i>false</i>.
+    bool Scheduler::createTask(TaskExecuteFunction taskFunction, TaskId *taskId) {
+        if (!waitBuildList()) {
+            return false;
+        }
+
+        return m_taskLists[m_buildList].addTask(taskFunction, nullptr, 0, taskId);
+    }
+
+    //! \brief  Creates a new task belonging to the specified priority class.
+    //! \param  taskFunction [in] -
+    //!         The function to be called when the task is to be executed.
+    //! \param  priority [in] -
+    //!         The priority class of the new task.
+    //! \param  taskId [out] -
+    //!         Receives the identifier of the new task, may be <i>nullptr</i> if the identifier is not required.
+    //! \return <i>True</i> if the task was successfully created otherwise <i>false</i>.
+    //!
+    //! Ready tasks of a higher priority are always processed before those of a lower priority,
+    //! except that lower priority tasks are periodically served so they are never starved.
+    bool Scheduler::createTask(TaskExecuteFunction taskFunction, kTaskPriority priority, TaskId *taskId) {
+        if (!waitBuildList()) {
+            return false;
+        }
+
+        return m_taskLists[m_buildList].addTask(taskFunction, priority, taskId);
+    }
+
+    //! \brief  Creates a new task that will not be executed until the tasks it depends upon have completed.
+    //! \param  taskFunction [in] -
+    //!         The function to be called when the task is to be executed.
+    //! \param  dependencies [in] -
+    //!         Identifiers of previously created tasks that must complete before the new task is executed.
+    //! \param  dependencyCount [in] -
+    //!         The number of entries within the dependencies array.
+    //! \param  taskId [out] -
+    //!         Receives the identifier of the new task, may be <i>nullptr</i> if the identifier is not required.
+    //! \return <i>True</i> if the task was successfully created otherwise <i>false</i>.
+    //!
+    //! The entire dependency graph is processed within a single call to execute(), there is
+    //! no need to execute the scheduler multiple times to enforce ordering between tasks.
+    bool Scheduler::createTask(TaskExecuteFunction taskFunction, const TaskId *dependencies, size_t dependencyCount, TaskId *taskId) {
+        if (!waitBuildList()) {
+            return false;
+        }
+
+        return m_taskLists[m_buildList].addTask(taskFunction, dependencies, dependencyCount, taskId);
+    }
+
+    //! \brief  Creates a new task that declares the resources it reads and writes.
+    //! \param  taskFunction [in] -
+    //!         The function to be called when the task is to be executed.
+    //! \param  dependencies [in] -
+    //!         Identifiers of previously created tasks that must complete before the new task is executed, may be <i>nullptr</i>.
+    //! \param  dependencyCount [in] -
+    //!         The number of entries within the dependencies array.
+    //! \param  accesses [in] -
+    //!         The resources read or written by the task.
+    //! \param  accessCount [in] -
+    //!         The number of entries within the accesses array.
+    //! \param  taskId [out] -
+    //!         Receives the identifier of the new task, may be <i>nullptr</i> if the identifier is not required.
+    //! \return <i>True</i> if the task was successfully created otherwise <i>false</i>.
+    //!
+    //! The scheduler guarantees a task that writes a resource never runs at the same time as
+    //! another task that reads or writes it. Conflicting tasks run in the order they were
+    //! created, whilst tasks that only read a resource may run in parallel.
+    bool Scheduler::createTask(TaskExecuteFunction taskFunction, const TaskId *dependencies, size_t dependencyCount, const ResourceAccess *accesses, size_t accessCount, TaskId *taskId) {
+        if (!waitBuildList()) {
+            return false;
+        }
+
+        return m_taskLists[m_buildList].addTask(taskFunction, dependencies, dependencyCount, accesses, accessCount, taskId);
+    }
+
+    //! \brief  Creates a new task whose function receives a pointer to a copy of the supplied payload.
+    //! \param  taskFunction [in] -
+    //!         The function to be called when the task is to be executed.
+    //! \param  payload [in] -
+    //!         The data to be copied into the task, may be <i>nullptr</i> if payloadSize is 0.
+    //! \param  payloadSize [in] -
+    //!         Size (in bytes) of the payload, this must not exceed RAIZE_TASK_PAYLOAD_SIZE.
+    //! \param  taskId [out] -
+    //!         Receives the identifier of the new task, may be <i>nullptr</i> if the identifier is not required.
+    //! \return <i>True</i> if the task was successfully created otherwise <i>false</i>.
+    bool Scheduler::createTask(TaskPayloadFunction taskFunction, const void *payload, size_t payloadSize, TaskId *taskId) {
+        if (!waitBuildList()) {
+            return false;
+        }
+
+        return m_taskLists[m_buildList].addTask(taskFunction, payload, payloadSize, nullptr, 0, nullptr, 0, taskId);
+    }
+
+    //! \brief  Creates a new task belonging to the specified priority class, whose function receives a pointer to a copy of the supplied payload.
+    //! \param  taskFunction [in] -
+    //!         The function to be called when the task is to be executed.
+    //! \param  payload [in] -
+    //!         The data to be copied into the task, may be <i>nullptr</i> if payloadSize is 0.
+    //! \param  payloadSize [in] -
+    //!         Size (in bytes) of the payload, this must not exceed RAIZE_TASK_PAYLOAD_SIZE.
+    //! \param  priority [in] -
+    //!         The priority class of the new task.
+    //! \param  taskId [out] -
+    //!         Receives the identifier of the new task, may be <i>nullptr</i> if the identifier is not required.
+    //! \return <i>True</i> if the task was successfully created otherwise <i>false</i>.
+    bool Scheduler::createTask(TaskPayloadFunction taskFunction, const void *payload, size_t payloadSize, kTaskPriority priority, TaskId *taskId) {
+        if (!waitBuildList()) {
+            return false;
+        }
+
+        return m_taskLists[m_buildList].addTask(taskFunction, payload, payloadSize, priority, taskId);
+    }
+
+    //! \brief  Creates a new task whose function receives a pointer to a copy of the supplied payload.
+    //! \param  taskFunction [in] -
+    //!         The function to be called when the task is to be executed.
+    //! \param  payload [in] -
+    //!         The data to be copied into the task, may be <i>nullptr</i> if payloadSize is 0.
+    //! \param  payloadSize [in] -
+    //!         Size (in bytes) of the payload, this must not exceed RAIZE_TASK_PAYLOAD_SIZE.
+    //! \param  dependencies [in] -
+    //!         Identifiers of previously created tasks that must complete before the new task is executed, may be <i>nullptr</i>.
+    //! \param  dependencyCount [in] -
+    //!         The number of entries within the dependencies array.
+    //! \param  taskId [out] -
+    //!         Receives the identifier of the new task, may be <i>nullptr</i> if the identifier is not required.
+    //! \return <i>True</i> if the task was successfully created otherwise <i>false</i>.
+    //!
+    //! The payload is stored within the task itself, which allows one function to be shared by
+    //! many tasks that each process different data without any memory being allocated.
+    bool Scheduler::createTask(TaskPayloadFunction taskFunction, const void *payload, size_t payloadSize, const TaskId *dependencies, size_t dependencyCount, TaskId *taskId) {
+        if (!waitBuildList()) {
+            return false;
+        }
+
+        return m_taskLists[m_buildList].addTask(taskFunction, payload, payloadSize, dependencies, dependencyCount, nullptr, 0, taskId);
+    }
+
+    //! \brief  Submits a new task for processing within the scheduler, this may be called by any thread.
+    //! \param  taskFunction [in] -
+    //!         The function to be called when the task is to be executed.
+    //! \return <i>True</i> if the task was submitted otherwise <i>false</i> if the task list is full.
+    bool Scheduler::submitTask(TaskExecuteFunction taskFunction) {
+        return m_taskLists[m_buildList].submitTask(taskFunction);
+    }
+
+    //! \brief  Submits a new task belonging to the specified priority class, this may be called by any thread.
+    //! \param  taskFunction [in] -
+    //!         The function to be called when the task is to be executed.
+    //! \param  priority [in] -
+    //!         The priority class of the new task.
+    //! \param  taskId [out] -
+    //!         Receives the identifier of the new task, may be <i>nullptr</i> if the identifier is not required.
+    //! \return <i>True</i> if the task was submitted otherwise <i>false</i> if the task list is full.
+    //!
+    //! Unlike createTask(), any number of threads may submit tasks at once, including whilst a
+    //! frame is being processed by execute(). Submitted tasks have no dependencies and join the
+    //! task list when the next frame begins, after which they are replayed like any other task.
+    //! A task created afterwards may depend upon a submitted task, using its identifier.
+    //!
+    //! As executeAsync() moves on to the next task list, the application must ensure no thread
+    //! is submitting a task whilst it is called.
+    //!
+    //! Unlike createTask(), this does not wait for a frame left in flight by execute(). A
+    //! submission only fills in a slot the workers never read, and it is collected by the
+    //! building thread once that frame has completed.
+    bool Scheduler::submitTask(TaskExecuteFunction taskFunction, kTaskPriority priority, TaskId *taskId) {
+        return m_taskLists[m_buildList].submitTask(taskFunction, priority, taskId);
+    }
+
+    //! \brief  Submits a new task whose function receives a pointer to a copy of the supplied payload, this may be called by any thread.
+    //! \param  taskFunction [in] -
+    //!         The function to be called when the task is to be executed.
+    //! \param  payload [in] -
+    //!         The data to be copied into the task, may be <i>nullptr</i> if payloadSize is 0.
+    //! \param  payloadSize [in] -
+    //!         Size (in bytes) of the payload, this must not exceed RAIZE_TASK_PAYLOAD_SIZE.
+    //! \param  taskId [out] -
+    //!         Receives the identifier of the new task, may be <i>nullptr</i> if the identifier is not required.
+    //! \return <i>True</i> if the task was submitted otherwise <i>false</i> if the payload is too large or the task list is full.
+    bool Scheduler::submitTask(TaskPayloadFunction taskFunction, const void *payload, size_t payloadSize, TaskId *taskId) {
+        return m_taskLists[m_buildList].submitTask(taskFunction, payload, payloadSize, kTaskPriority_Normal, taskId);
+    }
+
+    //! \brief  Spawns a new task from within the task being executed by the calling thread.
+    //! \param  taskFunction [in] -
+    //!         The function to be called when the task is to be executed.
+    //! \return <i>True</i> if the task was spawned otherwise <i>false</i> if the calling thread is not executing a task, or its storage is exhausted.
+    //!
+    //! The spawned task is processed within the current frame. The task that spawned it is not
+    //! considered complete, and its successors are not released, until every task it spawned
+    //! (directly or through its children) has completed. Each thread may spawn a fixed number of
+    //! tasks per frame, should this method fail the work may simply be performed by the caller.
+    bool Scheduler::spawnTask(TaskExecuteFunction taskFunction) {
+        return TaskProcessor::spawnTask(taskFunction);
+    }
+
+    //! \brief  Spawns a new task from within the task being executed by the calling thread.
+    //! \param  taskFunction [in] -
+    //!         The function to be called when the task is to be executed.
+    //! \param  payload [in] -
+    //!         The data to be copied into the task, may be <i>nullptr</i> if payloadSize is 0.
+    //! \param  payloadSize [in] -
+    //!         Size (in bytes) of the payload, this must not exceed RAIZE_TASK_PAYLOAD_SIZE.
+    //! \return <i>True</i> if the task was spawned otherwise <i>false</i> if the calling thread is not executing a task, or its storage is exhausted.
+    bool Scheduler::spawnTask(TaskPayloadFunction taskFunction, const void *payload, size_t payloadSize) {
+        return TaskProcessor::spawnTask(taskFunction, payload, payloadSize);
+    }
+
+    //! \brief  Waits, from within a task, until a counter reaches zero.
+    //! \param  counter [in] -
+    //!         The counter to wait upon, typically decremented by tasks spawned by the caller.
+    //!
+    //! When fibers have been initialized, the waiting task is suspended and its thread processes
+    //! other tasks until the counter reaches zero, the task then resumes upon the same thread.
+    //! Without fibers the thread yields until the counter reaches zero, which ties up the thread
+    //! and relies upon other threads to process the outstanding work.
+    void Scheduler::waitForCounter(const std::atomic<uint32_t> &counter) {
+        TaskProcessor::waitForCounter(counter);
+    }
+
+    //! \brief  Retrieves the execution context of the calling task.
+    //! \return The execution context processing the calling task, or <i>nullptr</i> if the calling thread is not executing a task.
+    ExecutionContext *Scheduler::getCurrentContext() {
+        return TaskProcessor::getCurrentContext();
+    }
+
+    //! \brief  Allocates scratch memory, from within a task, that remains valid until the end of the frame.
+    //! \param  size [in] -
+    //!         Size (in bytes) of the allocation.
+    //! \return Pointer to memory aligned for any fundamental type, or <i>nullptr</i> if the calling thread is not executing a task or its arena is exhausted.
+    void *Scheduler::allocateFrameMemory(size_t size) {
+        return allocateFrameMemory(size, alignof(max_align_t));
+    }
+
+    //! \brief  Allocates scratch memory, from within a task, that remains valid until the end of the frame.
+    //! \param  size [in] -
+    //!         Size (in bytes) of the allocation.
+    //! \param  alignment [in] -
+    //!         Alignment (in bytes) of the allocation, this must be a power of two.
+    //! \return Pointer to the memory, or <i>nullptr</i> if the calling thread is not executing a task or its arena is exhausted.
+    //!
+    //! The memory comes from the arena of the context executing the task, see initializeArenas().
+    //! It is not freed individually, every allocation is released once the frame has completed.
+    void *Scheduler::allocateFrameMemory(size_t size, size_t alignment) {
+        ExecutionContext *executionContext = TaskProcessor::getCurrentContext();
+        if (nullptr == executionContext) {
+            return nullptr;
+        }
+
+        return executionContext->frameArena->allocate(size, alignment);
+    }
+
+    //! \brief  Creates a task that processes a range of indices, which is split between the worker threads.
+    //! \param  begin [in] -
+    //!         The first index within the range.
+    //! \param  end [in] -
+    //!         Index one past the final entry within the range.
+    //! \param  grainSize [in] -
+    //!         The smallest number of indices that will be supplied to a single call of rangeFunction.
+    //! \param  rangeFunction [in] -
+    //!         The function called to process each chunk of the range.
+    //! \return <i>True</i> if the task was successfully created otherwise <i>false</i>.
+    bool Scheduler::parallelFor(size_t begin, size_t end, size_t grainSize, RangeExecuteFunction rangeFunction) {
+        if (!waitBuildList()) {
+            return false;
+        }
+
+        return m_taskLists[m_buildList].addRangeTask(rangeFunction, begin, end, grainSize, nullptr, 0, nullptr);
+    }
+
+    //! \brief  Creates a task that processes a range of indices, which is split between the worker threads.
+    //! \param  begin [in] -
+    //!         The first index within the range.
+    //! \param  end [in] -
+    //!         Index one past the final entry within the range.
+    //! \param  grainSize [in] -
+    //!         The smallest number of indices that will be supplied to a single call of rangeFunction.
+    //! \param  rangeFunction [in] -
+    //!         The function called to process each chunk of the range.
+    //! \param  dependencies [in] -
+    //!         Identifiers of previously created tasks that must complete before the range is processed, may be <i>nullptr</i>.
+    //! \param  dependencyCount [in] -
+    //!         The number of entries within the dependencies array.
+    //! \param  taskId [out] -
+    //!         Receives the identifier of the new task, may be <i>nullptr</i> if the identifier is not required.
+    //! \return <i>True</i> if the task was successfully created otherwise <i>false</i>.
+    //!
+    //! Like any other task, the range is processed every time the scheduler is executed. The
+    //! range is halved repeatedly down to the grain size, idle threads steal the halves and
+    //! split them further. Once the cost of each index has been measured the grain size is
+    //! increased, so that small indices are not distributed one at a time.
+    bool Scheduler::parallelFor(size_t begin, size_t end, size_t grainSize, RangeExecuteFunction rangeFunction, const TaskId *dependencies, size_t dependencyCount, TaskId *taskId) {
+        if (!waitBuildList()) {
+            return false;
+        }
+
+        return m_taskLists[m_buildList].addRangeTask(rangeFunction, begin, end, grainSize, dependencies, dependencyCount, taskId);
+    }
+
+    //! \brief  Moves a previously created task into a different priority class.
+    //! \param  taskId [in] -
+    //!         Identifier of the task whose priority is to be changed.
+    //! \param  priority [in] -
+    //!         The priority class the task will belong to.
+    //! \return <em>True</em> if the priority was changed otherwise <em>false</em> if the task does not exist.
+    bool Scheduler::setTaskPriority(TaskId taskId, kTaskPriority priority) {
+        if (!waitBuildList()) {
+            return false;
+        }
+
+        return m_taskLists[m_buildList].setTaskPriority(taskId, priority);
+    }
+
+    //! \brief  Compiles the registered tasks into the graph that is replayed by each call to execute().
+    //! \return <em>True</em> if the graph was compiled successfully otherwise <em>false</em>.
+    //!
+    //! Calling this method is optional, the graph is compiled automatically by the first call to
+    //! execute() after the task list changes. Applications may call it once their tasks are
+    //! registered so the cost is not incurred within a frame.
+    bool Scheduler::compile() {
+        if (!waitBuildList()) {
+            return false;
+        }
+
+        return m_taskLists[m_buildList].compile();
+    }
+
+    //! \brief  Selects how the worker threads claim tasks, this must not be called whilst the scheduler is executing.
+    //! \param  claimMode [in] -
+    //!         The method the worker threads will use to claim tasks, batched claiming suits very large numbers of small tasks.
+    void Scheduler::setTaskClaimMode(kTaskClaimMode claimMode) {
+        // Every task list is changed, including one still being processed by an asynchronous frame
+        if (m_framePending && !completeFrame(kRaizeExecutionTimeout)) {
+            return;
+        }
+
+        for (size_t loop = 0; loop < m_taskLists.size(); ++loop) {
+            m_taskLists[loop].setClaimMode(claimMode);
+        }
+    }
+
+    //! \brief  Selects how idle worker threads wait for the next call to execute().
+    //! \param  waitPolicy [in] -
+    //!         The method idle workers use to wait, spinning reduces the delay before workers begin each frame.
+    //! \param  spinBudgetNano [in] -
+    //!         Time (in nanoseconds) an idle worker spins before sleeping, or the limit of the adaptive budget.
+    //!
+    //! The adaptive policy measures the time between each call to execute() and spins only when the
+    //! next call is expected within the budget, otherwise the workers sleep straight away.
+    void Scheduler::setWaitPolicy(kWaitPolicy waitPolicy, uint64_t spinBudgetNano) {
+        m_syncObject.setWaitPolicy(waitPolicy, spinBudgetNano);
+    }
+
+    //! \brief  Selects what happens when a frame is not completed within the time out given to execute().
+    //! \param  hangPolicy [in] -
+    //!         The action taken once the time out expires.
+    //!
+    //! By default the call returns false and leaves the frame in flight, so one slow task does not
+    //! tear down every thread. The next call to execute(), executeAsync() or waitFrame() waits for
+    //! the frame to complete before doing anything else. When the caller participates, it cannot
+    //! return until every task has completed, so only the wait for the workers is bounded.
+    void Scheduler::setHangPolicy(kHangPolicy hangPolicy) {
+        m_hangPolicy = hangPolicy;
+    }
+
+    //! \brief  Reports tasks that execute for longer than a budget, whilst a frame is being waited for.
+    //! \param  budgetNano [in] -
+    //!         Time (in nanoseconds) a task may execute for before it is reported.
+    //! \param  longTaskFunction [in] -
+    //!         Function called for each task exceeding the budget, or <i>nullptr</i> to disable the watchdog.
+    //!
+    //! The thread waiting for the frame wakes every budget (at a resolution of one millisecond)
+    //! and reports each task that has been executing for longer, so a task that keeps running is
+    //! reported repeatedly with its growing duration. Tasks are only visible to the watchdog
+    //! when the profiler measures time, see RAIZE_PROFILER.
+    void Scheduler::setWatchdog(uint64_t budgetNano, LongTaskFunction longTaskFunction) {
+        m_taskBudgetNano = budgetNano;
+        m_longTaskFunction = longTaskFunction;
+    }
+
+    //! \brief  Finds the tasks that have been executing for longer than a budget, this may be called from any thread.
+    //! \param  budgetNano [in] -
+    //!         Time (in nanoseconds) a task may execute for before it is included.
+    //! \param  longTasks [out] -
+    //!         Receives a description of each task found, may be <i>nullptr</i> if longTaskCapacity is 0.
+    //! \param  longTaskCapacity [in] -
+    //!         The number of entries within the longTasks array.
+    //! \return The number of tasks exceeding the budget, which may be larger than longTaskCapacity.
+    //!
+    //! Each execution context publishes the work it is executing without taking a lock, so this
+    //! may be used by a separate watchdog thread. It must not be called whilst the scheduler is
+    //! being initialized, resized or shut down.
+    size_t Scheduler::findLongTasks(uint64_t budgetNano, LongTaskReport *longTasks, size_t longTaskCapacity) const {
+        size_t longTaskCount = 0;
+
+        for (size_t loop = 0; loop < m_threadCount; ++loop) {
+            LongTaskReport longTask;
+            if (!m_taskProcessors[loop].getActiveWork(longTask) || longTask.elapsedNano <= budgetNano) {
+                continue;
+            }
+
+            if (longTaskCount < longTaskCapacity) {
+                longTask.contextId = static_cast< uint32_t >(loop);
+                longTasks[longTaskCount] = longTask;
+            }
+
+            longTaskCount++;
+        }
+
+        return longTaskCount;
+    }
+
+    //! \brief  Retrieves measurements of how quickly the worker threads begin processing after execute() is called.
+    //! \param  wakeStatistics [out] -
+    //!         Receives the measurements recorded since the statistics were last reset.
+    void Scheduler::getWakeStatistics(WakeStatistics &wakeStatistics) const {
+        m_syncObject.getWakeStatistics(wakeStatistics);
+    }
+
+    //! \brief  Discards the wake measurements recorded by the worker threads.
+    void Scheduler::resetWakeStatistics() {
+        m_syncObject.resetWakeStatistics();
+    }
+
+    //! \brief  Retrieves measurements of when the tasks within a priority class completed, relative to the start of each frame.
+    //! \param  priority [in] -
+    //!         The priority class whose measurements are required.
+    //! \param  priorityStatistics [out] -
+    //!         Receives the measurements recorded since the statistics were last reset.
+    void Scheduler::getPriorityStatistics(kTaskPriority priority, PriorityStatistics &priorityStatistics) const {
+        priorityStatistics.taskCount = 0;
+        priorityStatistics.totalCompletionNano = 0;
+        priorityStatistics.maximumCompletionNano = 0;
+
+        // Each task list records its own measurements, they are combined here
+        for (size_t loop = 0; loop < m_taskLists.size(); ++loop) {
+            PriorityStatistics listStatistics;
+            m_taskLists[loop].getPriorityStatistics(priority, listStatistics);
+
+            priorityStatistics.taskCount += listStatistics.taskCount;
+            priorityStatistics.totalCompletionNano += listStatistics.totalCompletionNano;
+            if (listStatistics.maximumCompletionNano > priorityStatistics.maximumCompletionNano) {
+                priorityStatistics.maximumCompletionNano = listStatistics.maximumCompletionNano;
+            }
+        }
+    }
+
+    //! \brief  Discards the completion measurements of every priority class.
+    void Scheduler::resetPriorityStatistics() {
+        for (size_t loop = 0; loop < m_taskLists.size(); ++loop) {
+            m_taskLists[loop].resetPriorityStatistics();
+        }
+    }
+
+    //! \brief  Retrieves measurements of the frames and tasks processed by the scheduler, may be called from any thread.
+    //! \param  statistics [out] -
+    //!         Receives the measurements, durations cover the rolling window whilst totals cover every frame since the statistics were reset.
+    //!
+    //! The measurements are recorded without locks whilst frames are processed, so a frame being
+    //! processed whilst this method is called may be partially included.
+    void Scheduler::getStatistics(SchedulerStatistics &statistics) const {
+        Histogram durations;
+
+        for (uint32_t loop = 0; loop < kRaizeStatisticsWindows; ++loop) {
+            durations.merge(m_frameDurations[loop]);
+        }
+
+        durations.getStatistics(statistics.frameDuration);
+        durations.clear();
+
+        statistics.totalTaskNano = 0;
+        for (size_t loop = 0; loop < m_threadCount; ++loop) {
+            ContextStatistics contextStatistics;
+            m_taskProcessors[loop].getContextStatistics(contextStatistics);
+            m_taskProcessors[loop].mergeTaskDurations(durations);
+
+            statistics.totalTaskNano += contextStatistics.busyNano;
+        }
+
+        durations.getStatistics(statistics.taskDuration);
+
+        statistics.frameCount = m_frameCount.load(std::memory_order_relaxed);
+        statistics.totalFrameNano = m_totalFrameNano.load(std::memory_order_relaxed);
+        statistics.parallelSpeedup = (0 != statistics.totalFrameNano) ? static_cast< double >(statistics.totalTaskNano) / static_cast< double >(statistics.totalFrameNano) : 0.0;
+    }
+
+    //! \brief  Retrieves how an execution context has spent its time since the statistics were reset.
+    //! \param  contextId [in] -
+    //!         Identifier of the execution context, the calling thread uses the final context when it participates.
+    //! \param  contextStatistics [out] -
+    //!         Receives the measurements of the execution context.
+    //! \return <em>True</em> if the measurements were retrieved otherwise <em>false</em> if the context does not exist.
+    bool Scheduler::getContextStatistics(size_t contextId, ContextStatistics &contextStatistics) const {
+        if (contextId >= m_threadCount) {
+            return false;
+        }
+
+        m_taskProcessors[contextId].getContextStatistics(contextStatistics);
+
+        // Whatever time the context did not spend within a frame, it spent idle
+        const uint64_t elapsedNano = m_statisticsTimer.getElapsedTimeNano();
+        const uint64_t frameNano = contextStatistics.busyNano + contextStatistics.waitNano;
+
+        contextStatistics.idleNano = (elapsedNano > frameNano) ? elapsedNano - frameNano : 0;
+        return true;
+    }
+
+    //! \brief  Discards the frame and task measurements, this must not be called whilst the scheduler is executing.
+    void Scheduler::resetStatistics() {
+        for (uint32_t loop = 0; loop < kRaizeStatisticsWindows; ++loop) {
+            m_frameDurations[loop].clear();
+        }
+
+        for (size_t loop = 0; loop < m_maximumThreadCount; ++loop) {
+            m_taskProcessors[loop].resetStatistics();
+        }
+
+        m_windowFrames = 0;
+        m_frameCount.store(0, std::memory_order_relaxed);
+        m_totalFrameNano.store(0, std::memory_order_relaxed);
+        m_statisticsTimer.reset();
+    }
+
+    //! \brief  Retrieves how much of an execution contexts arena its tasks have used.
+    //! \param  contextId [in] -
+    //!         Identifier of the execution context, the calling thread uses the final context when it participates.
+    //! \param  arenaStatistics [out] -
+    //!         Receives the measurements of the contexts arena.
+    //! \return <em>True</em> if the measurements were retrieved otherwise <em>false</em> if the context does not exist.
+    bool Scheduler::getArenaStatistics(size_t contextId, ArenaStatistics &arenaStatistics) const {
+        if (contextId >= m_threadCount) {
+            return false;
+        }
+
+        m_taskProcessors[contextId].getFrameArena().getStatistics(arenaStatistics);
+        return true;
+    }
+
+    //! \brief  Discards the high-water marks of every arena, this must not be called whilst the scheduler is executing.
+    void Scheduler::resetArenaStatistics() {
+        for (size_t loop = 0; loop < m_maximumThreadCount; ++loop) {
+            m_taskProcessors[loop].getFrameArena().resetStatistics();
+        }
     }
 
     //! \brief  Retrieves the maximum number of tasks supported by the scheduler instance.
     //! \return The maximum number of tasks that may be queued within the scheduler.
     size_t Scheduler::getMaximumTasks() const {
-        return m_taskProvider.getMaximumTasks();
+        return m_taskLists[m_buildList].getMaximumTasks();
     }
 
     //! \brief  Begins processing of the current task queue.
     //! \return <em>True</em> if processing completed successfully otherwise <em>false</em> if an issue occurred during processing.
     bool Scheduler::execute() {
-        execute(kRaizeExecutionTimeout);
+        return execute(kRaizeExecutionTimeout);
     }
 
     //! \brief  Begins processing of the current task queue with a specified timeout value.
     //! \param  timeOut [in] -
     //!         Time (in milliseconds) allowed for a task to complete executing before being considered hung.
     //! \return <em>True</em> if processing completed successfully otherwise <em>false</em> if an issue occurred during processing.
+    //!
+    //! Should the frame not complete in time, the action taken is chosen by setHangPolicy(). Tasks
+    //! that run for too long may be reported whilst the frame is waited for, see setWatchdog().
+    //! A frame left in flight still owns the task list, so the next call that changes the task
+    //! list waits for it to complete first, failing if it does not. See waitBuildList().
     bool Scheduler::execute(uint64_t timeOut) {
         assert(0 != m_threadCount);
 
-        PerformanceTimer timer;
+        // A frame submitted by executeAsync() must complete before the workers can begin another
+        if (m_framePending && !completeFrame(timeOut)) {
+            return false;
+        }
+
+        TaskProvider &taskList = m_taskLists[m_buildList];
 
-        const size_t taskCount = m_taskProvider.onBeginProcessing();
+        // Every thread processes the frame, including the caller when it participates
+        taskList.setContextCount(m_threadCount);
+
+        m_frameTimer.reset();
+
+        beginFrame();
+
+        const size_t taskCount = taskList.onBeginProcessing();
         if (0 != taskCount) {
-            if (!executeTasks(m_taskProvider, timeOut)) {
-                // TODO: If we timed out, we report tasks that are currently being processed.
-                // Also log any tasks that took an extraordinary amount of time to complete.
-                // The user should be able to disable the timeout at compile time, so that
-                // we (optionally) don't fail at run-time in the wild.
+            if (!executeTasks(taskList, timeOut)) {
+                // The frame is left in flight, it is completed like one submitted by executeAsync().
+                // Any long tasks were reported by the watchdog whilst we waited.
+                m_pendingList = m_buildList;
+                m_pendingGeneration = m_syncObject.getGeneration();
+                m_framePending = true;
 
-                shutdown();     // We're no longer valid for executing tasks, we shutdown to avoid continually failing. We might restart ourselves in the future if desirable
+                if (kHangPolicy_Shutdown == m_hangPolicy) {
+                    shutdown();
+                }
 
                 return false;
             }
 
-            m_taskProvider.onEndProcessing();
+            taskList.onEndProcessing();
         }
 
-        m_executionTime = timer.getElapsedTimeMilli();
+        endFrame();
+
+        m_executionTime = m_frameTimer.getElapsedTimeMilli();
         return true;
     }
 
 
+    //! \brief  Submits the current task list for processing and returns without waiting for it to complete.
+    //! \param  frameHandle [out] -
+    //!         Receives the handle used to poll or wait for the frame to complete.
+    //! \return <em>True</em> if the frame was submitted successfully otherwise <em>false</em> if the previous frame failed to complete.
+    bool Scheduler::executeAsync(FrameHandle &frameHandle) {
+        return executeAsync(frameHandle, kRaizeExecutionTimeout);
+    }
+
+
+    //! \brief  Submits the current task list for processing and returns without waiting for it to complete.
+    //! \param  frameHandle [out] -
+    //!         Receives the handle used to poll or wait for the frame to complete.
+    //! \param  timeOut [in] -
+    //!         Time (in milliseconds) allowed for the previously submitted frame to complete, if it is still being processed.
+    //! \return <em>True</em> if the frame was submitted successfully otherwise <em>false</em> if the previous frame failed to complete.
+    //!
+    //! Once submitted, the scheduler moves on to the next of its RAIZE_SCHEDULER_TASK_LISTS task
+    //! lists, which is emptied so the application can build the following frame whilst this one
+    //! is processed. Unlike execute(), the submitted tasks are therefore not replayed by later
+    //! frames. Only one frame is processed at a time, submitting a frame whilst the previous
+    //! one is still being processed waits for the previous frame to complete.
+    //!
+    //! The calling thread never processes tasks submitted by this method, if the scheduler was
+    //! initialized without any worker threads the frame is processed before this method returns.
+    bool Scheduler::executeAsync(FrameHandle &frameHandle, uint64_t timeOut) {
+        assert(0 != m_threadCount);
+
+        if (m_framePending && !completeFrame(timeOut)) {
+            return false;
+        }
+
+        TaskProvider &taskList = m_taskLists[m_buildList];
+
+        // The caller does not process asynchronous frames, so tasks are only distributed to the
+        // workers. Otherwise the callers share would wait to be stolen, behind the workers own queues.
+        taskList.setContextCount((0 != m_workerCount) ? m_workerCount : m_threadCount);
+
+        frameHandle.generation = 0;
+        m_frameTimer.reset();
+
+        beginFrame();
+
+        const size_t taskCount = taskList.onBeginProcessing();
+        if (0 != taskCount) {
+            if (0 != m_workerCount) {
+                postExecute(taskList);
+                m_syncObject.beginExecute();
+
+                m_pendingList = m_buildList;
+                m_pendingGeneration = m_syncObject.getGeneration();
+                m_framePending = true;
+
+                frameHandle.generation = m_pendingGeneration;
+            } else {
+                m_taskProcessors[m_workerCount].processTasks(&taskList);
+                taskList.onEndProcessing();
+            }
+        }
+
+        if (!m_framePending) {
+            endFrame();
+            m_executionTime = m_frameTimer.getElapsedTimeMilli();
+        }
+
+        m_buildList = (m_buildList + 1) % m_taskLists.size();
+        m_taskLists[m_buildList].clearTasks();
+
+        return true;
+    }
+
+
+    //! \brief  Determines whether a frame submitted by executeAsync() has been processed.
+    //! \param  frameHandle [in] -
+    //!         The handle returned when the frame was submitted.
+    //! \return <em>True</em> if every task within the frame has completed otherwise <em>false</em>.
+    bool Scheduler::isFrameComplete(const FrameHandle &frameHandle) const {
+        return m_syncObject.isComplete(frameHandle.generation);
+    }
+
+
+    //! \brief  Waits for a frame submitted by executeAsync() to be processed.
+    //! \param  frameHandle [in] -
+    //!         The handle returned when the frame was submitted.
+    //! \return <em>True</em> if the frame completed successfully otherwise <em>false</em> if it failed to complete.
+    bool Scheduler::waitFrame(const FrameHandle &frameHandle) {
+        return waitFrame(frameHandle, kRaizeExecutionTimeout);
+    }
+
+
+    //! \brief  Waits for a frame submitted by executeAsync() to be processed.
+    //! \param  frameHandle [in] -
+    //!         The handle returned when the frame was submitted.
+    //! \param  timeOut [in] -
+    //!         Time (in milliseconds) allowed for the frame to complete before being considered hung.
+    //! \return <em>True</em> if the frame completed successfully otherwise <em>false</em> if it failed to complete.
+    bool Scheduler::waitFrame(const FrameHandle &frameHandle, uint64_t timeOut) {
+        if (m_framePending && frameHandle.generation == m_pendingGeneration) {
+            return completeFrame(timeOut);
+        }
+
+        return true;
+    }
+
+
+    //! \brief  Waits for a frame left in flight upon the task list being built, before the list is changed.
+    //! \return <em>True</em> if the task list may be changed otherwise <em>false</em> if its frame failed to complete.
+    //!
+    //! A frame submitted by executeAsync() is processed from another task list, so it is not
+    //! waited for and the next frame may be built whilst it is processed.
+    bool Scheduler::waitBuildList() {
+        if (m_framePending && m_pendingList == m_buildList) {
+            return completeFrame(kRaizeExecutionTimeout);
+        }
+
+        return true;
+    }
+
+
+    //! \brief  Waits for the frame submitted by executeAsync() to complete, and releases its task list.
+    //! \param  timeOut [in] -
+    //!         Time (in milliseconds) allowed for the frame to complete before being considered hung.
+    //! \return <em>True</em> if the frame completed successfully otherwise <em>false</em>.
+    bool Scheduler::completeFrame(uint64_t timeOut) {
+        assert(m_framePending);
+
+        if (!waitTasks(timeOut)) {
+            // The frame remains pending, so a later call may wait for it again
+            if (kHangPolicy_Shutdown == m_hangPolicy) {
+                shutdown();
+            }
+
+            return false;
+        }
+
+        m_framePending = false;
+
+        m_taskLists[m_pendingList].onEndProcessing();
+        endFrame();
+
+        m_executionTime = m_frameTimer.getElapsedTimeMilli();
+        return true;
+    }
+
+
+    //! \brief  Prepares the threads to record the measurements of the frame about to be processed.
+    void Scheduler::beginFrame() {
+        // Once the window is full the oldest window is discarded and recording moves to it
+        if (RAIZE_STATISTICS_WINDOW_FRAMES == m_windowFrames) {
+            m_statisticsWindow++;
+            m_windowFrames = 0;
+
+            m_frameDurations[m_statisticsWindow % kRaizeStatisticsWindows].clear();
+            for (size_t loop = 0; loop < m_threadCount; ++loop) {
+                m_taskProcessors[loop].beginStatisticsWindow(m_statisticsWindow);
+            }
+        }
+
+        if (m_frameTrace.isInitialized()) {
+            for (size_t loop = 0; loop < m_threadCount; ++loop) {
+                m_taskProcessors[loop].setTraceFrame(m_traceFrame);
+            }
+        }
+
+        m_frameBeginNano = PerformanceTimer::getTimeNano();
+    }
+
+
+    //! \brief  Records the measurements of the frame that has just completed, and releases the memory its tasks allocated.
+    void Scheduler::endFrame() {
+        const uint64_t frameEndNano = PerformanceTimer::getTimeNano();
+        const uint64_t frameNano = frameEndNano - m_frameBeginNano;
+
+        if (0 != m_arenaCapacity) {
+            for (size_t loop = 0; loop < m_threadCount; ++loop) {
+                m_taskProcessors[loop].getFrameArena().reset();
+            }
+        }
+
+        m_frameDurations[m_statisticsWindow % kRaizeStatisticsWindows].record(frameNano);
+        m_windowFrames++;
+
+        m_frameCount.store(m_frameCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        m_totalFrameNano.store(m_totalFrameNano.load(std::memory_order_relaxed) + frameNano, std::memory_order_relaxed);
+
+        if (m_frameTrace.isInitialized()) {
+            const TraceEvent traceEvent = {m_frameBeginNano, frameEndNano, kInvalidTaskId, static_cast< uint32_t >(m_threadCount), m_traceFrame, kTraceEvent_Frame};
+            m_frameTrace.record(traceEvent);
+
+            m_traceFrame++;
+        }
+    }
+
+
     //! \brief  Tells all task processing threads to begin processing tasks.
     //! \param  taskProvider [in] -
     //!         The TaskProvider implementation that will supply tasks to all child threads.
@@ -169,12 +1424,75 @@ namespace raize {
     bool Scheduler::executeTasks(TaskProvider &taskProvider, uint64_t timeOut) {
         assert(0 != m_threadCount);
 
+        postExecute(taskProvider);
+
+        m_syncObject.beginExecute();
+
+        // We process tasks until none are ready, then leave the tail of the frame to the workers so
+        // the time out and watchdog apply whilst we wait. The time out begins once we stop, a task
+        // we are executing ourselves cannot be interrupted. Without workers we process every task.
+        if (kCallerMode_Participate == m_callerMode) {
+            m_taskProcessors[m_workerCount].processTasks(&taskProvider, 0 == m_workerCount);
+        }
+
+        return waitTasks(timeOut);
+    }
+
+
+    //! \brief  Waits for the worker threads to complete the current command, reporting long tasks meanwhile.
+    //! \param  timeOut [in] -
+    //!         Time (in milliseconds) allowed for the command to complete, 0 to wait indefinitely.
+    //! \return <em>True</em> if the command completed otherwise <em>false</em> if the time out expired.
+    bool Scheduler::waitTasks(uint64_t timeOut) {
+        const uint64_t limit = (kHangPolicy_Wait == m_hangPolicy) ? 0 : timeOut;
+
+        if (nullptr == m_longTaskFunction) {
+            return m_syncObject.waitComplete(limit);
+        }
+
+        const uint64_t budgetMilli = std::max< uint64_t >(m_taskBudgetNano / 1000000, 1);
+        const PerformanceTimer timer;
+
+        for (;;) {
+            uint64_t waitMilli = budgetMilli;
+            if (0 != limit) {
+                const uint64_t elapsedMilli = timer.getElapsedTimeMilli();
+                if (elapsedMilli >= limit) {
+                    return false;
+                }
+
+                waitMilli = std::min(waitMilli, limit - elapsedMilli);
+            }
+
+            if (m_syncObject.waitComplete(waitMilli)) {
+                return true;
+            }
+
+            reportLongTasks();
+        }
+    }
+
+
+    //! \brief  Passes each task that has exceeded the watchdog budget to the watchdog function.
+    void Scheduler::reportLongTasks() const {
+        for (size_t loop = 0; loop < m_threadCount; ++loop) {
+            LongTaskReport longTask;
+            if (m_taskProcessors[loop].getActiveWork(longTask) && longTask.elapsedNano > m_taskBudgetNano) {
+                longTask.contextId = static_cast< uint32_t >(loop);
+                m_longTaskFunction(longTask);
+            }
+        }
+    }
+
+
+    //! \brief  Hands a task list to each of the worker threads, they begin processing once the command is issued.
+    //! \param  taskProvider [in] -
+    //!         The TaskProvider implementation that will supply tasks to all child threads.
+    void Scheduler::postExecute(TaskProvider &taskProvider) {
         const ThreadCommand threadCommand = {kThreadCommand_Execute, &taskProvider};
 
-        for (size_t loop = 0; loop < m_threadCount; ++loop)
+        for (size_t loop = 0; loop < m_workerCount; ++loop)
             m_taskProcessors[loop].postCommand(threadCommand);
-
-        return m_syncObject.notifyExecute(timeOut);
     }
 
     // -----------------------------------------------------------------------------------
@@ -0,0 +1,136 @@
+//
+// Copyright 2017 nfactorial
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <cassert>
+#include "statistics.h"
+
+
+// -----------------------------------------------------------------------------------
+
+namespace raize {
+    // -----------------------------------------------------------------------------------
+
+    Histogram::Histogram() {
+        clear();
+    }
+
+    Histogram::~Histogram() {
+    }
+
+
+    //! \brief  Discards every value recorded within the histogram.
+    void Histogram::clear() {
+        for (uint32_t loop = 0; loop < kHistogramBucketCount; ++loop) {
+            m_counts[loop].store(0, std::memory_order_relaxed);
+        }
+    }
+
+
+    //! \brief  Adds the values recorded by another histogram into this one.
+    //! \param  other [in] -
+    //!         The histogram whose values are to be added.
+    void Histogram::merge(const Histogram &other) {
+        for (uint32_t loop = 0; loop < kHistogramBucketCount; ++loop) {
+            const uint64_t count = other.m_counts[loop].load(std::memory_order_relaxed);
+            if (0 != count) {
+                m_counts[loop].fetch_add(count, std::memory_order_relaxed);
+            }
+        }
+    }
+
+
+    //! \brief  Retrieves the number of values recorded within the histogram.
+    //! \return The number of values recorded within the histogram.
+    uint64_t Histogram::getCount() const {
+        uint64_t count = 0;
+        for (uint32_t loop = 0; loop < kHistogramBucketCount; ++loop) {
+            count += m_counts[loop].load(std::memory_order_relaxed);
+        }
+
+        return count;
+    }
+
+
+    //! \brief  Retrieves the value below which a fraction of the recorded values lie.
+    //! \param  fraction [in] -
+    //!         The fraction of values, between 0 and 1. For example 0.95 retrieves the 95th percentile.
+    //! \return The percentile, to the precision of the histogram, or 0 if no values have been recorded.
+    uint64_t Histogram::getPercentile(double fraction) const {
+        const uint64_t count = getCount();
+        if (0 == count) {
+            return 0;
+        }
+
+        uint64_t target = static_cast< uint64_t >(fraction * static_cast< double >(count) + 0.5);
+        if (0 == target) {
+            target = 1;
+        } else if (target > count) {
+            target = count;
+        }
+
+        uint64_t total = 0;
+        for (uint32_t loop = 0; loop < kHistogramBucketCount; ++loop) {
+            total += m_counts[loop].load(std::memory_order_relaxed);
+            if (total >= target) {
+                return getBucketValue(loop);
+            }
+        }
+
+        // Only reached if the buckets changed whilst we were reading them
+        return getBucketValue(kHistogramBucketCount - 1);
+    }
+
+
+    //! \brief  Summarizes the values recorded within the histogram.
+    //! \param  durationStatistics [out] -
+    //!         Receives the count and percentiles of the recorded values.
+    void Histogram::getStatistics(DurationStatistics &durationStatistics) const {
+        durationStatistics.count = getCount();
+        durationStatistics.p50Nano = getPercentile(0.50);
+        durationStatistics.p95Nano = getPercentile(0.95);
+        durationStatistics.p99Nano = getPercentile(0.99);
+        durationStatistics.maximumNano = 0;
+
+        for (uint32_t loop = kHistogramBucketCount; loop > 0; --loop) {
+            if (0 != m_counts[loop - 1].load(std::memory_order_relaxed)) {
+                durationStatistics.maximumNano = getBucketValue(loop - 1);
+                break;
+            }
+        }
+    }
+
+
+    //! \brief  Retrieves the largest value stored within a bucket.
+    //! \param  bucket [in] -
+    //!         Index of the bucket, as returned by getBucketIndex().
+    //! \return The largest value that is stored within the bucket.
+    uint64_t Histogram::getBucketValue(uint32_t bucket) {
+        assert(bucket < kHistogramBucketCount);
+
+        if (bucket < kHistogramSubBuckets) {
+            return bucket;
+        }
+
+        const uint32_t shift = bucket / kHistogramSubBuckets - 1;
+        const uint64_t subBucket = bucket % kHistogramSubBuckets;
+
+        // Wraps to the largest representable value for the final bucket
+        return ((kHistogramSubBuckets + subBucket + 1) << shift) - 1;
+    }
+
+    // -----------------------------------------------------------------------------------
+
+} // namespace raize
@@ -0,0 +1,163 @@
+//
+// Copyright 2017 nfactorial
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <cassert>
+#include "task_graph.h"
+
+
+// -----------------------------------------------------------------------------------
+
+namespace raize {
+    // -----------------------------------------------------------------------------------
+
+    TaskGraph::TaskGraph()
+    : m_compiled(false)
+    , m_frame(0)
+    , m_taskCount(0)
+    {
+    }
+
+    TaskGraph::~TaskGraph() {
+    }
+
+
+    //! \brief  Reserves the storage required by the graph.
+    //! \param  taskCapacity [in] -
+    //!         The maximum number of tasks the graph may contain.
+    //! \param  dependencyCapacity [in] -
+    //!         The maximum number of dependencies that may exist between the tasks.
+    //! \return <em>True</em> if the graph initialized successfully otherwise <em>false</em>.
+    bool TaskGraph::initialize(size_t taskCapacity, size_t dependencyCapacity) {
+        if (0 == taskCapacity) {
+            return false;
+        }
+
+        m_successorOffsets.reserve(taskCapacity + 1);
+        m_predecessorCounts.reserve(taskCapacity);
+        m_successors.reserve(dependencyCapacity);
+        m_readyTasks.reserve(taskCapacity);
+        m_arrivals.reset(new std::atomic<uint64_t>[taskCapacity]);
+
+        invalidate();
+        return true;
+    }
+
+
+    //! \brief  Releases the storage used by the graph.
+    void TaskGraph::shutdown() {
+        invalidate();
+
+        m_arrivals.reset();
+        m_readyTasks.clear();
+        m_successors.clear();
+        m_predecessorCounts.clear();
+        m_successorOffsets.clear();
+    }
+
+
+    //! \brief  Marks the graph as requiring compilation, typically because the task list has changed.
+    void TaskGraph::invalidate() {
+        m_compiled = false;
+        m_frame = 0;
+        m_taskCount = 0;
+
+        for (size_t loop = 0; loop <= kTaskPriority_Count; ++loop) {
+            m_readyClassOffsets[loop] = 0;
+        }
+    }
+
+
+    //! \brief  Builds the flat successor arrays and initial ready list from the registered tasks.
+    //! \param  tasks [in] -
+    //!         The registered tasks, whose dependencies are stored as linked lists of edges.
+    //! \param  taskCount [in] -
+    //!         The number of entries within the tasks array.
+    //! \param  edges [in] -
+    //!         The edges referenced by the tasks.
+    //! \return <em>True</em> if the graph was compiled successfully otherwise <em>false</em> if it exceeded the reserved storage.
+    bool TaskGraph::compile(const TaskInfo *tasks, size_t taskCount, const TaskEdge *edges) {
+        invalidate();
+
+        if (taskCount > m_predecessorCounts.capacity()) {
+            return false;
+        }
+
+        m_successorOffsets.clear();
+        m_predecessorCounts.clear();
+        m_successors.clear();
+        m_readyTasks.clear();
+
+        // Count the ready tasks in each priority class, so the ready list can be grouped by class
+        size_t classCounts[kTaskPriority_Count] = {0};
+        for (size_t loop = 0; loop < taskCount; ++loop) {
+            if (0 == tasks[loop].predecessorCount) {
+                assert(tasks[loop].priority < kTaskPriority_Count);
+                classCounts[tasks[loop].priority]++;
+            }
+        }
+
+        size_t readyCount = 0;
+        for (size_t loop = 0; loop < kTaskPriority_Count; ++loop) {
+            m_readyClassOffsets[loop] = readyCount;
+            readyCount += classCounts[loop];
+        }
+
+        m_readyClassOffsets[kTaskPriority_Count] = readyCount;
+        m_readyTasks.resize(readyCount);
+
+        size_t classPositions[kTaskPriority_Count];
+        for (size_t loop = 0; loop < kTaskPriority_Count; ++loop) {
+            classPositions[loop] = m_readyClassOffsets[loop];
+        }
+
+        for (size_t loop = 0; loop < taskCount; ++loop) {
+            const TaskInfo &taskInfo = tasks[loop];
+
+            m_successorOffsets.push_back(static_cast< uint32_t >(m_successors.size()));
+            m_predecessorCounts.push_back(taskInfo.predecessorCount);
+
+            for (uint32_t edge = taskInfo.firstSuccessor; kInvalidTaskId != edge; edge = edges[edge].next) {
+                if (m_successors.size() == m_successors.capacity()) {
+                    return false;
+                }
+
+                m_successors.push_back(edges[edge].successor);
+            }
+
+            if (0 == taskInfo.predecessorCount) {
+                m_readyTasks[classPositions[taskInfo.priority]++] = static_cast< TaskId >(loop);
+            }
+
+            m_arrivals[loop].store(0, std::memory_order_relaxed);
+        }
+
+        m_successorOffsets.push_back(static_cast< uint32_t >(m_successors.size()));
+
+        m_taskCount = taskCount;
+        m_compiled = true;
+        return true;
+    }
+
+
+    //! \brief  Prepares the graph to be replayed, this must be called before any task within the frame is processed.
+    void TaskGraph::beginFrame() {
+        assert(m_compiled);
+        m_frame++;
+    }
+
+    // -----------------------------------------------------------------------------------
+
+} // namespace raize
@@ -18,22 +18,50 @@
 #include "task_processor.h"
 #include "performance_timer.h"
 #include "processor_sync.h"
+#include "profiler.h"
 #include "task_provider.h"
 
 
 // -----------------------------------------------------------------------------------
 
 namespace raize {
+    //! \brief  Describes the work being processed by the calling thread, so tasks it spawns can be attached to it.
+    struct ActiveWork {
+        TaskProvider *taskProvider;     //!< The provider that supplied the work, nullptr if the thread is not processing a task
+        unsigned int contextId;
+        TaskId workId;
+    };
+
+    static thread_local ActiveWork s_activeWork = {nullptr, 0, kInvalidTaskId};
+
+    //! The fiber running upon the calling thread, nullptr if the thread is running on its own stack.
+    static thread_local Fiber *s_currentFiber = nullptr;
+
+    //! The execution context whose tasks are being processed by the calling thread, nullptr outside of processTasks().
+    static thread_local ExecutionContext *s_currentContext = nullptr;
+
+
     // -----------------------------------------------------------------------------------
 
     TaskProcessor::TaskProcessor()
     : m_syncObject(nullptr)
+    , m_fiberProvider(nullptr)
+    , m_fiberWork(kInvalidTaskId)
+    , m_traceFrame(0)
+    , m_statisticsWindow(0)
+    , m_busyNano(0)
+    , m_activeNano(0)
+    , m_tasksTotal(0)
+    , m_activeWork(kRaizeIdleWork)
+    , m_activeTicks(0)
     {
         m_threadCommand = {kThreadCommand_None, nullptr};
 
         m_executionContext.contextId = 0;
         m_executionContext.executionSpeed = 0;
         m_executionContext.tasksProcessed = 0;
+        m_executionContext.frameArena = &m_frameArena;
+        resetThreadPlacement(m_executionContext.placement);
     }
 
     TaskProcessor::~TaskProcessor() {
@@ -49,6 +77,7 @@ namespace raize {
 
         m_syncObject = syncObject;
         m_executionContext = executionContext;
+        m_executionContext.frameArena = &m_frameArena;
 
         m_thread = std::thread(TaskProcessor::threadEntry, this);
 
@@ -56,9 +85,166 @@ namespace raize {
     }
 
 
-    //! \brief  Joins with the thread contained within the TaskProcessor object.
+    //! \brief  Prepares the processor to execute tasks on behalf of the calling thread, no thread is created.
+    //! \param  executionContext [in] -
+    //!         Description of the execution environment the calling thread will be executing in.
+    //! \return <em>True</em> if the processor initialized successfully otherwise <em>false</em>.
+    //!
+    //! Processors initialized by this method do not accept commands, tasks are processed by
+    //! calling processTasks() directly.
+    bool TaskProcessor::initialize(const ExecutionContext &executionContext) {
+        m_syncObject = nullptr;
+        m_executionContext = executionContext;
+        m_executionContext.frameArena = &m_frameArena;
+
+        return true;
+    }
+
+
+    //! \brief  Switches the processor to running each task upon a fiber, so that tasks may wait without blocking the thread.
+    //! \param  fiberCount [in] -
+    //!         The number of fibers available to the processor, which limits the number of tasks that may be waiting at once.
+    //! \param  stackSize [in] -
+    //!         Size (in bytes) of each fibers stack.
+    //! \return <em>True</em> if the fibers were created otherwise <em>false</em> if fibers are not supported.
+    //!
+    //! This must not be called whilst the processor is processing tasks.
+    bool TaskProcessor::initializeFibers(size_t fiberCount, size_t stackSize) {
+        shutdownFibers();
+
+        if (!m_fiberPool.initialize(fiberCount, stackSize)) {
+            return false;
+        }
+
+        m_waitingFibers.reserve(fiberCount);
+        m_waitingWork.reserve(fiberCount);
+        return true;
+    }
+
+
+    //! \brief  Releases the processors fibers, tasks are then run upon the processors own thread.
+    void TaskProcessor::shutdownFibers() {
+        m_waitingWork.clear();
+        m_waitingFibers.clear();
+        m_fiberPool.shutdown();
+    }
+
+
+    //! \brief  Begins recording the start and end time of every piece of work processed by the thread.
+    //! \param  eventCapacity [in] -
+    //!         The number of events held by the processors trace buffer, older events are overwritten once it is full.
+    //! \return <em>True</em> if tracing was enabled otherwise <em>false</em> if tracing was not compiled in, see RAIZE_PROFILER.
+    //!
+    //! This must not be called whilst the processor is processing tasks.
+    bool TaskProcessor::initializeTracing(size_t eventCapacity) {
+        if (!Profiler::kTracing) {
+            return false;
+        }
+
+        return m_traceBuffer.initialize(eventCapacity);
+    }
+
+
+    //! \brief  Stops recording trace events and releases the processors trace buffer.
+    void TaskProcessor::shutdownTracing() {
+        m_traceBuffer.shutdown();
+    }
+
+
+    //! \brief  Allocates the arena the processors tasks take scratch memory from.
+    //! \param  capacity [in] -
+    //!         Size (in bytes) of the arena.
+    //! \param  hugePages [in] -
+    //!         Whether the arena should be backed by huge pages, where the platform supports them.
+    //! \return <em>True</em> if the arena was allocated otherwise <em>false</em>.
+    //!
+    //! This must not be called whilst the processor is processing tasks.
+    bool TaskProcessor::initializeArena(size_t capacity, bool hugePages) {
+        return m_frameArena.initialize(capacity, hugePages);
+    }
+
+
+    //! \brief  Releases the processors arena, tasks are then unable to allocate scratch memory.
+    void TaskProcessor::shutdownArena() {
+        m_frameArena.shutdown();
+    }
+
+
+    //! \brief  Moves the recording of task durations to the next histogram of the rolling window, discarding its contents.
+    //! \param  window [in] -
+    //!         Number of the window about to begin, this must not be called whilst the processor is processing tasks.
+    void TaskProcessor::beginStatisticsWindow(uint32_t window) {
+        m_statisticsWindow = window % kRaizeStatisticsWindows;
+        m_taskDurations[m_statisticsWindow].clear();
+    }
+
+
+    //! \brief  Discards every measurement recorded by the processor, this must not be called whilst the processor is processing tasks.
+    void TaskProcessor::resetStatistics() {
+        for (uint32_t loop = 0; loop < kRaizeStatisticsWindows; ++loop) {
+            m_taskDurations[loop].clear();
+        }
+
+        m_busyNano.store(0, std::memory_order_relaxed);
+        m_activeNano.store(0, std::memory_order_relaxed);
+        m_tasksTotal.store(0, std::memory_order_relaxed);
+    }
+
+
+    //! \brief  Retrieves how the processor has spent its time within frames, may be called from any thread.
+    //! \param  contextStatistics [out] -
+    //!         Receives the measurements, idleNano is not known to the processor and is set to 0.
+    void TaskProcessor::getContextStatistics(ContextStatistics &contextStatistics) const {
+        const uint64_t busyNano = m_busyNano.load(std::memory_order_relaxed);
+        const uint64_t activeNano = m_activeNano.load(std::memory_order_relaxed);
+
+        // Tasks waiting upon a fiber overlap the tasks run meanwhile, so busy time may exceed the frame time
+        contextStatistics.busyNano = busyNano;
+        contextStatistics.waitNano = (activeNano > busyNano) ? activeNano - busyNano : 0;
+        contextStatistics.idleNano = 0;
+        contextStatistics.tasksProcessed = m_tasksTotal.load(std::memory_order_relaxed);
+    }
+
+
+    //! \brief  Retrieves the work the processor is currently executing, may be called from any thread.
+    //! \param  longTask [out] -
+    //!         Receives the work and how long it has been executing, contextId is not known to the processor and is set to 0.
+    //! \return <em>True</em> if the processor is executing work otherwise <em>false</em>.
+    //!
+    //! Work is only published when the profiler measures time, see RAIZE_PROFILER.
+    bool TaskProcessor::getActiveWork(LongTaskReport &longTask) const {
+        const uint64_t activeWork = m_activeWork.load(std::memory_order_acquire);
+        if (kRaizeIdleWork == activeWork) {
+            return false;
+        }
+
+        const uint64_t startTicks = m_activeTicks.load(std::memory_order_relaxed);
+        const uint64_t nowTicks = PerformanceTimer::getTicks();
+
+        // Should the work change whilst we read, the start belongs to newer work and the elapsed time is understated
+        longTask.elapsedNano = (nowTicks > startTicks) ? PerformanceTimer::ticksToNano(nowTicks - startTicks) : 0;
+        longTask.taskId = static_cast< uint32_t >(activeWork);
+        longTask.contextId = 0;
+        longTask.kind = static_cast< uint32_t >(activeWork >> 32);
+        return true;
+    }
+
+
+    //! \brief  Adds the task durations within the processors rolling window to a histogram.
+    //! \param  histogram [in/out] -
+    //!         The histogram receiving the durations.
+    void TaskProcessor::mergeTaskDurations(Histogram &histogram) const {
+        for (uint32_t loop = 0; loop < kRaizeStatisticsWindows; ++loop) {
+            histogram.merge(m_taskDurations[loop]);
+        }
+    }
+
+
+    //! \brief  Joins with the thread contained within the TaskProcessor object, if one was created.
     void TaskProcessor::join() {
-        m_thread.join();
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
     }
 
 
@@ -83,14 +269,19 @@ namespace raize {
 
     //! \brief  Main thread processing function, performs the current queued thread command then waits for the next one. 
     void TaskProcessor::threadExecute() {
-        m_syncObject->notifyReady();
+        // Placement is a request, the thread runs wherever the operating system chooses if it fails
+        applyThreadPlacement(m_executionContext.placement);
+
+        // Threads started between frames must not mistake the previous command for a new one
+        uint64_t executeGeneration = m_syncObject->getGeneration();
 
+        m_syncObject->notifyReady();
         while (kThreadCommand_Exit != m_threadCommand.id) {
-            m_syncObject->waitExecute();
+            executeGeneration = m_syncObject->waitExecute(executeGeneration);
 
             switch (m_threadCommand.id) {
                 case kThreadCommand_None:
-                    // Should never get here
+                    // Woken by a command issued to other workers, such as those exiting when the scheduler shrinks
                     break;
 
                 case kThreadCommand_Execute:
@@ -110,38 +301,111 @@ namespace raize {
     }
 
 
-    //! \brief  Processes as many tasks as the task provider instance can supply us with.
+    //! \brief  Processes the task list supplied with the current thread command, then informs the command issuer.
     void TaskProcessor::executeTaskList() {
-        const PerformanceTimer timer;
+        assert(nullptr != m_threadCommand.taskProvider);
+        processTasks(m_threadCommand.taskProvider);
+
+        m_threadCommand.id = kThreadCommand_None;
+        m_threadCommand.taskProvider = nullptr;
+
+        m_syncObject->notifyComplete();     // Notify command issuer we have completed.
+    }
+
+
+    //! \brief  Processes as many tasks as the task provider instance can supply us with, on the calling thread.
+    //! \param  taskProvider [in] -
+    //!         The provider that supplies the tasks to be processed.
+    //!
+    //! This method returns once every task within the current frame has completed.
+    void TaskProcessor::processTasks(TaskProvider *taskProvider) {
+        processTasks(taskProvider, true);
+    }
+
+
+    //! \brief  Processes tasks supplied by the task provider on the calling thread, optionally leaving the end of the frame to other threads.
+    //! \param  taskProvider [in] -
+    //!         The provider that supplies the tasks to be processed.
+    //! \param  untilComplete [in] -
+    //!         <em>True</em> to return once every task within the frame has completed, otherwise <em>false</em> to return as
+    //!         soon as no task is ready, whilst tasks running upon other threads may still release further work.
+    //!
+    //! A thread that returns early never has work left behind for it. The successors, chunks and
+    //! spawned tasks it produces are processed before it finds nothing ready, and any fiber it
+    //! suspended is resumed before it returns.
+    void TaskProcessor::processTasks(TaskProvider *taskProvider, bool untilComplete) {
+        assert(nullptr != taskProvider);
+
+        const uint64_t startTicks = Profiler::getTicks();
 
         m_executionContext.tasksProcessed = 0;
 
-        assert(nullptr != m_threadCommand.taskProvider);
-        while (executeTask(m_threadCommand.taskProvider->nextTask())) {
-            m_executionContext.tasksProcessed++;
+        ExecutionContext *previousContext = s_currentContext;
+        s_currentContext = &m_executionContext;
+
+        if (m_fiberPool.isInitialized()) {
+            processFiberTasks(taskProvider, untilComplete);
+        } else {
+            processThreadTasks(taskProvider, untilComplete);
         }
 
-        m_executionContext.executionSpeed = timer.getElapsedTimeMilli();
+        s_currentContext = previousContext;
 
-        m_threadCommand.id = kThreadCommand_None;
-        m_threadCommand.taskProvider = nullptr;
+        if (Profiler::kTiming) {
+            const uint64_t elapsedNano = Profiler::getElapsedNano(startTicks);
 
-        m_syncObject->notifyComplete();     // Notify command issuer we have completed.
+            m_executionContext.executionSpeed = elapsedNano / 1000000;
+            m_activeNano.store(m_activeNano.load(std::memory_order_relaxed) + elapsedNano, std::memory_order_relaxed);
+        }
+    }
+
+
+    //! \brief  Processes tasks upon the calling threads own stack.
+    //! \param  taskProvider [in] -
+    //!         The provider that supplies the tasks to be processed.
+    //! \param  untilComplete [in] -
+    //!         Whether to wait for tasks running upon other threads, rather than returning once no task is ready.
+    void TaskProcessor::processThreadTasks(TaskProvider *taskProvider, bool untilComplete) {
+        const unsigned int contextId = m_executionContext.contextId;
+
+        // Claimed ranges are walked locally, the provider is only consulted once the range is exhausted
+        TaskRange range = {0, 0};
+        TaskId taskId;
+        while (kInvalidTaskId != (taskId = untilComplete ? taskProvider->acquireTask(contextId, range) : taskProvider->pollTask(contextId, range))) {
+            if (taskProvider->isRangeWork(taskId)) {
+                executeChunk(taskProvider, taskId);
+            } else {
+                executeWork(taskProvider, taskId);
+                taskProvider->completeTask(m_executionContext.contextId, taskId);
+            }
+
+            m_executionContext.tasksProcessed++;
+        }
     }
 
 
     //! \brief  Performs a single tasks operation within our thread.
     //! \param  taskInfo [in] -
     //!         Description of the task to be executed, if this parameter is <em>nullptr</em> this method will fail.
+    //! \param  startTicks [in] -
+    //!         When the task began, as returned by Profiler::getTicks().
+    //! \param  elapsedNano [out] -
+    //!         Receives the time (in nanoseconds) taken to execute the task, or 0 if the profiler does not measure tasks.
     //! \return <em>True</em> if the task was processed successfully otherwise <em>false</em>
-    bool TaskProcessor::executeTask(TaskInfo *taskInfo) {
-        if (nullptr != taskInfo) {
-            // TODO: This is where we prepare the tasks parameters for use, before sending them along with the execute() call below.
+    bool TaskProcessor::executeTask(TaskInfo *taskInfo, uint64_t startTicks, uint64_t &elapsedNano) {
+        elapsedNano = 0;
 
-            const PerformanceTimer timer;
+        if (nullptr != taskInfo) {
+            if (nullptr != taskInfo->invoke) {
+                taskInfo->invoke(taskInfo->payload.data);
+            } else {
+                taskInfo->execute();
+            }
 
-            taskInfo->execute();
-            taskInfo->executionSpeed = timer.getElapsedTimeMilli();
+            if (Profiler::kTiming) {
+                elapsedNano = Profiler::getElapsedNano(startTicks);
+                recordTask(elapsedNano);
+            }
 
             return true;
         }
@@ -150,6 +414,290 @@ namespace raize {
     }
 
 
+    //! \brief  Processes a chunk of a range task, splitting it for other threads to share where possible.
+    //! \param  taskProvider [in] -
+    //!         The provider that supplied the chunk.
+    //! \param  workId [in] -
+    //!         Identifier of the work returned by the task provider.
+    void TaskProcessor::executeChunk(TaskProvider *taskProvider, TaskId workId) {
+        const unsigned int contextId = m_executionContext.contextId;
+
+        // Keep the lower half of the range, the upper halves may be stolen by idle threads
+        TaskChunk chunk = taskProvider->acquireChunk(contextId, workId);
+        while (taskProvider->splitChunk(contextId, chunk)) {
+        }
+
+        // The chunk is always timed, as the measurement adapts the grain size of the range
+        const PerformanceTimer timer;
+
+        const bool tracing = Profiler::kTracing && m_traceBuffer.isInitialized();
+        const uint64_t beginNano = tracing ? PerformanceTimer::getTimeNano() : 0;
+
+        if (chunk.begin != chunk.end) {
+            // Tasks spawned by the chunk belong to the range task, which completes once they have finished
+            const ActiveWork previousWork = s_activeWork;
+            s_activeWork = {taskProvider, contextId, chunk.task};
+
+            if (Profiler::kTiming) {
+                beginWork(chunk.task, kTraceEvent_Chunk, Profiler::getTicks());
+            }
+
+            taskProvider->getRangeFunction(chunk.task)(chunk.begin, chunk.end);
+
+            if (Profiler::kTiming) {
+                endWork();
+            }
+
+            s_activeWork = previousWork;
+        }
+
+        if (tracing) {
+            const TraceEvent traceEvent = {beginNano, PerformanceTimer::getTimeNano(), chunk.task, contextId, m_traceFrame, kTraceEvent_Chunk};
+            m_traceBuffer.record(traceEvent);
+        }
+
+        const uint64_t elapsedNano = timer.getElapsedTimeNano();
+
+        if (Profiler::kTiming) {
+            recordTask(elapsedNano);
+        }
+
+        taskProvider->completeChunk(contextId, chunk, elapsedNano);
+    }
+
+
+    //! \brief  Executes a registered or spawned task, recording it as the parent of any tasks it spawns.
+    //! \param  taskProvider [in] -
+    //!         The provider that supplied the task.
+    //! \param  workId [in] -
+    //!         Identifier of the work returned by the task provider.
+    void TaskProcessor::executeWork(TaskProvider *taskProvider, TaskId workId) {
+        const bool spawned = taskProvider->isSpawnedWork(workId);
+        TaskInfo *taskInfo = spawned ? taskProvider->getSpawnedTask(workId) : taskProvider->getTask(workId);
+
+        const ActiveWork previousWork = s_activeWork;
+        s_activeWork = {taskProvider, m_executionContext.contextId, workId};
+
+        // Without a timing profiler only the call through the function pointer remains
+        const uint64_t startTicks = Profiler::getTicks();
+
+        if (Profiler::kTiming) {
+            beginWork(taskProvider->getRegisteredTask(workId), spawned ? kTraceEvent_Spawned : kTraceEvent_Task, startTicks);
+        }
+
+        uint64_t elapsedNano;
+        if (Profiler::kTracing && m_traceBuffer.isInitialized()) {
+            // A task waiting upon a fiber is recorded from when it started until it finally completed
+            const uint64_t beginNano = PerformanceTimer::getTimeNano();
+
+            executeTask(taskInfo, startTicks, elapsedNano);
+
+            const TraceEvent traceEvent = {beginNano, PerformanceTimer::getTimeNano(), workId, m_executionContext.contextId, m_traceFrame, static_cast< uint32_t >(spawned ? kTraceEvent_Spawned : kTraceEvent_Task)};
+            m_traceBuffer.record(traceEvent);
+        } else {
+            executeTask(taskInfo, startTicks, elapsedNano);
+        }
+
+        // A task suspended upon a fiber is not executing, so the work is not restored when another task ends
+        if (Profiler::kTiming) {
+            endWork();
+        }
+
+        // Spawned tasks only exist for the current frame, so only registered tasks keep their duration
+        if (Profiler::kTiming && !spawned) {
+            taskProvider->recordDuration(m_executionContext.contextId, workId, elapsedNano);
+        }
+
+        s_activeWork = previousWork;
+    }
+
+
+    //! \brief  Processes tasks upon fibers, resuming waiting fibers as the counters they wait upon reach zero.
+    //! \param  taskProvider [in] -
+    //!         The provider that supplies the tasks to be processed.
+    //!
+    //! Range chunks are still processed upon the thread, as they cannot wait.
+    void TaskProcessor::processFiberTasks(TaskProvider *taskProvider, bool untilComplete) {
+        const unsigned int contextId = m_executionContext.contextId;
+
+        TaskRange range = {0, 0};
+        for (;;) {
+            if (!m_waitingFibers.empty()) {
+                resumeFibers(taskProvider);
+            }
+
+            const TaskId taskId = taskProvider->pollTask(contextId, range);
+            if (kInvalidTaskId != taskId) {
+                if (taskProvider->isRangeWork(taskId)) {
+                    executeChunk(taskProvider, taskId);
+                } else {
+                    executeFiber(taskProvider, taskId);
+                }
+
+                m_executionContext.tasksProcessed++;
+            } else if (m_waitingFibers.empty() && (!untilComplete || !taskProvider->hasRemainingTasks())) {
+                break;
+            } else {
+                // Nothing is ready, but our waiting fibers or other contexts tasks may still produce work
+                std::this_thread::yield();
+            }
+        }
+    }
+
+
+    //! \brief  Starts a task upon an idle fiber.
+    //! \param  taskProvider [in] -
+    //!         The provider that supplied the task.
+    //! \param  workId [in] -
+    //!         Identifier of the work returned by the task provider.
+    //!
+    //! Should every fiber be waiting, the task is run upon the thread and is unable to wait without blocking.
+    void TaskProcessor::executeFiber(TaskProvider *taskProvider, TaskId workId) {
+        Fiber *fiber = m_fiberPool.acquire();
+        if (nullptr == fiber) {
+            executeWork(taskProvider, workId);
+            taskProvider->completeTask(m_executionContext.contextId, workId);
+            return;
+        }
+
+        m_fiberProvider = taskProvider;
+        m_fiberWork = workId;
+
+        switchToFiber(taskProvider, fiber, workId);
+    }
+
+
+    //! \brief  Runs a fiber until its task completes or it waits, completing the task or recording the fiber as waiting.
+    //! \param  taskProvider [in] -
+    //!         The provider that supplied the task.
+    //! \param  fiber [in] -
+    //!         The fiber to be run, which is started if it is idle otherwise resumed.
+    //! \param  workId [in] -
+    //!         Identifier of the work being processed by the fiber.
+    void TaskProcessor::switchToFiber(TaskProvider *taskProvider, Fiber *fiber, TaskId workId) {
+        const ActiveWork threadWork = s_activeWork;
+        s_currentFiber = fiber;
+
+        if (fiber->finished) {
+            m_fiberPool.start(fiber, &TaskProcessor::fiberExecute, this);
+        } else {
+            m_fiberPool.resume(fiber);
+        }
+
+        s_currentFiber = nullptr;
+        s_activeWork = threadWork;
+
+        if (!fiber->finished) {
+            m_waitingFibers.push_back(fiber);
+            m_waitingWork.push_back(workId);
+            return;
+        }
+
+        m_fiberPool.release(fiber);
+        taskProvider->completeTask(m_executionContext.contextId, workId);
+    }
+
+
+    //! \brief  Resumes every waiting fiber whose counter has reached zero.
+    //! \param  taskProvider [in] -
+    //!         The provider that supplied the tasks being processed by the fibers.
+    void TaskProcessor::resumeFibers(TaskProvider *taskProvider) {
+        size_t loop = 0;
+        while (loop < m_waitingFibers.size()) {
+            Fiber *fiber = m_waitingFibers[loop];
+            if (0 != fiber->waitCounter->load(std::memory_order_acquire)) {
+                ++loop;
+                continue;
+            }
+
+            const TaskId workId = m_waitingWork[loop];
+
+            m_waitingFibers[loop] = m_waitingFibers.back();
+            m_waitingFibers.pop_back();
+            m_waitingWork[loop] = m_waitingWork.back();
+            m_waitingWork.pop_back();
+
+            fiber->waitCounter = nullptr;
+            switchToFiber(taskProvider, fiber, workId);
+        }
+    }
+
+
+    //! \brief  Entry point of a task started upon a fiber.
+    //! \param  argument [in] -
+    //!         Pointer to the TaskProcessor that started the fiber.
+    void TaskProcessor::fiberExecute(void *argument) {
+        TaskProcessor *self = static_cast< TaskProcessor* >(argument);
+        self->executeWork(self->m_fiberProvider, self->m_fiberWork);
+    }
+
+
+    //! \brief  Waits until a counter reaches zero, from within the task being executed by the calling thread.
+    //! \param  counter [in] -
+    //!         The counter to wait upon, typically decremented by tasks spawned by the caller.
+    //!
+    //! When the task is running upon a fiber, the fiber is suspended and the thread continues
+    //! to process other tasks until the counter reaches zero. Otherwise the thread yields until
+    //! the counter reaches zero, which relies upon other threads processing the outstanding work.
+    void TaskProcessor::waitForCounter(const std::atomic<uint32_t> &counter) {
+        Fiber *fiber = s_currentFiber;
+        if (nullptr == fiber) {
+            while (0 != counter.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+
+            return;
+        }
+
+        // The thread runs other tasks whilst we are suspended, each of which replaces the active work
+        const ActiveWork activeWork = s_activeWork;
+
+        while (0 != counter.load(std::memory_order_acquire)) {
+            fiber->waitCounter = &counter;
+            FiberPool::suspend(fiber);
+        }
+
+        s_activeWork = activeWork;
+    }
+
+
+    //! \brief  Spawns a task from within the task being executed by the calling thread.
+    //! \param  executeFunc [in] -
+    //!         The function that implements the processing necessary for the task.
+    //! \return <em>True</em> if the task was spawned otherwise <em>false</em> if the calling thread is not executing a task or no storage remains.
+    bool TaskProcessor::spawnTask(TaskExecuteFunction executeFunc) {
+        if (nullptr == s_activeWork.taskProvider) {
+            return false;
+        }
+
+        return s_activeWork.taskProvider->spawnTask(s_activeWork.contextId, s_activeWork.workId, executeFunc);
+    }
+
+
+    //! \brief  Spawns a task from within the task being executed by the calling thread.
+    //! \param  invokeFunc [in] -
+    //!         The function called with a pointer to the tasks copy of the payload.
+    //! \param  payload [in] -
+    //!         The data to be copied into the task, may be <em>nullptr</em> if payloadSize is 0.
+    //! \param  payloadSize [in] -
+    //!         Size (in bytes) of the payload, this must not exceed kRaizeTaskPayloadSize.
+    //! \return <em>True</em> if the task was spawned otherwise <em>false</em> if the calling thread is not executing a task or no storage remains.
+    bool TaskProcessor::spawnTask(TaskPayloadFunction invokeFunc, const void *payload, size_t payloadSize) {
+        if (nullptr == s_activeWork.taskProvider) {
+            return false;
+        }
+
+        return s_activeWork.taskProvider->spawnTask(s_activeWork.contextId, s_activeWork.workId, invokeFunc, payload, payloadSize);
+    }
+
+
+    //! \brief  Retrieves the execution context processing tasks upon the calling thread.
+    //! \return The execution context, or <em>nullptr</em> if the calling thread is not processing tasks.
+    ExecutionContext *TaskProcessor::getCurrentContext() {
+        return s_currentContext;
+    }
+
+
     // -----------------------------------------------------------------------------------
 
 } // namespace raize
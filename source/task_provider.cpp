@@ -14,18 +14,61 @@
 // limitations under the License.
 //
 
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <thread>
 #include "task_provider.h"
+#include "profiler.h"
 
 
 // -----------------------------------------------------------------------------------
 
 namespace raize {
+    //! When the number of dependencies is not specified, we reserve enough storage for each
+    //! task to be depended upon this many times.
+    static const size_t kRaizeDefaultDependenciesPerTask = 4;
+
+    //! We reserve enough storage for each task to declare this many resource accesses.
+    static const size_t kRaizeDefaultAccessesPerTask = 4;
+
+    //! Number of range chunks each execution context may create within a single frame.
+    static const uint32_t kRaizeChunksPerContext = 1024;
+
+    //! Number of tasks each execution context may spawn within a single frame.
+    static const uint32_t kRaizeSpawnsPerContext = 1024;
+
+    //! The duration (in nanoseconds) we aim for each range chunk to take, when adapting the grain size.
+    static const uint64_t kRaizeTargetChunkDuration = 50000;
+
+    //! Every time a context has popped this many tasks from its own queues, the next task is
+    //! taken from its lowest priority non-empty queue so that low priority tasks keep moving.
+    static const uint32_t kRaizePriorityAgingInterval = 8;
+
+
+    // -----------------------------------------------------------------------------------
+
+    const uint32_t TaskProvider::kChunkFlag;
+    const uint32_t TaskProvider::kSpawnFlag;
+    const uint32_t TaskProvider::kJoinFinished;
+
+
     // -----------------------------------------------------------------------------------
 
     TaskProvider::TaskProvider()
-    : m_nextTask(0)
+    : m_claimMode(kTaskClaimMode_WorkStealing)
+    , m_minimumBatchSize(1)
+    , m_queueCount(0)
+    , m_contextCount(0)
+    , m_timings(nullptr)
+    , m_timingStride(0)
+    , m_taskCapacity(0)
+    , m_taskCount(0)
+    , m_processing(false)
     {
-        m_taskAcquire.store(0);
+        m_nextTask.store(0);
+        m_remainingTasks.store(0);
+        m_reservedTasks.store(0);
     }
 
     TaskProvider::~TaskProvider() {
@@ -37,19 +80,132 @@ namespace raize {
     //!         The maximum number of tasks that may be contained within the provider at one time.
     //! \return <em>True</em> if the provider initialized successfully otherwise <em>false</em>.
     bool TaskProvider::initialize(size_t taskCapacity) {
-        if (taskCapacity > 0) {
-            m_tasks.reserve(taskCapacity);
+        return initialize(taskCapacity, 1);
+    }
+
+
+    //! \brief  Prepares the task provider for use by the running application.
+    //! \param  taskCapacity [in] -
+    //!         The maximum number of tasks that may be contained within the provider at one time.
+    //! \param  queueCount [in] -
+    //!         The number of execution contexts that will request tasks from the provider, each context receives its own queue.
+    //! \return <em>True</em> if the provider initialized successfully otherwise <em>false</em>.
+    bool TaskProvider::initialize(size_t taskCapacity, size_t queueCount) {
+        return initialize(taskCapacity, queueCount, taskCapacity * kRaizeDefaultDependenciesPerTask);
+    }
+
+
+    //! \brief  Prepares the task provider for use by the running application.
+    //! \param  taskCapacity [in] -
+    //!         The maximum number of tasks that may be contained within the provider at one time.
+    //! \param  queueCount [in] -
+    //!         The number of execution contexts that will request tasks from the provider, each context receives its own queue.
+    //! \param  dependencyCapacity [in] -
+    //!         The maximum number of dependencies that may be declared between all tasks within the provider.
+    //! \return <em>True</em> if the provider initialized successfully otherwise <em>false</em>.
+    bool TaskProvider::initialize(size_t taskCapacity, size_t queueCount, size_t dependencyCapacity) {
+        if (taskCapacity > 0 && queueCount > 0 && taskCapacity < kSpawnFlag) {
+            m_ranges.reserve(taskCapacity);
+            m_edges.reserve(dependencyCapacity);
+            m_newDependencies.reserve(taskCapacity);
+            m_accesses.reserve(taskCapacity * kRaizeDefaultAccessesPerTask);
+            m_accessRanges.reserve(taskCapacity);
+
+            if (!m_graph.initialize(taskCapacity, dependencyCapacity)) {
+                return false;
+            }
+
+            m_tasks.reset(new TaskInfo[taskCapacity]);
+            m_publishedTasks.reset(new std::atomic<bool>[taskCapacity]);
+            for (size_t loop = 0; loop < taskCapacity; ++loop) {
+                m_publishedTasks[loop].store(false, std::memory_order_relaxed);
+            }
+
+            m_rangeStates.reset(new RangeState[taskCapacity]);
+            m_contextStates.reset(new ContextState[queueCount]);
+            m_contextPriorities.reset(new ContextPriorities[queueCount]);
+            m_chunks.reset(new TaskChunk[queueCount * kRaizeChunksPerContext]);
+            m_spawns.reset(new SpawnedTask[queueCount * kRaizeSpawnsPerContext]);
+
+            m_joinCounts.reset(new std::atomic<uint32_t>[taskCapacity]);
+            for (size_t loop = 0; loop < taskCapacity; ++loop) {
+                m_joinCounts[loop].store(0, std::memory_order_relaxed);
+            }
+
+            m_taskDurations.reset(new uint64_t[taskCapacity]);
+            for (size_t loop = 0; loop < taskCapacity; ++loop) {
+                m_taskDurations[loop] = 0;
+            }
+
+            // A context may execute every task, each block is rounded to whole cache lines and aligned
+            const size_t timingsPerLine = RAIZE_CACHE_LINE_SIZE / sizeof(TaskTiming);
+            const size_t timingCount = queueCount * ((taskCapacity + timingsPerLine - 1) / timingsPerLine) * timingsPerLine;
+
+            m_timingStorage.reset(new TaskTiming[timingCount + timingsPerLine]);
+
+            void *timings = m_timingStorage.get();
+            size_t space = (timingCount + timingsPerLine) * sizeof(TaskTiming);
+
+            m_timings = static_cast< TaskTiming* >(std::align(RAIZE_CACHE_LINE_SIZE, timingCount * sizeof(TaskTiming), timings, space));
+            m_timingStride = timingCount / queueCount;
+
+            // Every queue must be able to hold the entire task list, as tasks are not guaranteed to be evenly distributed
+            m_queues.reset(new TaskQueue[queueCount * kTaskPriority_Count]);
+            for (size_t loop = 0; loop < queueCount * kTaskPriority_Count; ++loop) {
+                if (!m_queues[loop].initialize(taskCapacity + kRaizeChunksPerContext + kRaizeSpawnsPerContext, static_cast< uint32_t >(loop + 1))) {
+                    m_queues.reset();
+                    return false;
+                }
+            }
+
+            for (size_t loop = 0; loop < queueCount; ++loop) {
+                m_contextStates[loop].chunkCount = 0;
+                m_contextStates[loop].popCount = 0;
+                m_contextStates[loop].spawnCount = 0;
+                m_contextStates[loop].timingCount = 0;
+                resetContextPriorities(static_cast< unsigned int >(loop));
+            }
+
+            m_queueCount = queueCount;
+            m_contextCount = queueCount;
+            m_taskCapacity = taskCapacity;
+            m_taskCount = 0;
+            m_reservedTasks.store(0, std::memory_order_relaxed);
+            resetPriorityStatistics();
             return true;
         }
 
         return false;
     }
 
-    //! \brief  
+    //! \brief  Releases all tasks and queues contained within the provider.
     void TaskProvider::shutdown() {
-        m_nextTask = 0;
+        m_queues.reset();
+        m_queueCount = 0;
+        m_contextCount = 0;
+
+        m_joinCounts.reset();
+        m_taskDurations.reset();
+        m_timingStorage.reset();
+        m_timings = nullptr;
+        m_timingStride = 0;
+        m_spawns.reset();
+        m_chunks.reset();
+        m_contextStates.reset();
+        m_contextPriorities.reset();
+        m_rangeStates.reset();
+        m_ranges.clear();
 
-        m_tasks.clear();
+        m_graph.shutdown();
+        m_accessRanges.clear();
+        m_accesses.clear();
+        m_edges.clear();
+        m_tasks.reset();
+        m_publishedTasks.reset();
+        m_taskCapacity = 0;
+        m_taskCount = 0;
+        m_reservedTasks.store(0, std::memory_order_relaxed);
+        m_processing = false;
     }
 
 
@@ -58,54 +214,1275 @@ namespace raize {
     //!         The function that implements the processing necessary for the task.
     //! \return <em>True</em> if the task was added sucessfully otherwise <em>false</em>.
     bool TaskProvider::addTask(TaskExecuteFunction executeFunc) {
-        if (m_tasks.size() < m_tasks.capacity()) {
-            TaskInfo taskInfo;
+        return addTask(executeFunc, nullptr, 0, nullptr);
+    }
 
-            taskInfo.executionSpeed = 0;
-            taskInfo.execute = executeFunc;
 
-            m_tasks.push_back(taskInfo);
+    //! \brief  Adds a new task belonging to the specified priority class.
+    //! \param  executeFunc [in] -
+    //!         The function that implements the processing necessary for the task.
+    //! \param  priority [in] -
+    //!         The priority class the task will belong to.
+    //! \param  taskId [out] -
+    //!         Receives the identifier of the new task, may be <em>nullptr</em> if the identifier is not required.
+    //! \return <em>True</em> if the task was added sucessfully otherwise <em>false</em> if the priority is invalid or the task list is full.
+    bool TaskProvider::addTask(TaskExecuteFunction executeFunc, kTaskPriority priority, TaskId *taskId) {
+        if (priority >= kTaskPriority_Count) {
+            return false;
+        }
 
-            return true;
+        TaskInfo taskInfo;
+
+        taskInfo.execute = executeFunc;
+        taskInfo.invoke = nullptr;
+        taskInfo.rangeIndex = kInvalidTaskId;
+        taskInfo.priority = priority;
+
+        return insertTask(taskInfo, nullptr, 0, nullptr, 0, taskId);
+    }
+
+
+    //! \brief  Adds a new task to the provider that will not begin until all the specified tasks have completed.
+    //! \param  executeFunc [in] -
+    //!         The function that implements the processing necessary for the task.
+    //! \param  dependencies [in] -
+    //!         Identifiers of previously added tasks that must complete before this task may begin, may be <em>nullptr</em> if dependencyCount is 0.
+    //! \param  dependencyCount [in] -
+    //!         The number of entries within the dependencies array.
+    //! \param  taskId [out] -
+    //!         Receives the identifier of the new task, may be <em>nullptr</em> if the identifier is not required.
+    //! \return <em>True</em> if the task was added sucessfully otherwise <em>false</em>.
+    //!
+    //! As a task may only depend upon tasks that already exist, the dependencies can never form a cycle.
+    bool TaskProvider::addTask(TaskExecuteFunction executeFunc, const TaskId *dependencies, size_t dependencyCount, TaskId *taskId) {
+        return addTask(executeFunc, dependencies, dependencyCount, nullptr, 0, taskId);
+    }
+
+
+    //! \brief  Adds a new task to the provider, ordered against other tasks by its dependencies and the resources it uses.
+    //! \param  executeFunc [in] -
+    //!         The function that implements the processing necessary for the task.
+    //! \param  dependencies [in] -
+    //!         Identifiers of previously added tasks that must complete before this task may begin, may be <em>nullptr</em> if dependencyCount is 0.
+    //! \param  dependencyCount [in] -
+    //!         The number of entries within the dependencies array.
+    //! \param  accesses [in] -
+    //!         The resources read or written by the task, may be <em>nullptr</em> if accessCount is 0.
+    //! \param  accessCount [in] -
+    //!         The number of entries within the accesses array.
+    //! \param  taskId [out] -
+    //!         Receives the identifier of the new task, may be <em>nullptr</em> if the identifier is not required.
+    //! \return <em>True</em> if the task was added sucessfully otherwise <em>false</em>.
+    //!
+    //! Resource accesses are resolved against every task added before this one, so this method
+    //! becomes more expensive as the task list grows. Tasks are expected to be added once and
+    //! executed many times, so the cost is not paid per frame.
+    bool TaskProvider::addTask(TaskExecuteFunction executeFunc, const TaskId *dependencies, size_t dependencyCount, const ResourceAccess *accesses, size_t accessCount, TaskId *taskId) {
+        TaskInfo taskInfo;
+
+        taskInfo.execute = executeFunc;
+        taskInfo.invoke = nullptr;
+        taskInfo.rangeIndex = kInvalidTaskId;
+        taskInfo.priority = kTaskPriority_Normal;
+
+        return insertTask(taskInfo, dependencies, dependencyCount, accesses, accessCount, taskId);
+    }
+
+
+    //! \brief  Adds a new task belonging to the specified priority class, whose function receives a copy of the supplied payload.
+    //! \param  invokeFunc [in] -
+    //!         The function that implements the processing necessary for the task.
+    //! \param  payload [in] -
+    //!         The data passed to the function, may be <em>nullptr</em> if payloadSize is 0.
+    //! \param  payloadSize [in] -
+    //!         Size (in bytes) of the payload, this must not exceed kRaizeTaskPayloadSize.
+    //! \param  priority [in] -
+    //!         The priority class the task will belong to.
+    //! \param  taskId [out] -
+    //!         Receives the identifier of the new task, may be <em>nullptr</em> if the identifier is not required.
+    //! \return <em>True</em> if the task was added sucessfully otherwise <em>false</em> if the payload or priority is invalid, or the task list is full.
+    bool TaskProvider::addTask(TaskPayloadFunction invokeFunc, const void *payload, size_t payloadSize, kTaskPriority priority, TaskId *taskId) {
+        if (nullptr == invokeFunc || payloadSize > kRaizeTaskPayloadSize || (nullptr == payload && 0 != payloadSize) || priority >= kTaskPriority_Count) {
+            return false;
+        }
+
+        TaskInfo taskInfo;
+
+        taskInfo.execute = nullptr;
+        taskInfo.invoke = invokeFunc;
+        taskInfo.rangeIndex = kInvalidTaskId;
+        taskInfo.priority = priority;
+
+        if (0 != payloadSize) {
+            memcpy(taskInfo.payload.data, payload, payloadSize);
+        }
+
+        return insertTask(taskInfo, nullptr, 0, nullptr, 0, taskId);
+    }
+
+
+    //! \brief  Adds a new task whose function receives a copy of the supplied payload.
+    //! \param  invokeFunc [in] -
+    //!         The function that implements the processing necessary for the task.
+    //! \param  payload [in] -
+    //!         The data passed to the function, may be <em>nullptr</em> if payloadSize is 0.
+    //! \param  payloadSize [in] -
+    //!         Size (in bytes) of the payload, this must not exceed kRaizeTaskPayloadSize.
+    //! \param  dependencies [in] -
+    //!         Identifiers of previously added tasks that must complete before this task may begin, may be <em>nullptr</em> if dependencyCount is 0.
+    //! \param  dependencyCount [in] -
+    //!         The number of entries within the dependencies array.
+    //! \param  accesses [in] -
+    //!         The resources read or written by the task, may be <em>nullptr</em> if accessCount is 0.
+    //! \param  accessCount [in] -
+    //!         The number of entries within the accesses array.
+    //! \param  taskId [out] -
+    //!         Receives the identifier of the new task, may be <em>nullptr</em> if the identifier is not required.
+    //! \return <em>True</em> if the task was added sucessfully otherwise <em>false</em>.
+    //!
+    //! The payload is copied into storage held by the task, no memory is allocated. As the copy
+    //! is never destroyed, the payload must be trivially copyable.
+    bool TaskProvider::addTask(TaskPayloadFunction invokeFunc, const void *payload, size_t payloadSize, const TaskId *dependencies, size_t dependencyCount, const ResourceAccess *accesses, size_t accessCount, TaskId *taskId) {
+        if (nullptr == invokeFunc || payloadSize > kRaizeTaskPayloadSize || (nullptr == payload && 0 != payloadSize)) {
+            return false;
+        }
+
+        TaskInfo taskInfo;
+
+        taskInfo.execute = nullptr;
+        taskInfo.invoke = invokeFunc;
+        taskInfo.rangeIndex = kInvalidTaskId;
+        taskInfo.priority = kTaskPriority_Normal;
+
+        if (0 != payloadSize) {
+            memcpy(taskInfo.payload.data, payload, payloadSize);
+        }
+
+        return insertTask(taskInfo, dependencies, dependencyCount, accesses, accessCount, taskId);
+    }
+
+
+    //! \brief  Adds a new task that processes a range of indices, split between the execution contexts as it is processed.
+    //! \param  executeFunc [in] -
+    //!         The function called to process each chunk of the range.
+    //! \param  begin [in] -
+    //!         The first index within the range.
+    //! \param  end [in] -
+    //!         Index one past the final entry within the range.
+    //! \param  grainSize [in] -
+    //!         The smallest number of indices that will be supplied to a single call of executeFunc.
+    //! \param  dependencies [in] -
+    //!         Identifiers of previously added tasks that must complete before the range may begin, may be <em>nullptr</em> if dependencyCount is 0.
+    //! \param  dependencyCount [in] -
+    //!         The number of entries within the dependencies array.
+    //! \param  taskId [out] -
+    //!         Receives the identifier of the new task, may be <em>nullptr</em> if the identifier is not required.
+    //! \return <em>True</em> if the task was added sucessfully otherwise <em>false</em>.
+    //!
+    //! The grain size is increased automatically once the time taken to process each index is
+    //! known, so that each chunk is large enough to outweigh the cost of distributing it.
+    bool TaskProvider::addRangeTask(RangeExecuteFunction executeFunc, size_t begin, size_t end, size_t grainSize, const TaskId *dependencies, size_t dependencyCount, TaskId *taskId) {
+        if (nullptr == executeFunc || begin > end || m_ranges.size() >= m_ranges.capacity()) {
+            return false;
+        }
+
+        TaskInfo taskInfo;
+
+        taskInfo.execute = nullptr;
+        taskInfo.invoke = nullptr;
+        taskInfo.rangeIndex = static_cast< uint32_t >(m_ranges.size());
+        taskInfo.priority = kTaskPriority_Normal;
+
+        if (!insertTask(taskInfo, dependencies, dependencyCount, nullptr, 0, taskId)) {
+            return false;
+        }
+
+        RangeInfo rangeInfo;
+
+        rangeInfo.execute = executeFunc;
+        rangeInfo.begin = begin;
+        rangeInfo.end = end;
+        rangeInfo.minimumGrainSize = (0 != grainSize) ? grainSize : 1;
+        rangeInfo.grainSize = rangeInfo.minimumGrainSize;
+
+        m_ranges.push_back(rangeInfo);
+        return true;
+    }
+
+
+    //! \brief  Adds a task to the task list, linking it to the tasks it depends upon.
+    //! \param  taskInfo [in] -
+    //!         Description of the task, the dependency related members are filled in by this method.
+    //! \param  dependencies [in] -
+    //!         Identifiers of previously added tasks that must complete before this task may begin.
+    //! \param  dependencyCount [in] -
+    //!         The number of entries within the dependencies array.
+    //! \param  accesses [in] -
+    //!         The resources read or written by the task.
+    //! \param  accessCount [in] -
+    //!         The number of entries within the accesses array.
+    //! \param  taskId [out] -
+    //!         Receives the identifier of the new task, may be <em>nullptr</em> if the identifier is not required.
+    //! \return <em>True</em> if the task was added sucessfully otherwise <em>false</em>.
+    //!
+    //! Tasks submitted by other threads are collected first, a task may depend upon any of them
+    //! once its identifier is known. The new task receives the next slot within the task table,
+    //! so we wait for any slot reserved before it to be published.
+    bool TaskProvider::insertTask(TaskInfo &taskInfo, const TaskId *dependencies, size_t dependencyCount, const ResourceAccess *accesses, size_t accessCount, TaskId *taskId) {
+        assert(!m_processing);
+
+        if (m_accesses.size() + accessCount > m_accesses.capacity()) {
+            return false;
+        }
+
+        collectSubmissions();
+
+        // Gather the unique set of tasks we must wait for, whether declared directly or through resources.
+        // Tasks collected after this point were submitted, so they cannot declare any resources.
+        const TaskId taskCount = static_cast< TaskId >(m_taskCount);
+
+        m_newDependencies.clear();
+        for (size_t loop = 0; loop < dependencyCount; ++loop) {
+            if (dependencies[loop] >= taskCount) {
+                return false;
+            }
+
+            addDependency(dependencies[loop]);
+        }
+
+        for (size_t loop = 0; loop < accessCount; ++loop) {
+            addResourceDependencies(accesses[loop], taskCount);
+        }
+
+        TaskId newTaskId;
+        if (m_edges.size() + m_newDependencies.size() > m_edges.capacity() || !reserveTask(newTaskId)) {
+            return false;
+        }
+
+        // Submitters publish their slot straight after reserving it, so this wait is brief
+        while (m_taskCount < newTaskId) {
+            if (0 == collectSubmissions()) {
+                std::this_thread::yield();
+            }
+        }
+
+        taskInfo.predecessorCount = static_cast< uint32_t >(m_newDependencies.size());
+        taskInfo.firstSuccessor = kInvalidTaskId;
+
+        for (size_t loop = 0; loop < m_newDependencies.size(); ++loop) {
+            TaskInfo &predecessor = m_tasks[m_newDependencies[loop]];
+            const TaskEdge taskEdge = {newTaskId, predecessor.firstSuccessor};
+
+            predecessor.firstSuccessor = static_cast< uint32_t >(m_edges.size());
+            m_edges.push_back(taskEdge);
+        }
+
+        const AccessRange accessRange = {static_cast< uint32_t >(m_accesses.size()), static_cast< uint32_t >(accessCount)};
+        m_accesses.insert(m_accesses.end(), accesses, accesses + accessCount);
+        m_accessRanges.push_back(accessRange);
+
+        m_tasks[newTaskId] = taskInfo;
+        m_taskDurations[newTaskId] = 0;
+        m_taskCount = newTaskId + 1;
+        m_graph.invalidate();
+
+        if (nullptr != taskId) {
+            *taskId = newTaskId;
+        }
+
+        return true;
+    }
+
+
+    //! \brief  Submits a new task to the provider, this may be called by any thread.
+    //! \param  executeFunc [in] -
+    //!         The function that implements the processing necessary for the task.
+    //! \return <em>True</em> if the task was submitted otherwise <em>false</em> if the task table is full.
+    bool TaskProvider::submitTask(TaskExecuteFunction executeFunc) {
+        return submitTask(executeFunc, kTaskPriority_Normal, nullptr);
+    }
+
+
+    //! \brief  Submits a new task to the provider, this may be called by any thread.
+    //! \param  executeFunc [in] -
+    //!         The function that implements the processing necessary for the task.
+    //! \param  priority [in] -
+    //!         The priority class the task will belong to.
+    //! \param  taskId [out] -
+    //!         Receives the identifier of the new task, may be <em>nullptr</em> if the identifier is not required.
+    //! \return <em>True</em> if the task was submitted otherwise <em>false</em> if the task table is full.
+    //!
+    //! Submitted tasks have no dependencies, and are not processed until they have been collected
+    //! by collectSubmissions(). This happens automatically when processing begins, so a task
+    //! submitted whilst a frame is being processed joins the following frame. Submission must
+    //! not overlap clearTasks() or shutdown().
+    bool TaskProvider::submitTask(TaskExecuteFunction executeFunc, kTaskPriority priority, TaskId *taskId) {
+        if (nullptr == executeFunc || priority >= kTaskPriority_Count) {
+            return false;
+        }
+
+        TaskInfo taskInfo;
+
+        taskInfo.execute = executeFunc;
+        taskInfo.invoke = nullptr;
+        taskInfo.priority = priority;
+
+        return publishTask(taskInfo, taskId);
+    }
+
+
+    //! \brief  Submits a new task whose function receives a copy of the supplied payload, this may be called by any thread.
+    //! \param  invokeFunc [in] -
+    //!         The function that implements the processing necessary for the task.
+    //! \param  payload [in] -
+    //!         The data passed to the function, may be <em>nullptr</em> if payloadSize is 0.
+    //! \param  payloadSize [in] -
+    //!         Size (in bytes) of the payload, this must not exceed kRaizeTaskPayloadSize.
+    //! \param  priority [in] -
+    //!         The priority class the task will belong to.
+    //! \param  taskId [out] -
+    //!         Receives the identifier of the new task, may be <em>nullptr</em> if the identifier is not required.
+    //! \return <em>True</em> if the task was submitted otherwise <em>false</em> if the payload is too large or the task table is full.
+    bool TaskProvider::submitTask(TaskPayloadFunction invokeFunc, const void *payload, size_t payloadSize, kTaskPriority priority, TaskId *taskId) {
+        if (nullptr == invokeFunc || payloadSize > kRaizeTaskPayloadSize || (nullptr == payload && 0 != payloadSize) || priority >= kTaskPriority_Count) {
+            return false;
+        }
+
+        TaskInfo taskInfo;
+
+        taskInfo.execute = nullptr;
+        taskInfo.invoke = invokeFunc;
+        taskInfo.priority = priority;
+
+        if (0 != payloadSize) {
+            memcpy(taskInfo.payload.data, payload, payloadSize);
+        }
+
+        return publishTask(taskInfo, taskId);
+    }
+
+
+    //! \brief  Reserves the next free slot within the task table.
+    //! \param  taskId [out] -
+    //!         Receives the identifier of the reserved slot.
+    //! \return <em>True</em> if a slot was reserved otherwise <em>false</em> if every slot has been handed out.
+    //!
+    //! The counter never passes the capacity, so a failed reservation leaves nothing to undo.
+    bool TaskProvider::reserveTask(TaskId &taskId) {
+        uint32_t reserved = m_reservedTasks.load(std::memory_order_relaxed);
+
+        do {
+            if (reserved >= m_taskCapacity) {
+                return false;
+            }
+        } while (!m_reservedTasks.compare_exchange_weak(reserved, reserved + 1, std::memory_order_relaxed));
+
+        taskId = reserved;
+        return true;
+    }
+
+
+    //! \brief  Copies a submitted task into a reserved slot, and publishes it to the building thread.
+    //! \param  taskInfo [in] -
+    //!         Description of the task.
+    //! \param  taskId [out] -
+    //!         Receives the identifier of the new task, may be <em>nullptr</em> if the identifier is not required.
+    //! \return <em>True</em> if the task was published otherwise <em>false</em> if the task table is full.
+    bool TaskProvider::publishTask(const TaskInfo &taskInfo, TaskId *taskId) {
+        TaskId newTaskId;
+        if (!reserveTask(newTaskId)) {
+            return false;
+        }
+
+        // The slot is ours alone until it is published
+        TaskInfo &slot = m_tasks[newTaskId];
+
+        slot = taskInfo;
+        slot.predecessorCount = 0;
+        slot.firstSuccessor = kInvalidTaskId;
+        slot.rangeIndex = kInvalidTaskId;
+
+        m_publishedTasks[newTaskId].store(true, std::memory_order_release);
+
+        if (nullptr != taskId) {
+            *taskId = newTaskId;
+        }
+
+        return true;
+    }
+
+
+    //! \brief  Moves the tasks submitted by other threads into the task list, this must not be called whilst tasks are being processed.
+    //! \return The number of tasks that were collected.
+    //!
+    //! Slots are collected in order, stopping at the first slot that has been reserved but not
+    //! yet published. The remaining submissions are collected by a later call.
+    size_t TaskProvider::collectSubmissions() {
+        assert(!m_processing);
+
+        const size_t reserved = m_reservedTasks.load(std::memory_order_relaxed);
+        const size_t taskCount = m_taskCount;
+
+        while (m_taskCount < reserved && m_publishedTasks[m_taskCount].load(std::memory_order_acquire)) {
+            m_publishedTasks[m_taskCount].store(false, std::memory_order_relaxed);
+            commitTask(static_cast< TaskId >(m_taskCount++));
+        }
+
+        if (taskCount != m_taskCount) {
+            m_graph.invalidate();
+        }
+
+        return m_taskCount - taskCount;
+    }
+
+
+    //! \brief  Prepares the bookkeeping of a collected task, which declares no resources.
+    //! \param  taskId [in] -
+    //!         Identifier of the collected task.
+    void TaskProvider::commitTask(TaskId taskId) {
+        const AccessRange accessRange = {static_cast< uint32_t >(m_accesses.size()), 0};
+
+        m_accessRanges.push_back(accessRange);
+        m_taskDurations[taskId] = 0;
+    }
+
+
+    //! \brief  Adds a task to the dependency list of the task currently being added, ignoring duplicates.
+    //! \param  dependency [in] -
+    //!         Identifier of the task that must complete first.
+    //! \return <em>True</em> if the dependency was added otherwise <em>false</em> if it was already present.
+    bool TaskProvider::addDependency(TaskId dependency) {
+        for (size_t loop = 0; loop < m_newDependencies.size(); ++loop) {
+            if (dependency == m_newDependencies[loop]) {
+                return false;
+            }
+        }
+
+        m_newDependencies.push_back(dependency);
+        return true;
+    }
+
+
+    //! \brief  Adds dependencies upon the earlier tasks that conflict with a resource access.
+    //! \param  resourceAccess [in] -
+    //!         The resource access declared by the task being added.
+    //! \param  taskCount [in] -
+    //!         Number of tasks within the task list, each of which is searched.
+    //! \return <em>True</em> if a previous writer of the resource was found otherwise <em>false</em>.
+    //!
+    //! We search backwards until we find the previous writer of the resource. Any tasks before
+    //! that writer are already ordered against it, so they do not need to be considered.
+    bool TaskProvider::addResourceDependencies(const ResourceAccess &resourceAccess, TaskId taskCount) {
+        bool foundReader = false;
+
+        for (TaskId previous = taskCount; previous > 0; --previous) {
+            const AccessRange &accessRange = m_accessRanges[previous - 1];
+
+            for (uint32_t loop = 0; loop < accessRange.count; ++loop) {
+                const ResourceAccess &previousAccess = m_accesses[accessRange.first + loop];
+                if (previousAccess.resource != resourceAccess.resource) {
+                    continue;
+                }
+
+                if (kResourceAccess_Write == previousAccess.access) {
+                    // Readers found since the writer already wait upon it, so we are ordered transitively
+                    if (!foundReader) {
+                        addDependency(previous - 1);
+                    }
+
+                    return true;
+                }
+
+                // Readers only conflict with a writer
+                if (kResourceAccess_Write == resourceAccess.access) {
+                    addDependency(previous - 1);
+                    foundReader = true;
+                }
+            }
         }
 
         return false;
     }
 
+
+    //! \brief  Moves a task into a different priority class, this must not be called whilst tasks are being processed.
+    //! \param  taskId [in] -
+    //!         Identifier of the task whose priority is to be changed.
+    //! \param  priority [in] -
+    //!         The priority class the task will belong to.
+    //! \return <em>True</em> if the priority was changed otherwise <em>false</em> if the task or priority is invalid.
+    bool TaskProvider::setTaskPriority(TaskId taskId, kTaskPriority priority) {
+        assert(!m_processing);
+
+        if (taskId >= m_taskCount || priority >= kTaskPriority_Count) {
+            return false;
+        }
+
+        if (m_tasks[taskId].priority != static_cast< uint32_t >(priority)) {
+            m_tasks[taskId].priority = priority;
+            m_graph.invalidate();
+        }
+
+        return true;
+    }
+
+
+    //! \brief  Spawns a task from within a running task, to be processed during the current frame.
+    //! \param  contextId [in] -
+    //!         Identifier of the execution context processing the parent.
+    //! \param  parentId [in] -
+    //!         Identifier of the running work that is spawning the task, as returned by acquireTask().
+    //! \param  executeFunc [in] -
+    //!         The function that implements the processing necessary for the task.
+    //! \return <em>True</em> if the task was spawned otherwise <em>false</em> if the contexts pool is exhausted.
+    bool TaskProvider::spawnTask(unsigned int contextId, TaskId parentId, TaskExecuteFunction executeFunc) {
+        if (nullptr == executeFunc) {
+            return false;
+        }
+
+        TaskInfo taskInfo;
+
+        taskInfo.execute = executeFunc;
+        taskInfo.invoke = nullptr;
+
+        return insertSpawn(contextId, parentId, taskInfo);
+    }
+
+
+    //! \brief  Spawns a task from within a running task, to be processed during the current frame.
+    //! \param  contextId [in] -
+    //!         Identifier of the execution context processing the parent.
+    //! \param  parentId [in] -
+    //!         Identifier of the running work that is spawning the task, as returned by acquireTask().
+    //! \param  invokeFunc [in] -
+    //!         The function called with a pointer to the tasks copy of the payload.
+    //! \param  payload [in] -
+    //!         The data to be copied into the task, may be <em>nullptr</em> if payloadSize is 0.
+    //! \param  payloadSize [in] -
+    //!         Size (in bytes) of the payload, this must not exceed kRaizeTaskPayloadSize.
+    //! \return <em>True</em> if the task was spawned otherwise <em>false</em> if the payload is too large or the contexts pool is exhausted.
+    bool TaskProvider::spawnTask(unsigned int contextId, TaskId parentId, TaskPayloadFunction invokeFunc, const void *payload, size_t payloadSize) {
+        if (nullptr == invokeFunc || payloadSize > kRaizeTaskPayloadSize || (nullptr == payload && 0 != payloadSize)) {
+            return false;
+        }
+
+        TaskInfo taskInfo;
+
+        taskInfo.execute = nullptr;
+        taskInfo.invoke = invokeFunc;
+
+        if (0 != payloadSize) {
+            memcpy(taskInfo.payload.data, payload, payloadSize);
+        }
+
+        return insertSpawn(contextId, parentId, taskInfo);
+    }
+
+
+    //! \brief  Allocates a spawned task from the contexts pool, attaches it to its parent and queues it.
+    //! \param  contextId [in] -
+    //!         Identifier of the execution context processing the parent.
+    //! \param  parentId [in] -
+    //!         Identifier of the running work that is spawning the task.
+    //! \param  taskInfo [in] -
+    //!         Description of the task, the priority is inherited from the parent.
+    //! \return <em>True</em> if the task was spawned otherwise <em>false</em> if the contexts pool is exhausted.
+    bool TaskProvider::insertSpawn(unsigned int contextId, TaskId parentId, const TaskInfo &taskInfo) {
+        assert(contextId < m_queueCount);
+
+        ContextState &contextState = m_contextStates[contextId];
+        if (contextState.spawnCount >= kRaizeSpawnsPerContext) {
+            return false;
+        }
+
+        const uint32_t spawnIndex = static_cast< uint32_t >(contextId * kRaizeSpawnsPerContext + contextState.spawnCount);
+        SpawnedTask &spawnedTask = m_spawns[spawnIndex];
+
+        spawnedTask.taskInfo = taskInfo;
+        spawnedTask.taskInfo.predecessorCount = 0;
+        spawnedTask.taskInfo.firstSuccessor = kInvalidTaskId;
+        spawnedTask.taskInfo.rangeIndex = kInvalidTaskId;
+        spawnedTask.taskInfo.priority = getWorkPriority(parentId);
+        spawnedTask.parent = parentId;
+        spawnedTask.root = getRegisteredTask(parentId);
+        spawnedTask.joinCount.store(0, std::memory_order_relaxed);
+
+        // The parent is still running, so it cannot complete before this increment
+        getJoinCount(parentId).fetch_add(1, std::memory_order_relaxed);
+
+        if (!pushTask(contextId, spawnIndex | kSpawnFlag, spawnedTask.taskInfo.priority)) {
+            getJoinCount(parentId).fetch_sub(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        contextState.spawnCount++;
+        return true;
+    }
+
+
+    //! \brief  Removes every task from the provider, this must not be called whilst tasks are being processed.
+    //!
+    //! The storage reserved by initialize() is retained, so the task list may be rebuilt without
+    //! allocating memory. Submissions that have not been collected are discarded, so no thread
+    //! may be submitting tasks.
+    void TaskProvider::clearTasks() {
+        assert(!m_processing);
+
+        const size_t reserved = m_reservedTasks.load(std::memory_order_acquire);
+        for (size_t loop = m_taskCount; loop < reserved; ++loop) {
+            m_publishedTasks[loop].store(false, std::memory_order_relaxed);
+        }
+
+        m_taskCount = 0;
+        m_reservedTasks.store(0, std::memory_order_relaxed);
+        m_edges.clear();
+        m_ranges.clear();
+        m_accesses.clear();
+        m_accessRanges.clear();
+
+        m_graph.invalidate();
+    }
+
+
+    //! \brief  Changes the number of execution contexts that process tasks, this must not be called whilst tasks are being processed.
+    //! \param  contextCount [in] -
+    //!         The number of contexts, which must not exceed the queue count supplied to initialize().
+    //! \return <em>True</em> if the context count was changed otherwise <em>false</em> if there are too few queues.
+    //!
+    //! Tasks are only distributed to, and stolen from, the first contextCount queues. The task
+    //! list is unaffected, so the scheduler may change its thread count between frames.
+    bool TaskProvider::setContextCount(size_t contextCount) {
+        if (0 == contextCount || contextCount > m_queueCount) {
+            return false;
+        }
+
+        m_contextCount = contextCount;
+        return true;
+    }
+
+
+    //! \brief  Selects how execution contexts claim tasks, this must not be called whilst tasks are being processed.
+    //! \param  claimMode [in] -
+    //!         The method execution contexts will use to claim tasks from the provider.
+    void TaskProvider::setClaimMode(kTaskClaimMode claimMode) {
+        setClaimMode(claimMode, 1);
+    }
+
+
+    //! \brief  Selects how execution contexts claim tasks, this must not be called whilst tasks are being processed.
+    //! \param  claimMode [in] -
+    //!         The method execution contexts will use to claim tasks from the provider.
+    //! \param  minimumBatchSize [in] -
+    //!         When batching, the smallest number of tasks a context will claim at once (the final batch may be smaller).
+    void TaskProvider::setClaimMode(kTaskClaimMode claimMode, size_t minimumBatchSize) {
+        m_claimMode = claimMode;
+        m_minimumBatchSize = (0 != minimumBatchSize) ? minimumBatchSize : 1;
+    }
+
+
+    //! \brief  Compiles the registered tasks into the graph that is replayed each frame.
+    //! \return <em>True</em> if the graph was compiled successfully otherwise <em>false</em>.
+    //!
+    //! This happens automatically when processing begins after the task list has changed, it
+    //! may be called directly to move the cost out of the first frame.
+    bool TaskProvider::compile() {
+        assert(!m_processing);
+
+        collectSubmissions();
+
+        m_remainingTasks.store(0, std::memory_order_relaxed);
+
+        // An unfinished frame may also have left join counts behind
+        for (size_t loop = 0; loop < m_taskCount; ++loop) {
+            m_joinCounts[loop].store(0, std::memory_order_relaxed);
+        }
+
+        return m_graph.compile(m_tasks.get(), m_taskCount, m_edges.data());
+    }
+
+
     //! \brief  Called by the scheduler when it is about to begin processing tasks.
     //! \return The number of tasks that are awaiting processing.
     size_t TaskProvider::onBeginProcessing() {
-        m_nextTask = 0;
-        return m_tasks.size();
+        assert(!m_processing);
+
+        collectSubmissions();
+
+        // An unfinished frame leaves the predecessor counters out of step, so we rebuild them
+        if (!m_graph.isCompiled() || 0 != m_remainingTasks.load(std::memory_order_relaxed)) {
+            if (!compile()) {
+                return 0;
+            }
+        }
+
+        const size_t taskCount = m_graph.getTaskCount();
+
+        // A frame without tasks is never ended, as nothing is processed
+        m_processing = (0 != taskCount);
+
+        m_graph.beginFrame();
+        m_remainingTasks.store(taskCount, std::memory_order_relaxed);
+        m_nextTask.store(0, std::memory_order_relaxed);
+
+        for (size_t queue = 0; queue < m_queueCount * kTaskPriority_Count; ++queue) {
+            m_queues[queue].reset();
+        }
+
+        for (size_t context = 0; context < m_queueCount; ++context) {
+            m_contextStates[context].chunkCount = 0;
+            m_contextStates[context].popCount = 0;
+            m_contextStates[context].spawnCount = 0;
+            m_contextStates[context].timingCount = 0;
+            resetContextPriorities(static_cast< unsigned int >(context));
+        }
+
+        m_frameTimer.reset();
+
+        if (kTaskClaimMode_Batched == m_claimMode) {
+            return taskCount;
+        }
+
+        // Each queue receives a contiguous block of each priority class within the ready list.
+        // The blocks are pushed in reverse so the owner pops its tasks in the order they were
+        // added, whilst thieves take from the far end of the block.
+        for (uint32_t priority = 0; priority < kTaskPriority_Count; ++priority) {
+            const size_t classStart = m_graph.getReadyClassBegin(priority);
+            const size_t classCount = m_graph.getReadyClassBegin(priority + 1) - classStart;
+
+            for (unsigned int context = 0; context < m_contextCount; ++context) {
+                const size_t blockStart = classStart + classCount * context / m_contextCount;
+                const size_t blockEnd = classStart + classCount * (context + 1) / m_contextCount;
+
+                for (size_t position = blockEnd; position > blockStart; --position) {
+                    getQueue(context, priority).push(m_graph.getReadyTask(position - 1));
+                }
+            }
+        }
+
+        return taskCount;
     }
 
 
     //! \brief  Called by the scheduler when it has completed processing the queued tasks.
+    //!
+    //! The durations recorded within each contexts timing block are merged into the task table,
+    //! and the completion times each context recorded are merged into its priority class.
     void TaskProvider::onEndProcessing() {
+        m_processing = false;
+
+        for (size_t context = 0; context < m_queueCount; ++context) {
+            ContextState &contextState = m_contextStates[context];
+            const TaskTiming *timings = &m_timings[context * m_timingStride];
+
+            for (uint32_t loop = 0; loop < contextState.timingCount; ++loop) {
+                m_taskDurations[timings[loop].taskId] = timings[loop].elapsedNano;
+            }
+
+            contextState.timingCount = 0;
+        }
+
+        if (Profiler::kTiming) {
+            for (uint32_t priority = 0; priority < kTaskPriority_Count; ++priority) {
+                PriorityState &priorityState = m_priorityStates[priority];
+
+                uint64_t taskCount = priorityState.taskCount.load(std::memory_order_relaxed);
+                uint64_t totalCompletion = priorityState.totalCompletion.load(std::memory_order_relaxed);
+                uint64_t maximumCompletion = priorityState.maximumCompletion.load(std::memory_order_relaxed);
+
+                for (size_t context = 0; context < m_queueCount; ++context) {
+                    const PriorityTiming &priorityTiming = m_contextPriorities[context].classes[priority];
+
+                    taskCount += priorityTiming.taskCount;
+                    totalCompletion += priorityTiming.totalCompletion;
+                    maximumCompletion = std::max(maximumCompletion, priorityTiming.maximumCompletion);
+                }
+
+                priorityState.taskCount.store(taskCount, std::memory_order_relaxed);
+                priorityState.totalCompletion.store(totalCompletion, std::memory_order_relaxed);
+                priorityState.maximumCompletion.store(maximumCompletion, std::memory_order_relaxed);
+            }
+
+            for (size_t context = 0; context < m_queueCount; ++context) {
+                resetContextPriorities(static_cast< unsigned int >(context));
+            }
+        }
     }
 
 
-    //! \brief  Retrieves the next task to be procesed.
+    //! \brief  Discards the completion times recorded by an execution context.
+    //! \param  contextId [in] -
+    //!         Identifier of the execution context whose completion times are discarded.
+    void TaskProvider::resetContextPriorities(unsigned int contextId) {
+        for (uint32_t priority = 0; priority < kTaskPriority_Count; ++priority) {
+            PriorityTiming &priorityTiming = m_contextPriorities[contextId].classes[priority];
+
+            priorityTiming.taskCount = 0;
+            priorityTiming.totalCompletion = 0;
+            priorityTiming.maximumCompletion = 0;
+        }
+    }
+
+
+    //! \brief  Retrieves how long a registered task took to execute when it was last processed.
+    //! \param  taskId [in] -
+    //!         Identifier of the task.
+    //! \return Time (in nanoseconds) the task took to execute, or 0 if the task has not been processed or does not exist.
+    //!
+    //! For range tasks this is the total time spent processing every chunk. Tasks are only
+    //! measured when the profiler measures time, see RAIZE_PROFILER.
+    uint64_t TaskProvider::getTaskDuration(TaskId taskId) const {
+        return (taskId < m_taskCount) ? m_taskDurations[taskId] : 0;
+    }
+
+
+    //! \brief  Retrieves the next task to be procesed by the first execution context.
     //! \return Pointer to the task to be processed by the calling thread, if no tasks remain this method returns <em>nullptr</em>.
     TaskInfo *TaskProvider::nextTask() {
-        TaskInfo *taskInfo = nullptr;
+        return nextTask(0);
+    }
+
+
+    //! \brief  Retrieves the next task to be procesed.
+    //! \param  contextId [in] -
+    //!         Identifier of the execution context requesting a task, only this context may pop from its own queue.
+    //! \return Pointer to the task to be processed by the calling thread, if no tasks are available this method returns <em>nullptr</em>.
+    //!
+    //! This method does not wait for or release dependent tasks, acquireTask() and completeTask()
+    //! should be used when processing tasks that have dependencies.
+    TaskInfo *TaskProvider::nextTask(unsigned int contextId) {
+        if (0 == m_queueCount) {
+            return nullptr;
+        }
+
+        assert(contextId < m_queueCount);
+
+        if (kTaskClaimMode_Batched == m_claimMode) {
+            TaskRange range;
+            return claimBatch(1, range) ? &m_tasks[m_graph.getReadyTask(range.first)] : nullptr;
+        }
+
+        const uint32_t taskIndex = popTask(contextId);
+        return (TaskQueue::kEmpty != taskIndex) ? &m_tasks[taskIndex] : nullptr;
+    }
+
+
+    //! \brief  Informs the provider that a task has finished executing, releasing any tasks that were waiting upon it.
+    //! \param  contextId [in] -
+    //!         Identifier of the execution context that processed the task.
+    //! \param  taskId [in] -
+    //!         Identifier of the task that has completed, which may be a spawned task.
+    //!
+    //! If the task spawned children that have not yet finished, the task is completed by the
+    //! context that finishes its final child instead.
+    void TaskProvider::completeTask(unsigned int contextId, TaskId taskId) {
+        assert(contextId < m_queueCount);
+
+        if (0 != getJoinCount(taskId).fetch_add(kJoinFinished, std::memory_order_acq_rel)) {
+            return;
+        }
+
+        finishWork(contextId, taskId);
+    }
+
+
+    //! \brief  Completes a task whose children have all finished, then releases its parent should it be a spawned task.
+    //! \param  contextId [in] -
+    //!         Identifier of the execution context that finished the work.
+    //! \param  workId [in] -
+    //!         Identifier of the task, or spawned task, that has finished.
+    void TaskProvider::finishWork(unsigned int contextId, TaskId workId) {
+        // Walk up through the spawned tasks, each parent may have been waiting only for us
+        while (isSpawnedWork(workId)) {
+            const TaskId parentId = m_spawns[workId & ~kSpawnFlag].parent;
+
+            if (kJoinFinished + 1 != getJoinCount(parentId).fetch_sub(1, std::memory_order_acq_rel)) {
+                return;
+            }
+
+            workId = parentId;
+        }
+
+        const TaskId taskId = workId;
+        m_joinCounts[taskId].store(0, std::memory_order_relaxed);
+
+        // Successors are pushed onto our own queue, they are likely to use the data we just produced
+        const TaskId *successorEnd = m_graph.getSuccessorsEnd(taskId);
+        for (const TaskId *successor = m_graph.getSuccessorsBegin(taskId); successor != successorEnd; ++successor) {
+            if (m_graph.releaseSuccessor(*successor)) {
+                const bool pushed = pushTask(contextId, *successor, m_tasks[*successor].priority);
+                assert(pushed);
+                (void)pushed;
+            }
+        }
+
+        // Recorded within our own block, it is merged into the priority class as the frame ends
+        if (Profiler::kTiming) {
+            PriorityTiming &priorityTiming = m_contextPriorities[contextId].classes[m_tasks[taskId].priority];
+            const uint64_t completionTime = m_frameTimer.getElapsedTimeNano();
+
+            priorityTiming.taskCount++;
+            priorityTiming.totalCompletion += completionTime;
+            if (completionTime > priorityTiming.maximumCompletion) {
+                priorityTiming.maximumCompletion = completionTime;
+            }
+        }
+
+        // Must happen after the successors are queued, otherwise other contexts may believe the frame has finished
+        m_remainingTasks.fetch_sub(1, std::memory_order_release);
+    }
+
+
+    //! \brief  Claims a block of contiguous entries from the frames ready list, this is only supported in batched mode.
+    //! \param  contextId [in] -
+    //!         Identifier of the execution context requesting tasks.
+    //! \param  range [out] -
+    //!         Receives the claimed positions within the ready list, which are only valid if this method returns <em>true</em>.
+    //! \return <em>True</em> if at least one task was claimed otherwise <em>false</em> if no tasks remain.
+    //!
+    //! The calling context may walk the entire range without touching any shared state, see getReadyTask().
+    bool TaskProvider::claimTasks(unsigned int contextId, TaskRange &range) {
+        if (0 == m_queueCount || kTaskClaimMode_Batched != m_claimMode) {
+            return false;
+        }
+
+        assert(contextId < m_queueCount);
+        (void)contextId;
+
+        const size_t readyCount = m_graph.getReadyCount();
+        const size_t claimed = m_nextTask.load(std::memory_order_relaxed);
+        const size_t remaining = (claimed < readyCount) ? (readyCount - claimed) : 0;
+
+        // Guided batching, claim a share of the remaining work that shrinks as the list drains
+        const size_t batchSize = std::max(m_minimumBatchSize, remaining / (2 * m_contextCount));
+        return claimBatch(batchSize, range);
+    }
+
+
+    //! \brief  Retrieves the chunk of a range task referred to by a work identifier.
+    //! \param  contextId [in] -
+    //!         Identifier of the execution context that will process the chunk.
+    //! \param  workId [in] -
+    //!         Identifier returned by acquireTask(), for which isRangeWork() returned <em>true</em>.
+    //! \return Description of the chunk to be processed.
+    //!
+    //! When the work refers to the range task itself, the returned chunk covers the entire range.
+    TaskChunk TaskProvider::acquireChunk(unsigned int contextId, TaskId workId) {
+        assert(contextId < m_queueCount);
+        (void)contextId;
+
+        if (0 != (workId & kChunkFlag)) {
+            return m_chunks[workId & ~kChunkFlag];
+        }
+
+        const RangeInfo &rangeInfo = m_ranges[m_tasks[workId].rangeIndex];
+        RangeState &rangeState = m_rangeStates[m_tasks[workId].rangeIndex];
+
+        // The range task is only acquired once per frame, by the context that will create its chunks
+        rangeState.pendingChunks.store(1, std::memory_order_relaxed);
+        rangeState.elapsedNano.store(0, std::memory_order_relaxed);
+
+        const TaskChunk taskChunk = {workId, rangeInfo.begin, rangeInfo.end};
+        return taskChunk;
+    }
+
+
+    //! \brief  Splits a chunk in half, offering the upper half to other execution contexts.
+    //! \param  contextId [in] -
+    //!         Identifier of the execution context holding the chunk.
+    //! \param  chunk [in/out] -
+    //!         The chunk to be split, on success this is reduced to the lower half.
+    //! \return <em>True</em> if the chunk was split otherwise <em>false</em> if it is no larger than the grain size or no chunks remain.
+    bool TaskProvider::splitChunk(unsigned int contextId, TaskChunk &chunk) {
+        assert(contextId < m_queueCount);
+
+        const TaskInfo &taskInfo = m_tasks[chunk.task];
+        if (chunk.end - chunk.begin <= m_ranges[taskInfo.rangeIndex].grainSize) {
+            return false;
+        }
+
+        ContextState &contextState = m_contextStates[contextId];
+        if (contextState.chunkCount >= kRaizeChunksPerContext) {
+            return false;
+        }
+
+        const uint32_t chunkIndex = static_cast< uint32_t >(contextId * kRaizeChunksPerContext + contextState.chunkCount);
+        const size_t middle = chunk.begin + (chunk.end - chunk.begin) / 2;
+        const TaskChunk upperHalf = {chunk.task, middle, chunk.end};
+
+        RangeState &rangeState = m_rangeStates[taskInfo.rangeIndex];
+
+        m_chunks[chunkIndex] = upperHalf;
+        rangeState.pendingChunks.fetch_add(1, std::memory_order_relaxed);
+
+        if (!pushTask(contextId, chunkIndex | kChunkFlag, taskInfo.priority)) {
+            rangeState.pendingChunks.fetch_sub(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        contextState.chunkCount++;
+        chunk.end = middle;
+        return true;
+    }
+
+
+    //! \brief  Informs the provider that a chunk of a range task has been processed.
+    //! \param  contextId [in] -
+    //!         Identifier of the execution context that processed the chunk.
+    //! \param  chunk [in] -
+    //!         The chunk that was processed.
+    //! \param  elapsedNano [in] -
+    //!         Time (in nanoseconds) taken to process the chunk.
+    //!
+    //! When the final chunk completes, the range task itself is completed and the grain size
+    //! used in the next frame is adapted from the measured cost of each index.
+    void TaskProvider::completeChunk(unsigned int contextId, const TaskChunk &chunk, uint64_t elapsedNano) {
+        const TaskInfo &taskInfo = m_tasks[chunk.task];
+        RangeState &rangeState = m_rangeStates[taskInfo.rangeIndex];
+
+        rangeState.elapsedNano.fetch_add(elapsedNano, std::memory_order_relaxed);
+        if (1 != rangeState.pendingChunks.fetch_sub(1, std::memory_order_acq_rel)) {
+            return;
+        }
+
+        RangeInfo &rangeInfo = m_ranges[taskInfo.rangeIndex];
+
+        const uint64_t totalElapsed = rangeState.elapsedNano.load(std::memory_order_relaxed);
+        const size_t itemCount = rangeInfo.end - rangeInfo.begin;
+
+        if (0 != itemCount) {
+            // Aim for chunks of kRaizeTargetChunkDuration, whilst leaving enough chunks for every context
+            const uint64_t itemCost = std::max<uint64_t>(1, totalElapsed / itemCount);
+            const size_t targetGrain = static_cast< size_t >(kRaizeTargetChunkDuration / itemCost);
+            const size_t largestGrain = std::max(rangeInfo.minimumGrainSize, itemCount / m_contextCount);
+
+            rangeInfo.grainSize = std::min(std::max(targetGrain, rangeInfo.minimumGrainSize), largestGrain);
+        }
+
+        recordDuration(contextId, chunk.task, totalElapsed);
+
+        completeTask(contextId, chunk.task);
+    }
+
+
+    //! \brief  Retrieves the grain size that will be used when the range task is next processed.
+    //! \param  taskId [in] -
+    //!         Identifier of the range task.
+    //! \return The grain size that will be used when the range task is next processed.
+    size_t TaskProvider::getRangeGrainSize(TaskId taskId) const {
+        const uint32_t rangeIndex = m_tasks[taskId].rangeIndex;
+        return (kInvalidTaskId != rangeIndex) ? m_ranges[rangeIndex].grainSize : 0;
+    }
+
+
+    //! \brief  Reserves a block of tasks from the shared task index.
+    //! \param  maximumBatchSize [in] -
+    //!         The largest number of tasks to be reserved.
+    //! \param  range [out] -
+    //!         Receives the indices of the claimed tasks, which are only valid if this method returns <em>true</em>.
+    //! \return <em>True</em> if at least one task was claimed otherwise <em>false</em> if no tasks remain.
+    bool TaskProvider::claimBatch(size_t maximumBatchSize, TaskRange &range) {
+        const size_t readyCount = m_graph.getReadyCount();
+
+        // A single fetch_add never fails or retries, contexts that overshoot the list simply receive nothing
+        const size_t first = m_nextTask.fetch_add(maximumBatchSize, std::memory_order_relaxed);
+        if (first >= readyCount) {
+            return false;
+        }
+
+        range.first = first;
+        range.last = std::min(first + maximumBatchSize, readyCount);
+        return true;
+    }
 
-        // Ensure we're the only thread accessing our data, we do not want to use a mutex lock here
-        unsigned int acquireExpected = 0;
-        while (!m_taskAcquire.compare_exchange_weak(acquireExpected, 1)) {
-            // QUERY: See if there's an alternate we can use that doesn't need us to reset this variable
-            acquireExpected = 0;
+
+    //! \brief  Makes a single attempt at finding a task for an execution context to process.
+    //! \param  contextId [in] -
+    //!         Identifier of the execution context requesting a task.
+    //! \param  range [out] -
+    //!         Receives any block of tasks claimed from the ready list, the first entry of which is returned.
+    //! \return Identifier of the task to be processed, or kInvalidTaskId if no task is currently available.
+    TaskId TaskProvider::findTask(unsigned int contextId, TaskRange &range) {
+        // Released successors sit on our own queues, we prefer those as their inputs are likely still in our cache
+        uint32_t taskIndex = popOwnTask(contextId);
+        if (TaskQueue::kEmpty != taskIndex) {
+            return taskIndex;
+        }
+
+        if (claimTasks(contextId, range)) {
+            return m_graph.getReadyTask(range.first++);
+        }
+
+        taskIndex = stealTask(contextId);
+        return (TaskQueue::kEmpty != taskIndex) ? taskIndex : kInvalidTaskId;
+    }
+
+
+    //! \brief  Finds the next task for an execution context, waiting whilst other contexts complete the tasks it depends upon.
+    //! \param  contextId [in] -
+    //!         Identifier of the execution context requesting a task.
+    //! \param  range [out] -
+    //!         Receives any block of tasks claimed from the ready list, the first entry of which is returned.
+    //! \return Identifier of the task to be processed, or kInvalidTaskId once every task in the frame has completed.
+    TaskId TaskProvider::waitTask(unsigned int contextId, TaskRange &range) {
+        if (0 == m_queueCount) {
+            return kInvalidTaskId;
+        }
+
+        assert(contextId < m_queueCount);
+
+        for (;;) {
+            const TaskId taskId = findTask(contextId, range);
+            if (kInvalidTaskId != taskId) {
+                return taskId;
+            }
+
+            // Nothing is ready, but running tasks may still release their successors
+            if (0 == m_remainingTasks.load(std::memory_order_acquire)) {
+                return kInvalidTaskId;
+            }
+
+            std::this_thread::yield();
+        }
+    }
+
+
+    //! \brief  Retrieves the priority class of a task, or spawned task.
+    //! \param  workId [in] -
+    //!         Identifier of the task, or spawned task.
+    //! \return The priority class of the work.
+    uint32_t TaskProvider::getWorkPriority(TaskId workId) const {
+        if (isSpawnedWork(workId)) {
+            return m_spawns[workId & ~kSpawnFlag].taskInfo.priority;
+        }
+
+        return m_tasks[workId].priority;
+    }
+
+
+    //! \brief  Retrieves the join count of a task, or spawned task.
+    //! \param  workId [in] -
+    //!         Identifier of the task, or spawned task.
+    //! \return The join count of the work.
+    std::atomic<uint32_t> &TaskProvider::getJoinCount(TaskId workId) {
+        if (isSpawnedWork(workId)) {
+            return m_spawns[workId & ~kSpawnFlag].joinCount;
+        }
+
+        return m_joinCounts[workId];
+    }
+
+
+    //! \brief  Adds work to one of the queues owned by an execution context.
+    //! \param  contextId [in] -
+    //!         Identifier of the execution context that owns the queue.
+    //! \param  workId [in] -
+    //!         Identifier of the task, or chunk, to be added.
+    //! \param  priority [in] -
+    //!         The priority class of the task the work belongs to.
+    //! \return <em>True</em> if the work was added otherwise <em>false</em> if the queue was full.
+    bool TaskProvider::pushTask(unsigned int contextId, uint32_t workId, uint32_t priority) {
+        return getQueue(contextId, priority).push(workId);
+    }
+
+
+    //! \brief  Takes a task from the contexts own queues, stealing from other contexts if they are empty.
+    //! \param  contextId [in] -
+    //!         Identifier of the execution context requesting a task.
+    //! \return Index of the task to be processed, or TaskQueue::kEmpty if no tasks remain.
+    uint32_t TaskProvider::popTask(unsigned int contextId) {
+        const uint32_t taskIndex = popOwnTask(contextId);
+        if (TaskQueue::kEmpty != taskIndex) {
+            return taskIndex;
         }
 
-        // As long as we have tasks left to process
-        if (m_nextTask < m_tasks.size()) {
-            taskInfo = &m_tasks[m_nextTask++];
+        return stealTask(contextId);
+    }
+
+
+    //! \brief  Takes a task from the highest priority non-empty queue owned by the execution context.
+    //! \param  contextId [in] -
+    //!         Identifier of the execution context requesting a task.
+    //! \return Index of the task to be processed, or TaskQueue::kEmpty if the contexts queues are empty.
+    //!
+    //! Periodically the lowest priority non-empty queue is served instead, so that a steady supply
+    //! of high priority tasks cannot starve the lower classes.
+    uint32_t TaskProvider::popOwnTask(unsigned int contextId) {
+        ContextState &contextState = m_contextStates[contextId];
+
+        // Only tasks actually popped are counted, polling empty queues whilst waiting does not age them
+        const bool aging = (kRaizePriorityAgingInterval - 1 == contextState.popCount % kRaizePriorityAgingInterval);
+
+        for (uint32_t loop = 0; loop < kTaskPriority_Count; ++loop) {
+            const uint32_t priority = aging ? (kTaskPriority_Count - 1 - loop) : loop;
+
+            const uint32_t taskIndex = getQueue(contextId, priority).pop();
+            if (TaskQueue::kEmpty != taskIndex) {
+                contextState.popCount++;
+                return taskIndex;
+            }
+        }
+
+        return TaskQueue::kEmpty;
+    }
+
+
+    //! \brief  Attempts to take a task from another execution contexts queues, highest priority first.
+    //! \param  contextId [in] -
+    //!         Identifier of the execution context that has run out of work.
+    //! \return Index of the stolen task, or TaskQueue::kEmpty if every other queue was empty.
+    uint32_t TaskProvider::stealTask(unsigned int contextId) {
+        TaskQueue &ownQueue = getQueue(contextId, 0);
+
+        // If we lose a race against another thief the victim may still have work, so we go around again.
+        bool contended = true;
+        while (contended) {
+            contended = false;
+
+            const size_t start = ownQueue.nextRandom() % m_contextCount;
+            for (uint32_t priority = 0; priority < kTaskPriority_Count; ++priority) {
+                for (size_t loop = 0; loop < m_contextCount; ++loop) {
+                    const unsigned int victim = static_cast< unsigned int >((start + loop) % m_contextCount);
+                    if (victim == contextId) {
+                        continue;
+                    }
+
+                    const uint32_t taskIndex = getQueue(victim, priority).steal();
+                    if (TaskQueue::kAbort == taskIndex) {
+                        contended = true;
+                    } else if (TaskQueue::kEmpty != taskIndex) {
+                        return taskIndex;
+                    }
+                }
+            }
         }
 
-        // Allow other threads access to the task list
-        m_taskAcquire.store(0);
+        return TaskQueue::kEmpty;
+    }
+
 
-        return taskInfo;
+    //! \brief  Retrieves the measurements of when the tasks within a priority class completed.
+    //! \param  priority [in] -
+    //!         The priority class whose measurements are required.
+    //! \param  priorityStatistics [out] -
+    //!         Receives the measurements recorded since the statistics were last reset.
+    void TaskProvider::getPriorityStatistics(kTaskPriority priority, PriorityStatistics &priorityStatistics) const {
+        assert(priority < kTaskPriority_Count);
+
+        const PriorityState &priorityState = m_priorityStates[priority];
+
+        priorityStatistics.taskCount = priorityState.taskCount.load(std::memory_order_relaxed);
+        priorityStatistics.totalCompletionNano = priorityState.totalCompletion.load(std::memory_order_relaxed);
+        priorityStatistics.maximumCompletionNano = priorityState.maximumCompletion.load(std::memory_order_relaxed);
+    }
+
+
+    //! \brief  Discards the completion measurements of every priority class.
+    void TaskProvider::resetPriorityStatistics() {
+        for (size_t loop = 0; loop < kTaskPriority_Count; ++loop) {
+            m_priorityStates[loop].taskCount.store(0, std::memory_order_relaxed);
+            m_priorityStates[loop].totalCompletion.store(0, std::memory_order_relaxed);
+            m_priorityStates[loop].maximumCompletion.store(0, std::memory_order_relaxed);
+        }
     }
 
 
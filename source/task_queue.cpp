@@ -0,0 +1,78 @@
+//
+// Copyright 2017 nfactorial
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "task_queue.h"
+
+
+// -----------------------------------------------------------------------------------
+
+namespace raize {
+    // -----------------------------------------------------------------------------------
+
+    const uint32_t TaskQueue::kEmpty;
+    const uint32_t TaskQueue::kAbort;
+
+
+    // -----------------------------------------------------------------------------------
+
+    TaskQueue::TaskQueue()
+    : m_randomState(1)
+    , m_mask(0)
+    {
+        m_top.store(0);
+        m_bottom.store(0);
+    }
+
+    TaskQueue::~TaskQueue() {
+    }
+
+
+    //! \brief  Prepares the queue for use by the running application.
+    //! \param  capacity [in] -
+    //!         The minimum number of tasks the queue must be able to contain, this is rounded up to a power of two.
+    //! \param  seed [in] -
+    //!         Non-zero seed for the random sequence used by the owner when choosing a queue to steal from.
+    //! \return <em>True</em> if the queue initialized successfully otherwise <em>false</em>.
+    bool TaskQueue::initialize(size_t capacity, uint32_t seed) {
+        if (0 == capacity || m_buffer) {
+            return false;
+        }
+
+        size_t bufferSize = 1;
+        while (bufferSize < capacity) {
+            bufferSize <<= 1;
+        }
+
+        m_buffer.reset(new std::atomic<uint32_t>[bufferSize]);
+        m_mask = static_cast< int64_t >(bufferSize - 1);
+        m_randomState = (0 != seed) ? seed : 1;
+
+        reset();
+        return true;
+    }
+
+
+    //! \brief  Removes all entries from the queue.
+    //!
+    //! This method is not thread safe and must only be called whilst no context is processing the queue.
+    void TaskQueue::reset() {
+        m_top.store(0, std::memory_order_relaxed);
+        m_bottom.store(0, std::memory_order_relaxed);
+    }
+
+    // -----------------------------------------------------------------------------------
+
+} // namespace raize
@@ -0,0 +1,284 @@
+//
+// Copyright 2017 nfactorial
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include <cstdio>
+#include <cstring>
+
+#if defined( __linux__ )
+    #include <pthread.h>
+    #include <sched.h>
+    #include <sys/resource.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif //defined( __linux__ )
+
+#include "thread_affinity.h"
+
+
+// -----------------------------------------------------------------------------------
+
+namespace raize {
+    // -----------------------------------------------------------------------------------
+
+#if defined( __linux__ )
+    //! The memory policy that prefers allocations from a single node, as defined by the kernel.
+    static const int kRaizeMemoryPolicyPreferred = 1;
+
+    //! \brief  Parses a processor list as found in /sys, such as "0-3,8,10-11".
+    //! \param  path [in] -
+    //!         Path of the file containing the processor list.
+    //! \param  cores [out] -
+    //!         Receives the processors contained within the list.
+    //! \return <em>True</em> if the file was read successfully otherwise <em>false</em>.
+    static bool ReadCoreList(const char *path, CoreSet &cores) {
+        FILE *file = fopen(path, "r");
+        if (nullptr == file) {
+            return false;
+        }
+
+        char buffer[1024];
+        const bool result = (nullptr != fgets(buffer, sizeof(buffer), file));
+        fclose(file);
+
+        if (!result) {
+            return false;
+        }
+
+        cores.reset();
+
+        const char *cursor = buffer;
+        while ('\0' != *cursor && '\n' != *cursor) {
+            char *end = nullptr;
+            const unsigned long first = strtoul(cursor, &end, 10);
+            unsigned long last = first;
+
+            if (end == cursor) {
+                return false;
+            }
+
+            cursor = end;
+            if ('-' == *cursor) {
+                last = strtoul(cursor + 1, &end, 10);
+                cursor = end;
+            }
+
+            for (unsigned long core = first; core <= last && core < cores.size(); ++core) {
+                cores.set(core);
+            }
+
+            if (',' == *cursor) {
+                cursor++;
+            }
+        }
+
+        return true;
+    }
+#endif //defined( __linux__ )
+
+
+    //! \brief  Initializes a placement so the thread may run anywhere with the default scheduling.
+    //! \param  placement [out] -
+    //!         The placement to be initialized.
+    void resetThreadPlacement(ThreadPlacement &placement) {
+        placement.cores.reset();
+        placement.numaNode = kRaizeAnyNumaNode;
+        placement.schedulingClass = kSchedulingClass_Default;
+        placement.priority = 0;
+    }
+
+
+    //! \brief  Determines whether a placement requests anything other than the default behaviour.
+    //! \param  placement [in] -
+    //!         The placement to be examined.
+    //! \return <em>True</em> if the placement leaves the thread to the operating system otherwise <em>false</em>.
+    bool isDefaultThreadPlacement(const ThreadPlacement &placement) {
+        return placement.cores.none() &&
+               kRaizeAnyNumaNode == placement.numaNode &&
+               kSchedulingClass_Default == placement.schedulingClass &&
+               0 == placement.priority;
+    }
+
+
+    //! \brief  Applies a placement to the calling thread.
+    //! \param  placement [in] -
+    //!         Description of where and how the thread should run.
+    //! \return <em>True</em> if every part of the placement was applied otherwise <em>false</em>.
+    //!
+    //! Each part of the placement is applied independently, so a failure (such as lacking the
+    //! permission to use real time scheduling) does not prevent the remaining parts from being
+    //! applied. On platforms without support, only the default placement succeeds.
+    bool applyThreadPlacement(const ThreadPlacement &placement) {
+#if defined( __linux__ )
+        bool result = true;
+
+        CoreSet cores = placement.cores;
+
+        if (kRaizeAnyNumaNode != placement.numaNode) {
+            char path[128];
+            snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", placement.numaNode);
+
+            CoreSet nodeCores;
+            if (ReadCoreList(path, nodeCores)) {
+                cores = cores.none() ? nodeCores : (cores & nodeCores);
+            } else {
+                result = false;
+            }
+
+            // Prefer memory from the node, without failing allocations once it is exhausted
+            unsigned long nodeMask[16] = {0};
+            const size_t maximumNode = sizeof(nodeMask) * 8;
+
+            if (placement.numaNode >= 0 && static_cast< size_t >(placement.numaNode) < maximumNode) {
+                nodeMask[placement.numaNode / (sizeof(unsigned long) * 8)] |= 1UL << (placement.numaNode % (sizeof(unsigned long) * 8));
+                if (0 != syscall(SYS_set_mempolicy, kRaizeMemoryPolicyPreferred, nodeMask, maximumNode)) {
+                    result = false;
+                }
+            } else {
+                result = false;
+            }
+        }
+
+        if (cores.any()) {
+            cpu_set_t cpuSet;
+            CPU_ZERO(&cpuSet);
+
+            for (size_t core = 0; core < cores.size() && core < CPU_SETSIZE; ++core) {
+                if (cores.test(core)) {
+                    CPU_SET(core, &cpuSet);
+                }
+            }
+
+            if (0 != pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet)) {
+                result = false;
+            }
+        }
+
+        sched_param schedParam;
+        memset(&schedParam, 0, sizeof(schedParam));
+
+        int policy = SCHED_OTHER;
+        switch (placement.schedulingClass) {
+            case kSchedulingClass_Default:
+                break;
+
+            case kSchedulingClass_Batch:
+                policy = SCHED_BATCH;
+                break;
+
+            case kSchedulingClass_Idle:
+                policy = SCHED_IDLE;
+                break;
+
+            case kSchedulingClass_RealTime:
+                policy = SCHED_FIFO;
+                schedParam.sched_priority = placement.priority;
+                break;
+        }
+
+        if (kSchedulingClass_Default != placement.schedulingClass) {
+            if (0 != pthread_setschedparam(pthread_self(), policy, &schedParam)) {
+                result = false;
+            }
+        }
+
+        // Linux applies nice values to individual threads, identified by their kernel thread id
+        if (0 != placement.priority && (kSchedulingClass_Default == placement.schedulingClass || kSchedulingClass_Batch == placement.schedulingClass)) {
+            const id_t threadId = static_cast< id_t >(syscall(SYS_gettid));
+            if (0 != setpriority(PRIO_PROCESS, threadId, placement.priority)) {
+                result = false;
+            }
+        }
+
+        return result;
+#else
+        return isDefaultThreadPlacement(placement);
+#endif //defined( __linux__ )
+    }
+
+
+    //! \brief  Builds placements that put each thread on its own physical core.
+    //! \param  placements [out] -
+    //!         Array that receives one placement per thread.
+    //! \param  placementCount [in] -
+    //!         The number of entries within the placements array.
+    //! \return The number of physical cores found, or 0 if the topology could not be read.
+    //!
+    //! The processor topology is read from /sys. Threads are given the first logical processor
+    //! of each physical core in turn, along with the NUMA node the core belongs to. When there
+    //! are more threads than physical cores, the placements wrap around to the first core again.
+    //! Placements are reset to the default when the topology is not available.
+    size_t getPhysicalCorePlacements(ThreadPlacement *placements, size_t placementCount) {
+        for (size_t loop = 0; loop < placementCount; ++loop) {
+            resetThreadPlacement(placements[loop]);
+        }
+
+#if defined( __linux__ )
+        CoreSet onlineCores;
+        if (!ReadCoreList("/sys/devices/system/cpu/online", onlineCores)) {
+            return 0;
+        }
+
+        // Logical processors that share a physical core with a processor we have already chosen
+        CoreSet siblingCores;
+        size_t physicalCores[RAIZE_MAXIMUM_CORES];
+        int physicalNodes[RAIZE_MAXIMUM_CORES];
+        size_t physicalCount = 0;
+
+        for (size_t core = 0; core < onlineCores.size(); ++core) {
+            if (!onlineCores.test(core) || siblingCores.test(core)) {
+                continue;
+            }
+
+            char path[128];
+            snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/topology/thread_siblings_list", static_cast< unsigned int >(core));
+
+            CoreSet threadSiblings;
+            if (ReadCoreList(path, threadSiblings)) {
+                siblingCores |= threadSiblings;
+            }
+
+            physicalNodes[physicalCount] = kRaizeAnyNumaNode;
+            for (int node = 0; node < 64; ++node) {
+                snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/node%d/cpumap", static_cast< unsigned int >(core), node);
+
+                FILE *file = fopen(path, "r");
+                if (nullptr != file) {
+                    fclose(file);
+                    physicalNodes[physicalCount] = node;
+                    break;
+                }
+            }
+
+            physicalCores[physicalCount++] = core;
+        }
+
+        if (0 == physicalCount) {
+            return 0;
+        }
+
+        for (size_t loop = 0; loop < placementCount; ++loop) {
+            placements[loop].cores.set(physicalCores[loop % physicalCount]);
+            placements[loop].numaNode = physicalNodes[loop % physicalCount];
+        }
+
+        return physicalCount;
+#else
+        return 0;
+#endif //defined( __linux__ )
+    }
+
+    // -----------------------------------------------------------------------------------
+
+} // namespace raize
@@ -0,0 +1,164 @@
+//
+// Copyright 2017 nfactorial
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <cassert>
+#include <cinttypes>
+#include "trace_buffer.h"
+
+
+// -----------------------------------------------------------------------------------
+
+namespace raize {
+    //! Name given to the events of each kTraceEvent within the exported trace.
+    static const char *const kRaizeTraceEventNames[] = {
+        "Task",
+        "Spawned",
+        "Range",
+        "Frame",
+    };
+
+
+    // -----------------------------------------------------------------------------------
+
+    TraceBuffer::TraceBuffer()
+    : m_capacityMask(0)
+    , m_recorded(0)
+    {
+    }
+
+    TraceBuffer::~TraceBuffer() {
+    }
+
+
+    //! \brief  Allocates storage for the events recorded by the buffer.
+    //! \param  eventCapacity [in] -
+    //!         The number of events the buffer holds, rounded up to a power of two.
+    //! \return <em>True</em> if the buffer was initialized otherwise <em>false</em> if the capacity is 0.
+    bool TraceBuffer::initialize(size_t eventCapacity) {
+        if (0 == eventCapacity) {
+            return false;
+        }
+
+        size_t capacity = 1;
+        while (capacity < eventCapacity) {
+            capacity <<= 1;
+        }
+
+        m_events.reset(new TraceEvent[capacity]);
+        m_capacityMask = capacity - 1;
+
+        clear();
+        return true;
+    }
+
+
+    //! \brief  Releases the storage used by the buffer, no further events may be recorded.
+    void TraceBuffer::shutdown() {
+        m_events.reset();
+        m_capacityMask = 0;
+
+        clear();
+    }
+
+
+    //! \brief  Discards every event held by the buffer.
+    void TraceBuffer::clear() {
+        m_recorded.store(0, std::memory_order_release);
+    }
+
+
+    //! \brief  Writes the events recorded by a set of buffers as a Chrome trace, viewable with chrome://tracing or Perfetto.
+    //! \param  file [in] -
+    //!         The file the JSON trace is written to.
+    //! \param  buffers [in] -
+    //!         The buffers whose events are written, entries may be <em>nullptr</em>.
+    //! \param  bufferCount [in] -
+    //!         The number of entries within the buffers array.
+    //! \param  firstFrame [in] -
+    //!         Events belonging to frames before this frame are not written.
+    //! \return <em>True</em> if the trace was written otherwise <em>false</em> if an error occurred writing the file.
+    //!
+    //! Each execution context is shown as a thread within the trace. Times are written relative
+    //! to the earliest event written, in microseconds as required by the trace format.
+    bool writeChromeTrace(FILE *file, const TraceBuffer *const *buffers, size_t bufferCount, uint32_t firstFrame) {
+        assert(nullptr != file);
+
+        uint64_t baseNano = UINT64_MAX;
+        for (size_t buffer = 0; buffer < bufferCount; ++buffer) {
+            if (nullptr == buffers[buffer]) {
+                continue;
+            }
+
+            for (size_t loop = 0; loop < buffers[buffer]->getEventCount(); ++loop) {
+                const TraceEvent &traceEvent = buffers[buffer]->getEvent(loop);
+                if (traceEvent.frame >= firstFrame && traceEvent.beginNano < baseNano) {
+                    baseNano = traceEvent.beginNano;
+                }
+            }
+        }
+
+        bool written = (0 <= fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":["));
+        const char *separator = "";
+
+        for (size_t buffer = 0; buffer < bufferCount; ++buffer) {
+            if (nullptr == buffers[buffer]) {
+                continue;
+            }
+
+            bool named = false;
+            for (size_t loop = 0; loop < buffers[buffer]->getEventCount(); ++loop) {
+                const TraceEvent &traceEvent = buffers[buffer]->getEvent(loop);
+                if (traceEvent.frame < firstFrame) {
+                    continue;
+                }
+
+                assert(traceEvent.kind <= kTraceEvent_Frame);
+
+                // Every event within a buffer belongs to the same row, which is named by the first event written
+                if (!named) {
+                    if (kTraceEvent_Frame == traceEvent.kind) {
+                        written &= (0 <= fprintf(file, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"Frames\"}}", separator, traceEvent.contextId));
+                    } else {
+                        written &= (0 <= fprintf(file, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"Context %u\"}}", separator, traceEvent.contextId, traceEvent.contextId));
+                    }
+
+                    separator = ",";
+                    named = true;
+                }
+
+                const uint64_t beginNano = traceEvent.beginNano - baseNano;
+                const uint64_t durationNano = traceEvent.endNano - traceEvent.beginNano;
+
+                written &= (0 <= fprintf(file, "%s\n{\"name\":\"%s %u\",\"cat\":\"raize\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%" PRIu64 ".%03u,\"dur\":%" PRIu64 ".%03u,\"args\":{\"frame\":%u}}",
+                                        separator,
+                                        kRaizeTraceEventNames[traceEvent.kind],
+                                        (kTraceEvent_Frame == traceEvent.kind) ? traceEvent.frame : traceEvent.workId,
+                                        traceEvent.contextId,
+                                        beginNano / 1000, static_cast< unsigned int >(beginNano % 1000),
+                                        durationNano / 1000, static_cast< unsigned int >(durationNano % 1000),
+                                        traceEvent.frame));
+
+                separator = ",";
+            }
+        }
+
+        written &= (0 <= fprintf(file, "\n]}\n"));
+        return written;
+    }
+
+    // -----------------------------------------------------------------------------------
+
+} // namespace raize
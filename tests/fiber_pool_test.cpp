@@ -0,0 +1,75 @@
+//
+// Copyright 2017 nfactorial
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "gtest/gtest.h"
+#include "fiber_pool.h"
+
+#if defined( __linux__ )
+
+struct FiberSteps {
+    raize::Fiber *fiber;
+    int steps;
+};
+
+// Records each step it reaches, suspending between the steps
+static void TestFiber_Steps(void *argument)
+{
+    FiberSteps *state = static_cast< FiberSteps* >(argument);
+
+    state->steps++;
+    raize::FiberPool::suspend(state->fiber);
+    state->steps++;
+}
+
+TEST(FiberPool, Initialize) {
+    raize::FiberPool fiberPool;
+
+    EXPECT_FALSE(fiberPool.isInitialized());
+    EXPECT_FALSE(fiberPool.initialize(0, 65536));
+    EXPECT_FALSE(fiberPool.initialize(2, 16));
+    EXPECT_TRUE(fiberPool.initialize(2, 65536));
+    EXPECT_EQ(2, fiberPool.getFiberCount());
+
+    EXPECT_NE(nullptr, fiberPool.acquire());
+    EXPECT_NE(nullptr, fiberPool.acquire());
+    EXPECT_EQ(nullptr, fiberPool.acquire());
+}
+
+TEST(FiberPool, SuspendResume) {
+    raize::FiberPool fiberPool;
+
+    EXPECT_TRUE(fiberPool.initialize(1, 65536));
+
+    FiberSteps state = {fiberPool.acquire(), 0};
+
+    ASSERT_NE(nullptr, state.fiber);
+
+    // The fiber is reused once it has finished, it must start from the beginning again
+    for (int run = 0; run < 2; ++run) {
+        state.steps = 0;
+
+        fiberPool.start(state.fiber, TestFiber_Steps, &state);
+        EXPECT_EQ(1, state.steps);
+        EXPECT_FALSE(state.fiber->finished);
+
+        fiberPool.resume(state.fiber);
+        EXPECT_EQ(2, state.steps);
+        EXPECT_TRUE(state.fiber->finished);
+    }
+
+    fiberPool.release(state.fiber);
+}
+
+#endif //defined( __linux__ )
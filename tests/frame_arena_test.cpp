@@ -0,0 +1,80 @@
+//
+// Copyright 2017 nfactorial
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "frame_arena.h"
+
+TEST(FrameArena, Allocate) {
+    raize::FrameArena frameArena;
+
+    EXPECT_EQ(nullptr, frameArena.allocate(16));
+    EXPECT_FALSE(frameArena.initialize(0));
+    EXPECT_TRUE(frameArena.initialize(1024));
+    EXPECT_EQ(1024, frameArena.getCapacity());
+
+    unsigned char *first = static_cast< unsigned char* >(frameArena.allocate(1));
+    unsigned char *second = static_cast< unsigned char* >(frameArena.allocate(8, 64));
+
+    ASSERT_NE(nullptr, first);
+    ASSERT_NE(nullptr, second);
+    EXPECT_EQ(0, reinterpret_cast< uintptr_t >(second) % 64);
+    EXPECT_GT(second, first);
+
+    // Exhausting the arena fails without disturbing the earlier allocations
+    EXPECT_EQ(nullptr, frameArena.allocate(1024));
+    EXPECT_NE(nullptr, frameArena.allocate(16));
+
+    const size_t used = frameArena.getUsed();
+    frameArena.reset();
+
+    EXPECT_EQ(0, frameArena.getUsed());
+    EXPECT_EQ(first, frameArena.allocate(1));
+
+    raize::ArenaStatistics arenaStatistics;
+    frameArena.getStatistics(arenaStatistics);
+
+    EXPECT_EQ(1024, arenaStatistics.capacity);
+    EXPECT_EQ(used, arenaStatistics.highWater);
+    EXPECT_EQ(1, arenaStatistics.failedAllocations);
+
+    // A smaller frame does not lower the high-water mark
+    frameArena.reset();
+    frameArena.getStatistics(arenaStatistics);
+    EXPECT_EQ(used, arenaStatistics.highWater);
+
+    frameArena.resetStatistics();
+    frameArena.getStatistics(arenaStatistics);
+    EXPECT_EQ(0, arenaStatistics.highWater);
+    EXPECT_EQ(0, arenaStatistics.failedAllocations);
+
+    frameArena.shutdown();
+    EXPECT_FALSE(frameArena.isInitialized());
+}
+
+// Huge pages are a request, the arena must work whether or not the system provides them.
+TEST(FrameArena, HugePages) {
+    raize::FrameArena frameArena;
+
+    EXPECT_TRUE(frameArena.initialize(64 * 1024, true));
+
+    void *memory = frameArena.allocate(64 * 1024, 1);
+    ASSERT_NE(nullptr, memory);
+    memset(memory, 0xff, 64 * 1024);
+
+    frameArena.shutdown();
+}
@@ -0,0 +1,45 @@
+//
+// Copyright 2017 nfactorial
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <chrono>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "performance_timer.h"
+
+// Whichever clock the timer selects, it must agree with the steady clock.
+TEST(PerformanceTimer, Calibrate) {
+    const bool tscEnabled = raize::PerformanceTimer::calibrate();
+
+    EXPECT_EQ(tscEnabled, raize::PerformanceTimer::isTscEnabled());
+    EXPECT_EQ(tscEnabled, raize::PerformanceTimer::calibrate());
+
+    const std::chrono::steady_clock::time_point clockBegin = std::chrono::steady_clock::now();
+    const uint64_t timeBegin = raize::PerformanceTimer::getTimeNano();
+    const raize::PerformanceTimer timer;
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    const uint64_t elapsedNano = timer.getElapsedTimeNano();
+    const uint64_t timeEnd = raize::PerformanceTimer::getTimeNano();
+    const uint64_t clockNano = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - clockBegin).count();
+
+    EXPECT_GE(elapsedNano, 20000000);
+    EXPECT_LE(elapsedNano, clockNano + clockNano / 100);
+    EXPECT_GE(timeEnd - timeBegin, elapsedNano - elapsedNano / 100);
+    EXPECT_LE(timeEnd - timeBegin, clockNano + clockNano / 100);
+    EXPECT_EQ(elapsedNano / 1000000, timer.getElapsedTimeMilli());
+}
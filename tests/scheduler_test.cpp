@@ -17,8 +17,13 @@
 #include <chrono>
 #include <thread>
 #include <atomic>
+#include <cstdio>
+#include <string>
+#include <cstring>
+#include <vector>
 
 #include "gtest/gtest.h"
+#include "profiler.h"
 #include "scheduler.h"
 
 // Tests the scheduler with a single task. Ensures the scheduler behaves correctly if
@@ -100,16 +105,64 @@ TEST(Scheduler, SingleTask) {
 // NOTE: The API for creating tasks is only in the preliminary stages and will likely change
 //       significantly in the future.
 
-/* TODO: The timeout works correctly, but we do not terminate the threads that have hung at the moment.
+// The frame is left in flight when it times out, shutting down waits for the hung task to return.
 TEST(Scheduler, TimeoutTask) {
     raize::Scheduler scheduler;
 
     EXPECT_TRUE(scheduler.initialize());
     EXPECT_TRUE(scheduler.createTask(TestTask_TimeoutFunc));
+    EXPECT_FALSE(scheduler.execute(5));
+
+    // The task list still belongs to the hung frame, so creating a task waits for it to complete
+    taskCounter.store(0);
+    EXPECT_TRUE(scheduler.createTask(TestTask_ExecuteFunc));
+    EXPECT_EQ(1, taskCounter.load());
+
     EXPECT_FALSE(scheduler.execute(5));
     scheduler.shutdown();
 }
-*/
+
+static std::atomic<bool> workerHangStarted(false);
+
+// Hangs when executed by a worker. The participating caller (the final context) instead waits
+// for a worker to begin hanging, so the caller can never take every task for itself.
+static void TestTask_WorkerTimeoutFunc()
+{
+    const raize::ExecutionContext *executionContext = raize::Scheduler::getCurrentContext();
+
+    if (0 == executionContext->contextId) {
+        workerHangStarted.store(true);
+        TestTask_TimeoutFunc();
+    } else {
+        while (!workerHangStarted.load()) {
+            std::this_thread::yield();
+        }
+
+        taskCounter++;
+    }
+}
+
+// A participating caller stops once no task is ready, so the time out covers a hung worker.
+TEST(Scheduler, TimeoutTaskParticipate) {
+    raize::Scheduler scheduler;
+
+    EXPECT_TRUE(scheduler.initialize(2, raize::kCallerMode_Participate));
+    EXPECT_TRUE(scheduler.createTask(TestTask_WorkerTimeoutFunc));
+    EXPECT_TRUE(scheduler.createTask(TestTask_WorkerTimeoutFunc));
+
+    taskCounter.store(0);
+    workerHangStarted.store(false);
+
+    EXPECT_FALSE(scheduler.execute(5));
+    EXPECT_GT(2, taskCounter.load());
+
+    // The next frame completes the one left in flight before it begins
+    workerHangStarted.store(false);
+    EXPECT_TRUE(scheduler.execute());
+    EXPECT_EQ(4, taskCounter.load());
+
+    scheduler.shutdown();
+}
 
 // NOTE: The API for creating tasks is only in the preliminary stages and will likely change
 //       significantly in the future.
@@ -155,3 +208,1025 @@ TEST(Scheduler, MassTask) {
 
     scheduler.shutdown();
 }
+
+TEST(Scheduler, BatchedMassTask) {
+    raize::Scheduler scheduler;
+
+    EXPECT_TRUE(scheduler.initialize());
+    scheduler.setTaskClaimMode(raize::kTaskClaimMode_Batched);
+
+    const size_t threadCount = scheduler.getThreadCount();
+    const unsigned int taskCount = static_cast< unsigned int >(threadCount * 30);
+
+    for (size_t loop = 0; loop < taskCount; ++loop) {
+        EXPECT_TRUE(scheduler.createTask(TestTask_ExecuteFunc));
+    }
+
+    taskCounter.store(0);
+
+    EXPECT_TRUE(scheduler.execute());
+    EXPECT_EQ(taskCounter, threadCount * 30);
+
+    scheduler.shutdown();
+}
+
+// Tasks for the dependency tests, each layer checks the previous layer has completed in full.
+static const size_t kLayerWidth = 8;
+
+std::atomic<size_t> layerCounters[3];
+std::atomic<size_t> layerFailures(0);
+
+static void TestTask_Layer0()
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    layerCounters[0]++;
+}
+
+static void TestTask_Layer1()
+{
+    if (kLayerWidth != layerCounters[0].load())
+        layerFailures++;
+
+    layerCounters[1]++;
+}
+
+static void TestTask_Layer2()
+{
+    if (kLayerWidth != layerCounters[1].load())
+        layerFailures++;
+
+    layerCounters[2]++;
+}
+
+// Builds three layers of tasks, each depending on every task in the previous layer, and
+// ensures the whole graph runs in order within a single execute.
+static void ExecuteLayeredGraph(raize::kTaskClaimMode claimMode) {
+    raize::Scheduler scheduler;
+
+    EXPECT_TRUE(scheduler.initialize());
+    scheduler.setTaskClaimMode(claimMode);
+
+    raize::TaskId layer0[kLayerWidth];
+    raize::TaskId layer1[kLayerWidth];
+
+    for (size_t loop = 0; loop < kLayerWidth; ++loop) {
+        EXPECT_TRUE(scheduler.createTask(TestTask_Layer0, &layer0[loop]));
+    }
+
+    for (size_t loop = 0; loop < kLayerWidth; ++loop) {
+        EXPECT_TRUE(scheduler.createTask(TestTask_Layer1, layer0, kLayerWidth, &layer1[loop]));
+    }
+
+    for (size_t loop = 0; loop < kLayerWidth; ++loop) {
+        EXPECT_TRUE(scheduler.createTask(TestTask_Layer2, layer1, kLayerWidth, nullptr));
+    }
+
+    // A task may only depend upon tasks that already exist
+    const raize::TaskId futureTask = static_cast< raize::TaskId >(kLayerWidth * 3);
+    EXPECT_FALSE(scheduler.createTask(TestTask_Layer2, &futureTask, 1, nullptr));
+
+    layerFailures.store(0);
+
+    for (size_t frame = 0; frame < 3; ++frame) {
+        for (size_t loop = 0; loop < 3; ++loop) {
+            layerCounters[loop].store(0);
+        }
+
+        EXPECT_TRUE(scheduler.execute());
+        EXPECT_EQ(kLayerWidth, layerCounters[2].load());
+        EXPECT_EQ(0, layerFailures.load());
+    }
+
+    scheduler.shutdown();
+}
+
+TEST(Scheduler, Dependencies) {
+    ExecuteLayeredGraph(raize::kTaskClaimMode_WorkStealing);
+}
+
+TEST(Scheduler, BatchedDependencies) {
+    ExecuteLayeredGraph(raize::kTaskClaimMode_Batched);
+}
+
+// Tasks for the resource access test, these track how many readers and writers are active
+// at once. A writer must always run alone.
+std::atomic<size_t> activeReaders(0);
+std::atomic<size_t> activeWriters(0);
+std::atomic<size_t> accessFailures(0);
+std::atomic<size_t> accessCounter(0);
+
+static void TestTask_ReadResource()
+{
+    activeReaders++;
+    if (0 != activeWriters.load())
+        accessFailures++;
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    activeReaders--;
+    accessCounter++;
+}
+
+static void TestTask_WriteResource()
+{
+    if (1 != ++activeWriters || 0 != activeReaders.load())
+        accessFailures++;
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    activeWriters--;
+    accessCounter++;
+}
+
+TEST(Scheduler, ResourceAccess) {
+    raize::Scheduler scheduler;
+
+    EXPECT_TRUE(scheduler.initialize());
+
+    const raize::ResourceId resource = 42;
+    const raize::ResourceAccess readAccess = {resource, raize::kResourceAccess_Read};
+    const raize::ResourceAccess writeAccess = {resource, raize::kResourceAccess_Write};
+
+    size_t taskCount = 0;
+    for (size_t batch = 0; batch < 4; ++batch) {
+        EXPECT_TRUE(scheduler.createTask(TestTask_WriteResource, nullptr, 0, &writeAccess, 1, nullptr));
+        EXPECT_TRUE(scheduler.createTask(TestTask_WriteResource, nullptr, 0, &writeAccess, 1, nullptr));
+        taskCount += 2;
+
+        for (size_t loop = 0; loop < 6; ++loop) {
+            EXPECT_TRUE(scheduler.createTask(TestTask_ReadResource, nullptr, 0, &readAccess, 1, nullptr));
+            taskCount++;
+        }
+    }
+
+    accessFailures.store(0);
+    accessCounter.store(0);
+
+    EXPECT_TRUE(scheduler.execute());
+    EXPECT_EQ(taskCount, accessCounter.load());
+    EXPECT_EQ(0, accessFailures.load());
+
+    scheduler.shutdown();
+}
+
+// Range used by the parallelFor test, every index must be visited exactly once per frame
+// and the dependent task must only run once the entire range has completed.
+static const size_t kRangeSize = 10000;
+
+std::atomic<uint32_t> rangeVisits[kRangeSize];
+std::atomic<size_t> rangeFailures(0);
+std::atomic<size_t> rangeFrames(0);
+
+static void TestTask_VisitRange(size_t begin, size_t end)
+{
+    for (size_t loop = begin; loop < end; ++loop)
+        rangeVisits[loop]++;
+}
+
+static void TestTask_CheckRange()
+{
+    const uint32_t expected = static_cast< uint32_t >(++rangeFrames);
+
+    for (size_t loop = 0; loop < kRangeSize; ++loop) {
+        if (expected != rangeVisits[loop].load())
+            rangeFailures++;
+    }
+}
+
+TEST(Scheduler, ParallelFor) {
+    raize::Scheduler scheduler;
+
+    EXPECT_TRUE(scheduler.initialize());
+
+    for (size_t loop = 0; loop < kRangeSize; ++loop)
+        rangeVisits[loop].store(0);
+
+    rangeFailures.store(0);
+    rangeFrames.store(0);
+
+    raize::TaskId rangeTask = raize::kInvalidTaskId;
+    EXPECT_TRUE(scheduler.parallelFor(0, kRangeSize, 16, TestTask_VisitRange, nullptr, 0, &rangeTask));
+    EXPECT_TRUE(scheduler.createTask(TestTask_CheckRange, &rangeTask, 1, nullptr));
+
+    for (size_t frame = 0; frame < 4; ++frame)
+        EXPECT_TRUE(scheduler.execute());
+
+    EXPECT_EQ(4, rangeFrames.load());
+    EXPECT_EQ(0, rangeFailures.load());
+
+    scheduler.shutdown();
+}
+
+// Payload tasks write their index into the output array, sharing one function between all
+// the tasks. Half the tasks are created from a lambda and half from a plain payload.
+static const size_t kPayloadTaskCount = 64;
+
+std::atomic<size_t> payloadOutput[kPayloadTaskCount];
+
+struct PayloadData {
+    size_t index;
+    size_t value;
+};
+
+static void TestTask_Payload(void *payload)
+{
+    const PayloadData *payloadData = static_cast< const PayloadData* >(payload);
+    payloadOutput[payloadData->index].store(payloadData->value);
+}
+
+TEST(Scheduler, Payload) {
+    raize::Scheduler scheduler;
+
+    EXPECT_TRUE(scheduler.initialize());
+
+    for (size_t loop = 0; loop < kPayloadTaskCount; ++loop) {
+        payloadOutput[loop].store(0);
+
+        if (0 == (loop & 1)) {
+            const PayloadData payloadData = {loop, loop + 1};
+            EXPECT_TRUE(scheduler.createTask(TestTask_Payload, &payloadData, sizeof(payloadData), nullptr));
+        } else {
+            std::atomic<size_t> *output = &payloadOutput[loop];
+            const size_t value = loop + 1;
+
+            EXPECT_TRUE(scheduler.createTask([output, value]() { output->store(value); }));
+        }
+    }
+
+    EXPECT_TRUE(scheduler.execute());
+
+    for (size_t loop = 0; loop < kPayloadTaskCount; ++loop)
+        EXPECT_EQ(loop + 1, payloadOutput[loop].load());
+
+    scheduler.shutdown();
+}
+
+// Records the tasks executed by the thread that called Scheduler::execute().
+std::thread::id callerThread;
+std::atomic<size_t> callerTasks(0);
+
+static void TestTask_RecordCaller()
+{
+    if (std::this_thread::get_id() == callerThread)
+        callerTasks++;
+
+    taskCounter++;
+}
+
+TEST(Scheduler, CallerParticipates) {
+    raize::Scheduler scheduler;
+
+    EXPECT_TRUE(scheduler.initialize(4, raize::kCallerMode_Participate));
+    EXPECT_EQ(4, scheduler.getThreadCount());
+    EXPECT_EQ(3, scheduler.getWorkerCount());
+
+    for (size_t loop = 0; loop < 120; ++loop) {
+        EXPECT_TRUE(scheduler.createTask(TestTask_RecordCaller));
+    }
+
+    callerThread = std::this_thread::get_id();
+
+    for (size_t frame = 0; frame < 3; ++frame) {
+        taskCounter.store(0);
+
+        EXPECT_TRUE(scheduler.execute());
+        EXPECT_EQ(120, taskCounter.load());
+    }
+
+    scheduler.shutdown();
+}
+
+// With a single thread, no workers are created and the caller must process every task.
+TEST(Scheduler, CallerOnly) {
+    raize::Scheduler scheduler;
+
+    EXPECT_TRUE(scheduler.initialize(1, raize::kCallerMode_Participate));
+    EXPECT_EQ(0, scheduler.getWorkerCount());
+
+    for (size_t loop = 0; loop < 16; ++loop) {
+        EXPECT_TRUE(scheduler.createTask(TestTask_RecordCaller));
+    }
+
+    callerThread = std::this_thread::get_id();
+    callerTasks.store(0);
+    taskCounter.store(0);
+
+    EXPECT_TRUE(scheduler.execute());
+    EXPECT_EQ(16, taskCounter.load());
+    EXPECT_EQ(16, callerTasks.load());
+
+    scheduler.shutdown();
+}
+
+// Runs several frames with each wait policy, every wake must be recorded against one of the
+// methods a worker uses to wait.
+static void ExecuteWithWaitPolicy(raize::kWaitPolicy waitPolicy) {
+    raize::Scheduler scheduler;
+
+    EXPECT_TRUE(scheduler.initialize());
+    scheduler.setWaitPolicy(waitPolicy, 100000);
+
+    for (size_t loop = 0; loop < 16; ++loop) {
+        EXPECT_TRUE(scheduler.createTask(TestTask_RecordCaller));
+    }
+
+    scheduler.resetWakeStatistics();
+
+    for (size_t frame = 0; frame < 8; ++frame) {
+        taskCounter.store(0);
+
+        EXPECT_TRUE(scheduler.execute());
+        EXPECT_EQ(16, taskCounter.load());
+    }
+
+    raize::WakeStatistics wakeStatistics;
+    scheduler.getWakeStatistics(wakeStatistics);
+
+    EXPECT_EQ(8 * scheduler.getWorkerCount(), wakeStatistics.wakeCount);
+    EXPECT_EQ(wakeStatistics.wakeCount, wakeStatistics.spinWakeCount + wakeStatistics.yieldWakeCount + wakeStatistics.blockWakeCount);
+    EXPECT_GE(wakeStatistics.totalLatencyNano, wakeStatistics.maximumLatencyNano);
+
+    if (raize::kWaitPolicy_Block == waitPolicy) {
+        EXPECT_EQ(wakeStatistics.wakeCount, wakeStatistics.blockWakeCount);
+    }
+
+    scheduler.shutdown();
+}
+
+TEST(Scheduler, BlockingWait) {
+    ExecuteWithWaitPolicy(raize::kWaitPolicy_Block);
+}
+
+TEST(Scheduler, SpinningWait) {
+    ExecuteWithWaitPolicy(raize::kWaitPolicy_Spin);
+}
+
+TEST(Scheduler, AdaptiveWait) {
+    ExecuteWithWaitPolicy(raize::kWaitPolicy_Adaptive);
+}
+
+// Executes a large number of very short frames, a lost wakeup would stall a frame until
+// the execution timeout expired and cause execute() to fail.
+static void TestTask_Count()
+{
+    taskCounter++;
+}
+
+static void ExecuteManyFrames(raize::kCallerMode callerMode) {
+    raize::Scheduler scheduler;
+
+    EXPECT_TRUE(scheduler.initialize(RAIZE_SCHEDULER_MAXIMUM_THREADS, callerMode));
+
+    for (size_t loop = 0; loop < 8; ++loop) {
+        EXPECT_TRUE(scheduler.createTask(TestTask_Count));
+    }
+
+    taskCounter.store(0);
+
+    for (size_t frame = 0; frame < 2000; ++frame) {
+        if (!scheduler.execute()) {
+            ADD_FAILURE() << "Frame " << frame << " failed to complete";
+            break;
+        }
+    }
+
+    EXPECT_EQ(2000 * 8, taskCounter.load());
+
+    scheduler.shutdown();
+}
+
+TEST(Scheduler, ManyFrames) {
+    ExecuteManyFrames(raize::kCallerMode_Wait);
+}
+
+TEST(Scheduler, ManyFramesWithCaller) {
+    ExecuteManyFrames(raize::kCallerMode_Participate);
+}
+
+// Places every worker upon its own physical core, the tasks must still all be processed.
+TEST(Scheduler, ThreadPlacement) {
+    raize::Scheduler scheduler;
+    raize::ThreadPlacement placements[RAIZE_SCHEDULER_MAXIMUM_THREADS];
+
+    raize::getPhysicalCorePlacements(placements, RAIZE_SCHEDULER_MAXIMUM_THREADS);
+
+    EXPECT_TRUE(scheduler.initialize(RAIZE_SCHEDULER_MAXIMUM_THREADS, raize::kCallerMode_Wait, placements));
+
+    for (size_t loop = 0; loop < 32; ++loop) {
+        EXPECT_TRUE(scheduler.createTask(TestTask_Count));
+    }
+
+    taskCounter.store(0);
+
+    EXPECT_TRUE(scheduler.execute());
+    EXPECT_EQ(32, taskCounter.load());
+
+    scheduler.shutdown();
+}
+
+// Critical tasks are created after the low priority tasks, yet must complete earlier on average.
+TEST(Scheduler, Priority) {
+    raize::Scheduler scheduler;
+
+    EXPECT_TRUE(scheduler.initialize(1, raize::kCallerMode_Participate));
+
+    for (size_t loop = 0; loop < 16; ++loop) {
+        EXPECT_TRUE(scheduler.createTask(TestTask_Count, raize::kTaskPriority_Low, nullptr));
+    }
+
+    for (size_t loop = 0; loop < 16; ++loop) {
+        EXPECT_TRUE(scheduler.createTask([]() { taskCounter++; }, raize::kTaskPriority_Critical, nullptr));
+    }
+
+    // An invalid priority is rejected without leaving a task behind
+    raize::TaskId invalidId = raize::kInvalidTaskId;
+    EXPECT_FALSE(scheduler.createTask(TestTask_Count, raize::kTaskPriority_Count, &invalidId));
+    EXPECT_FALSE(scheduler.createTask([]() { taskCounter++; }, raize::kTaskPriority_Count, &invalidId));
+    EXPECT_EQ(raize::kInvalidTaskId, invalidId);
+
+    taskCounter.store(0);
+    scheduler.resetPriorityStatistics();
+
+    EXPECT_TRUE(scheduler.execute());
+    EXPECT_EQ(32, taskCounter.load());
+
+    raize::PriorityStatistics critical;
+    raize::PriorityStatistics low;
+
+    scheduler.getPriorityStatistics(raize::kTaskPriority_Critical, critical);
+    scheduler.getPriorityStatistics(raize::kTaskPriority_Low, low);
+
+    EXPECT_EQ(16, critical.taskCount);
+    EXPECT_EQ(16, low.taskCount);
+    EXPECT_LE(critical.totalCompletionNano, low.totalCompletionNano);
+
+    scheduler.shutdown();
+}
+
+static std::atomic<bool> frameGate(false);
+
+// Waits until the test opens the gate, giving up after a few seconds so a failing test still ends.
+static void TestTask_WaitGate()
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+
+    while (!frameGate.load() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+// Builds each frame whilst the previous frame is being processed by the worker threads.
+static void ExecuteAsyncFrames(size_t threadCount, raize::kCallerMode callerMode) {
+    raize::Scheduler scheduler;
+
+    EXPECT_TRUE(scheduler.initialize(threadCount, callerMode));
+
+    raize::FrameHandle frameHandle;
+
+    // Building the next frame must not wait for the frame being processed
+    if (0 != scheduler.getWorkerCount()) {
+        frameGate.store(false);
+
+        EXPECT_TRUE(scheduler.createTask(TestTask_WaitGate));
+        EXPECT_TRUE(scheduler.executeAsync(frameHandle));
+
+        for (size_t loop = 0; loop < 8; ++loop) {
+            EXPECT_TRUE(scheduler.createTask(TestTask_Count));
+        }
+
+        EXPECT_FALSE(scheduler.isFrameComplete(frameHandle));
+
+        frameGate.store(true);
+        EXPECT_TRUE(scheduler.waitFrame(frameHandle));
+        EXPECT_TRUE(scheduler.executeAsync(frameHandle));
+        EXPECT_TRUE(scheduler.waitFrame(frameHandle));
+    }
+
+    taskCounter.store(0);
+
+    for (size_t frame = 0; frame < 100; ++frame) {
+        for (size_t loop = 0; loop < 8; ++loop) {
+            EXPECT_TRUE(scheduler.createTask(TestTask_Count));
+        }
+
+        if (!scheduler.executeAsync(frameHandle)) {
+            ADD_FAILURE() << "Frame " << frame << " failed to submit";
+            break;
+        }
+    }
+
+    EXPECT_TRUE(scheduler.waitFrame(frameHandle));
+    EXPECT_TRUE(scheduler.isFrameComplete(frameHandle));
+    EXPECT_EQ(100 * 8, taskCounter.load());
+
+    // Submitted tasks are not replayed, execute() only processes tasks created since the final submission
+    EXPECT_TRUE(scheduler.createTask(TestTask_Count));
+    EXPECT_TRUE(scheduler.execute());
+    EXPECT_EQ(100 * 8 + 1, taskCounter.load());
+
+    scheduler.shutdown();
+}
+
+TEST(Scheduler, ExecuteAsync) {
+    ExecuteAsyncFrames(RAIZE_SCHEDULER_MAXIMUM_THREADS, raize::kCallerMode_Wait);
+}
+
+TEST(Scheduler, ExecuteAsyncWithCaller) {
+    ExecuteAsyncFrames(RAIZE_SCHEDULER_MAXIMUM_THREADS, raize::kCallerMode_Participate);
+    ExecuteAsyncFrames(1, raize::kCallerMode_Participate);
+}
+
+// Each task spawns two children until the depth is exhausted, the successor of the root
+// task must not run until the entire tree has been processed.
+static std::atomic<unsigned int> spawnCounter;
+static std::atomic<unsigned int> spawnObserved;
+
+struct SubdivideParams {
+    uint32_t depth;
+};
+
+static void TestTask_Subdivide(void *payload)
+{
+    const SubdivideParams *params = static_cast< const SubdivideParams* >(payload);
+
+    spawnCounter++;
+
+    if (0 != params->depth) {
+        const SubdivideParams childParams = {params->depth - 1};
+
+        EXPECT_TRUE(raize::Scheduler::spawnTask(TestTask_Subdivide, &childParams, sizeof(childParams)));
+        EXPECT_TRUE(raize::Scheduler::spawnTask(TestTask_Subdivide, &childParams, sizeof(childParams)));
+    }
+}
+
+static void TestTask_ObserveSpawns()
+{
+    spawnObserved.store(spawnCounter.load());
+}
+
+TEST(Scheduler, SpawnTask) {
+    raize::Scheduler scheduler;
+
+    EXPECT_FALSE(raize::Scheduler::spawnTask(TestTask_Count));
+    EXPECT_TRUE(scheduler.initialize(RAIZE_SCHEDULER_MAXIMUM_THREADS));
+
+    const SubdivideParams params = {6};
+    raize::TaskId rootId;
+
+    EXPECT_TRUE(scheduler.createTask(TestTask_Subdivide, &params, sizeof(params), &rootId));
+    EXPECT_TRUE(scheduler.createTask(TestTask_ObserveSpawns, &rootId, 1, nullptr));
+
+    for (size_t frame = 0; frame < 20; ++frame) {
+        scheduler.setTaskClaimMode((frame & 1) ? raize::kTaskClaimMode_Batched : raize::kTaskClaimMode_WorkStealing);
+
+        spawnCounter.store(0);
+        spawnObserved.store(0);
+
+        EXPECT_TRUE(scheduler.execute());
+        EXPECT_EQ(127, spawnCounter.load());
+        EXPECT_EQ(127, spawnObserved.load());
+    }
+
+    scheduler.shutdown();
+}
+
+#if defined( __linux__ )
+
+// Each task spawns its children and waits for them to finish. With a single thread this can
+// only complete if the waiting tasks are suspended, allowing the thread to run their children.
+struct WaitParams {
+    uint32_t depth;
+    std::atomic<uint32_t> *parentCounter;
+};
+
+static void TestTask_SpawnAndWait(void *payload)
+{
+    const WaitParams *params = static_cast< const WaitParams* >(payload);
+
+    spawnCounter++;
+
+    if (0 != params->depth) {
+        std::atomic<uint32_t> childCounter(2);
+        const WaitParams childParams = {params->depth - 1, &childCounter};
+
+        EXPECT_TRUE(raize::Scheduler::spawnTask(TestTask_SpawnAndWait, &childParams, sizeof(childParams)));
+        EXPECT_TRUE(raize::Scheduler::spawnTask(TestTask_SpawnAndWait, &childParams, sizeof(childParams)));
+
+        raize::Scheduler::waitForCounter(childCounter);
+        EXPECT_EQ(0, childCounter.load());
+    }
+
+    if (nullptr != params->parentCounter) {
+        params->parentCounter->fetch_sub(1);
+    }
+}
+
+static void ExecuteFiberWait(size_t threadCount, raize::kCallerMode callerMode) {
+    raize::Scheduler scheduler;
+
+    EXPECT_TRUE(scheduler.initialize(threadCount, callerMode));
+    EXPECT_TRUE(scheduler.initializeFibers(64, 65536));
+
+    const WaitParams params = {4, nullptr};
+    EXPECT_TRUE(scheduler.createTask(TestTask_SpawnAndWait, &params, sizeof(params), nullptr));
+
+    for (size_t frame = 0; frame < 10; ++frame) {
+        spawnCounter.store(0);
+
+        EXPECT_TRUE(scheduler.execute());
+        EXPECT_EQ(31, spawnCounter.load());
+    }
+
+    scheduler.shutdown();
+}
+
+TEST(Scheduler, FiberWait) {
+    ExecuteFiberWait(1, raize::kCallerMode_Participate);
+    ExecuteFiberWait(RAIZE_SCHEDULER_MAXIMUM_THREADS, raize::kCallerMode_Wait);
+}
+#endif //defined( __linux__ )
+
+// Traces several frames, only the most recent frames should be written.
+TEST(Scheduler, Trace) {
+    raize::Scheduler scheduler;
+
+    EXPECT_TRUE(scheduler.initialize(2));
+    EXPECT_TRUE(scheduler.initializeTracing(256));
+
+    for (size_t loop = 0; loop < 8; ++loop) {
+        EXPECT_TRUE(scheduler.createTask(TestTask_Count));
+    }
+
+    for (size_t frame = 0; frame < 3; ++frame) {
+        EXPECT_TRUE(scheduler.execute());
+    }
+
+    FILE *file = tmpfile();
+    ASSERT_NE(nullptr, file);
+
+    EXPECT_TRUE(scheduler.writeTrace(file, 2));
+
+    std::string contents;
+    char block[256];
+    size_t bytesRead;
+
+    rewind(file);
+    while (0 != (bytesRead = fread(block, 1, sizeof(block), file))) {
+        contents.append(block, bytesRead);
+    }
+
+    fclose(file);
+
+    // Eight tasks and the frame itself for each of the two frames
+    size_t eventCount = 0;
+    for (size_t position = contents.find("\"ph\":\"X\""); std::string::npos != position; position = contents.find("\"ph\":\"X\"", position + 1)) {
+        eventCount++;
+    }
+
+    EXPECT_EQ(18, eventCount);
+    EXPECT_NE(std::string::npos, contents.find("\"name\":\"Frame 2\""));
+    EXPECT_EQ(std::string::npos, contents.find("\"name\":\"Frame 0\""));
+
+    scheduler.shutdown();
+}
+
+// Every frame and task should be measured, and the busy time of each context should add up.
+TEST(Scheduler, Statistics) {
+    raize::Scheduler scheduler;
+
+    EXPECT_TRUE(scheduler.initialize(2, raize::kCallerMode_Participate));
+
+    for (size_t loop = 0; loop < 8; ++loop) {
+        EXPECT_TRUE(scheduler.createTask(TestTask_ExecuteFunc));
+    }
+
+    for (size_t frame = 0; frame < 4; ++frame) {
+        EXPECT_TRUE(scheduler.execute());
+    }
+
+    raize::SchedulerStatistics statistics;
+    scheduler.getStatistics(statistics);
+
+    EXPECT_EQ(4, statistics.frameCount);
+    EXPECT_EQ(4, statistics.frameDuration.count);
+    EXPECT_EQ(32, statistics.taskDuration.count);
+    EXPECT_GE(statistics.taskDuration.p50Nano, 5000000);
+    EXPECT_GE(statistics.frameDuration.p50Nano, statistics.taskDuration.p50Nano);
+    EXPECT_GT(statistics.parallelSpeedup, 0.0);
+    EXPECT_LE(statistics.parallelSpeedup, 2.5);
+
+    uint64_t tasksProcessed = 0;
+    uint64_t busyNano = 0;
+    for (size_t loop = 0; loop < 2; ++loop) {
+        raize::ContextStatistics contextStatistics;
+
+        EXPECT_TRUE(scheduler.getContextStatistics(loop, contextStatistics));
+        tasksProcessed += contextStatistics.tasksProcessed;
+        busyNano += contextStatistics.busyNano;
+    }
+
+    raize::ContextStatistics contextStatistics;
+    EXPECT_FALSE(scheduler.getContextStatistics(2, contextStatistics));
+
+    EXPECT_EQ(32, tasksProcessed);
+    EXPECT_EQ(statistics.totalTaskNano, busyNano);
+
+    scheduler.resetStatistics();
+    scheduler.getStatistics(statistics);
+
+    EXPECT_EQ(0, statistics.frameCount);
+    EXPECT_EQ(0, statistics.taskDuration.count);
+
+    scheduler.shutdown();
+}
+
+// Registered tasks must survive the scheduler growing and shrinking between frames.
+static void ResizeFrames(raize::kCallerMode callerMode) {
+    raize::Scheduler scheduler;
+
+    // The maximum is deliberately larger than RAIZE_SCHEDULER_MAXIMUM_THREADS
+    EXPECT_TRUE(scheduler.initialize(2, RAIZE_SCHEDULER_MAXIMUM_THREADS * 2, callerMode, nullptr));
+    EXPECT_EQ(RAIZE_SCHEDULER_MAXIMUM_THREADS * 2, scheduler.getMaximumThreadCount());
+
+    const size_t callerThreads = (raize::kCallerMode_Participate == callerMode) ? 1 : 0;
+
+    taskCounter.store(0);
+
+    for (size_t loop = 0; loop < 16; ++loop) {
+        EXPECT_TRUE(scheduler.createTask(TestTask_Count));
+    }
+
+    EXPECT_TRUE(scheduler.execute());
+    EXPECT_EQ(16, taskCounter.load());
+
+    EXPECT_TRUE(scheduler.grow(RAIZE_SCHEDULER_MAXIMUM_THREADS * 2 - 2));
+    EXPECT_EQ(RAIZE_SCHEDULER_MAXIMUM_THREADS * 2, scheduler.getThreadCount());
+    EXPECT_EQ(RAIZE_SCHEDULER_MAXIMUM_THREADS * 2 - callerThreads, scheduler.getWorkerCount());
+    EXPECT_FALSE(scheduler.grow(1));
+
+    EXPECT_TRUE(scheduler.execute());
+    EXPECT_EQ(32, taskCounter.load());
+
+    EXPECT_FALSE(scheduler.shrink(RAIZE_SCHEDULER_MAXIMUM_THREADS * 2));
+    EXPECT_TRUE(scheduler.shrink(RAIZE_SCHEDULER_MAXIMUM_THREADS * 2 - 1));
+    EXPECT_EQ(1, scheduler.getThreadCount());
+    EXPECT_EQ(1 - callerThreads, scheduler.getWorkerCount());
+
+    raize::ContextStatistics contextStatistics;
+    EXPECT_TRUE(scheduler.getContextStatistics(0, contextStatistics));
+    EXPECT_FALSE(scheduler.getContextStatistics(1, contextStatistics));
+
+    EXPECT_TRUE(scheduler.execute());
+    EXPECT_EQ(48, taskCounter.load());
+
+    EXPECT_FALSE(scheduler.resize(0));
+    EXPECT_TRUE(scheduler.resize(3));
+    EXPECT_EQ(3, scheduler.getThreadCount());
+
+    // Resizing completes the frame still being processed
+    raize::FrameHandle frameHandle;
+    EXPECT_TRUE(scheduler.executeAsync(frameHandle));
+    EXPECT_TRUE(scheduler.resize(5));
+    EXPECT_TRUE(scheduler.isFrameComplete(frameHandle));
+    EXPECT_EQ(64, taskCounter.load());
+
+    raize::SchedulerStatistics statistics;
+    scheduler.getStatistics(statistics);
+    EXPECT_EQ(4, statistics.frameCount);
+
+    scheduler.shutdown();
+}
+
+TEST(Scheduler, Resize) {
+    ResizeFrames(raize::kCallerMode_Wait);
+}
+
+TEST(Scheduler, ResizeWithCaller) {
+    ResizeFrames(raize::kCallerMode_Participate);
+}
+
+// Each task takes scratch memory from its own contexts arena, which is released as the frame ends.
+static std::atomic<unsigned int> arenaFailures;
+
+static void TestTask_AllocateFrameMemory()
+{
+    raize::ExecutionContext *executionContext = raize::Scheduler::getCurrentContext();
+    if (nullptr == executionContext || nullptr == executionContext->frameArena) {
+        arenaFailures++;
+        return;
+    }
+
+    uint64_t *values = static_cast< uint64_t* >(raize::Scheduler::allocateFrameMemory(sizeof(uint64_t) * 64));
+    if (nullptr == values) {
+        arenaFailures++;
+        return;
+    }
+
+    for (size_t loop = 0; loop < 64; ++loop) {
+        values[loop] = loop;
+    }
+}
+
+TEST(Scheduler, FrameArena) {
+    raize::Scheduler scheduler;
+
+    EXPECT_EQ(nullptr, raize::Scheduler::getCurrentContext());
+    EXPECT_EQ(nullptr, raize::Scheduler::allocateFrameMemory(16));
+
+    EXPECT_TRUE(scheduler.initialize(2, raize::kCallerMode_Participate));
+    EXPECT_TRUE(scheduler.initializeArenas(8 * 1024));
+
+    arenaFailures.store(0);
+
+    // The frames allocate 32KB between them, more than both arenas hold, so each frame must release its memory
+    for (size_t loop = 0; loop < 8; ++loop) {
+        EXPECT_TRUE(scheduler.createTask(TestTask_AllocateFrameMemory));
+    }
+
+    for (size_t frame = 0; frame < 8; ++frame) {
+        EXPECT_TRUE(scheduler.execute());
+    }
+
+    EXPECT_EQ(0, arenaFailures.load());
+
+    size_t highWater = 0;
+    for (size_t loop = 0; loop < 2; ++loop) {
+        raize::ArenaStatistics arenaStatistics;
+
+        EXPECT_TRUE(scheduler.getArenaStatistics(loop, arenaStatistics));
+        EXPECT_EQ(8 * 1024, arenaStatistics.capacity);
+        EXPECT_EQ(0, arenaStatistics.failedAllocations);
+        EXPECT_LE(arenaStatistics.highWater, 8 * 512);
+
+        highWater += arenaStatistics.highWater;
+    }
+
+    // Every frame allocates the same amount, split between the contexts
+    EXPECT_GE(highWater, 8 * 512);
+
+    raize::ArenaStatistics arenaStatistics;
+    EXPECT_FALSE(scheduler.getArenaStatistics(2, arenaStatistics));
+
+    // Contexts added by resizing receive an arena of their own
+    EXPECT_TRUE(scheduler.grow(1));
+    EXPECT_TRUE(scheduler.getArenaStatistics(2, arenaStatistics));
+    EXPECT_EQ(8 * 1024, arenaStatistics.capacity);
+
+    scheduler.shutdown();
+}
+
+static std::atomic<unsigned int> submittedRuns[256];
+
+static void TestTask_CountSubmitted(void *payload)
+{
+    uint32_t index;
+    memcpy(&index, payload, sizeof(index));
+
+    submittedRuns[index]++;
+}
+
+// Eight threads submit tasks whilst frames are being processed. Each submission joins a later
+// frame, so once every thread has finished a single frame must execute each task exactly once.
+TEST(Scheduler, ConcurrentSubmission) {
+    const uint32_t producerCount = 8;
+    const uint32_t submissionCount = 32;
+
+    raize::Scheduler scheduler;
+
+    EXPECT_TRUE(scheduler.initialize(4, raize::kCallerMode_Participate));
+    ASSERT_EQ(producerCount * submissionCount, scheduler.getMaximumTasks());
+
+    std::atomic<uint32_t> finished(0);
+    std::vector<std::thread> threads;
+
+    for (uint32_t producer = 0; producer < producerCount; ++producer) {
+        threads.push_back(std::thread([&scheduler, &finished, producer]() {
+            for (uint32_t loop = 0; loop < submissionCount; ++loop) {
+                const uint32_t index = producer * submissionCount + loop;
+                EXPECT_TRUE(scheduler.submitTask(TestTask_CountSubmitted, &index, sizeof(index), nullptr));
+
+                if (0 == (loop & 7)) {
+                    std::this_thread::yield();
+                }
+            }
+
+            finished++;
+        }));
+    }
+
+    while (finished.load() < producerCount) {
+        EXPECT_TRUE(scheduler.execute());
+    }
+
+    for (size_t loop = 0; loop < producerCount; ++loop) {
+        threads[loop].join();
+    }
+
+    // The table is full, so submission must fail rather than overwrite a task
+    EXPECT_FALSE(scheduler.submitTask(TestTask_ExecuteFunc));
+
+    for (size_t loop = 0; loop < producerCount * submissionCount; ++loop) {
+        submittedRuns[loop].store(0);
+    }
+
+    EXPECT_TRUE(scheduler.execute());
+
+    for (size_t loop = 0; loop < producerCount * submissionCount; ++loop) {
+        ASSERT_EQ(1, submittedRuns[loop].load());
+    }
+
+    scheduler.shutdown();
+}
+
+static std::atomic<uint32_t> longTaskReports(0);
+static std::atomic<uint32_t> longTaskId(raize::kInvalidTaskId);
+
+static void TestTask_ReportLongTask(const raize::LongTaskReport &longTask)
+{
+    EXPECT_EQ(raize::kTraceEvent_Task, longTask.kind);
+    EXPECT_LT(longTask.contextId, 2);
+    EXPECT_GT(longTask.elapsedNano, 5000000);
+
+    longTaskId.store(longTask.taskId);
+    longTaskReports++;
+}
+
+// A task that exceeds the budget is reported whilst the frame is waited for, and the scheduler
+// recovers once it completes rather than being shut down.
+TEST(Scheduler, Watchdog) {
+    raize::Scheduler scheduler;
+
+    EXPECT_TRUE(scheduler.initialize(2));
+
+    raize::TaskId fastId;
+    raize::TaskId slowId;
+    EXPECT_TRUE(scheduler.createTask(TestTask_ExecuteFunc, &fastId));
+    EXPECT_TRUE(scheduler.createTask(TestTask_TimeoutFunc, &slowId));
+
+    scheduler.setWatchdog(5000000, TestTask_ReportLongTask);
+
+    taskCounter.store(0);
+    longTaskReports.store(0);
+
+    // The frame is left in flight, so the next call completes it before beginning another
+    EXPECT_FALSE(scheduler.execute(20));
+
+    if (raize::Profiler::kTiming) {
+        EXPECT_LT(0, longTaskReports.load());
+        EXPECT_EQ(slowId, longTaskId.load());
+
+        raize::LongTaskReport longTask;
+        EXPECT_EQ(1, scheduler.findLongTasks(5000000, &longTask, 1));
+        EXPECT_EQ(slowId, longTask.taskId);
+        EXPECT_EQ(0, scheduler.findLongTasks(1000000000, nullptr, 0));
+    }
+
+    // Adding to the task list waits for the frame left in flight
+    EXPECT_TRUE(scheduler.createTask(TestTask_ExecuteFunc));
+    EXPECT_EQ(2, taskCounter.load());
+
+    EXPECT_TRUE(scheduler.execute());
+    EXPECT_EQ(5, taskCounter.load());
+    EXPECT_EQ(2, scheduler.getThreadCount());
+
+    // Waiting ignores the time out, only reporting the slow task
+    scheduler.setHangPolicy(raize::kHangPolicy_Wait);
+    longTaskReports.store(0);
+
+    EXPECT_TRUE(scheduler.execute(20));
+    EXPECT_EQ(8, taskCounter.load());
+
+    if (raize::Profiler::kTiming) {
+        EXPECT_LT(0, longTaskReports.load());
+    }
+
+    EXPECT_EQ(0, scheduler.findLongTasks(0, nullptr, 0));
+
+    scheduler.shutdown();
+}
+
+// The watchdog also reports a hung worker whilst the participating caller waits for the frame.
+TEST(Scheduler, WatchdogParticipate) {
+    raize::Scheduler scheduler;
+
+    EXPECT_TRUE(scheduler.initialize(2, raize::kCallerMode_Participate));
+    EXPECT_TRUE(scheduler.createTask(TestTask_WorkerTimeoutFunc));
+    EXPECT_TRUE(scheduler.createTask(TestTask_WorkerTimeoutFunc));
+
+    scheduler.setWatchdog(5000000, TestTask_ReportLongTask);
+
+    taskCounter.store(0);
+    longTaskReports.store(0);
+    workerHangStarted.store(false);
+
+    EXPECT_FALSE(scheduler.execute(20));
+
+    if (raize::Profiler::kTiming) {
+        EXPECT_LT(0, longTaskReports.load());
+    }
+
+    EXPECT_TRUE(scheduler.createTask(TestTask_ExecuteFunc));
+    EXPECT_EQ(2, taskCounter.load());
+
+    scheduler.shutdown();
+}
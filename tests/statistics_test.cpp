@@ -0,0 +1,65 @@
+//
+// Copyright 2017 nfactorial
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "gtest/gtest.h"
+#include "statistics.h"
+
+TEST(Histogram, Buckets) {
+    // Small values are stored exactly, larger values to within 1/16
+    EXPECT_EQ(0, raize::Histogram::getBucketIndex(0));
+    EXPECT_EQ(15, raize::Histogram::getBucketIndex(15));
+    EXPECT_EQ(16, raize::Histogram::getBucketIndex(16));
+    EXPECT_EQ(raize::Histogram::getBucketIndex(32), raize::Histogram::getBucketIndex(33));
+    EXPECT_NE(raize::Histogram::getBucketIndex(32), raize::Histogram::getBucketIndex(34));
+    EXPECT_EQ(raize::Histogram::kHistogramBucketCount - 1, raize::Histogram::getBucketIndex(UINT64_MAX));
+    EXPECT_EQ(UINT64_MAX, raize::Histogram::getBucketValue(raize::Histogram::kHistogramBucketCount - 1));
+
+    for (uint64_t value = 1; value < (uint64_t(1) << 40); value = value * 3 + 1) {
+        const uint64_t bucketValue = raize::Histogram::getBucketValue(raize::Histogram::getBucketIndex(value));
+
+        EXPECT_GE(bucketValue, value);
+        EXPECT_LE(bucketValue - value, value / 16);
+    }
+}
+
+TEST(Histogram, Percentiles) {
+    raize::Histogram histogram;
+    raize::DurationStatistics durationStatistics;
+
+    histogram.getStatistics(durationStatistics);
+    EXPECT_EQ(0, durationStatistics.count);
+    EXPECT_EQ(0, durationStatistics.p50Nano);
+
+    for (uint64_t loop = 1; loop <= 1000; ++loop) {
+        histogram.record(loop * 1000);
+    }
+
+    histogram.getStatistics(durationStatistics);
+    EXPECT_EQ(1000, durationStatistics.count);
+    EXPECT_NEAR(500000.0, static_cast< double >(durationStatistics.p50Nano), 500000.0 / 16);
+    EXPECT_NEAR(950000.0, static_cast< double >(durationStatistics.p95Nano), 950000.0 / 16);
+    EXPECT_NEAR(990000.0, static_cast< double >(durationStatistics.p99Nano), 990000.0 / 16);
+    EXPECT_NEAR(1000000.0, static_cast< double >(durationStatistics.maximumNano), 1000000.0 / 16);
+
+    raize::Histogram merged;
+    merged.merge(histogram);
+    merged.merge(histogram);
+    EXPECT_EQ(2000, merged.getCount());
+    EXPECT_EQ(histogram.getPercentile(0.5), merged.getPercentile(0.5));
+
+    histogram.clear();
+    EXPECT_EQ(0, histogram.getCount());
+}
@@ -15,7 +15,11 @@
 //
 
 #include <chrono>
+#include <cstring>
 #include <thread>
+#include <set>
+#include <atomic>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -81,3 +85,441 @@ TEST(TaskProvider, NextTask) {
     EXPECT_TRUE(TestTask_ExecuteFunc1 == infoA->execute);
     EXPECT_TRUE(TestTask_ExecuteFunc2 == infoB->execute);
 }
+
+static void TestTask_PayloadFunc(void *payload) {
+    (void)payload;
+}
+
+TEST(TaskProvider, Payload) {
+    raize::TaskProvider taskProvider;
+
+    EXPECT_TRUE(taskProvider.initialize(2));
+
+    const uint32_t payload[2] = {0x12345678, 0x9abcdef0};
+    const unsigned char oversized[raize::kRaizeTaskPayloadSize + 1] = {0};
+
+    EXPECT_TRUE(taskProvider.addTask(TestTask_PayloadFunc, payload, sizeof(payload), nullptr, 0, nullptr, 0, nullptr));
+    EXPECT_FALSE(taskProvider.addTask(TestTask_PayloadFunc, oversized, sizeof(oversized), nullptr, 0, nullptr, 0, nullptr));
+
+    const raize::TaskInfo *taskInfo = taskProvider.getTask(0);
+
+    EXPECT_TRUE(TestTask_PayloadFunc == taskInfo->invoke);
+    EXPECT_EQ(0, memcmp(payload, taskInfo->payload.data, sizeof(payload)));
+}
+
+TEST(TaskProvider, StealTask) {
+    raize::TaskProvider taskProvider;
+
+    EXPECT_TRUE(taskProvider.initialize(8, 2));
+    EXPECT_EQ(2, taskProvider.getQueueCount());
+
+    for (size_t loop = 0; loop < 8; ++loop) {
+        EXPECT_TRUE(taskProvider.addTask(TestTask_ExecuteFunc1));
+    }
+
+    EXPECT_EQ(8, taskProvider.onBeginProcessing());
+
+    // The second context drains its own queue and then steals everything from the first
+    std::set<const raize::TaskInfo *> claimed;
+    for (size_t loop = 0; loop < 8; ++loop) {
+        const raize::TaskInfo *taskInfo = taskProvider.nextTask(1);
+        ASSERT_NE(nullptr, taskInfo);
+
+        claimed.insert(taskInfo);
+    }
+
+    EXPECT_EQ(8, claimed.size());
+    EXPECT_EQ(nullptr, taskProvider.nextTask(0));
+    EXPECT_EQ(nullptr, taskProvider.nextTask(1));
+}
+
+// Runs a number of threads against a single provider, all racing to claim tasks. Every
+// task must be claimed by exactly one thread.
+static void ClaimUnderContention(raize::kTaskClaimMode claimMode) {
+    const size_t threadCount = 8;
+    const size_t taskCount = 4096;
+
+    raize::TaskProvider taskProvider;
+
+    EXPECT_TRUE(taskProvider.initialize(taskCount, threadCount));
+    taskProvider.setClaimMode(claimMode);
+
+    for (size_t loop = 0; loop < taskCount; ++loop) {
+        EXPECT_TRUE(taskProvider.addTask(TestTask_ExecuteFunc1));
+    }
+
+    std::vector<std::atomic<unsigned int>> claimCounts(taskCount);
+    for (size_t loop = 0; loop < taskCount; ++loop) {
+        claimCounts[loop].store(0);
+    }
+
+    for (size_t frame = 0; frame < 4; ++frame) {
+        EXPECT_EQ(taskCount, taskProvider.onBeginProcessing());
+
+        std::atomic<bool> start(false);
+        std::vector<std::thread> threads;
+
+        for (unsigned int contextId = 0; contextId < threadCount; ++contextId) {
+            threads.push_back(std::thread([&taskProvider, &claimCounts, &start, contextId]() {
+                while (!start.load()) {
+                    std::this_thread::yield();
+                }
+
+                raize::TaskRange range = {0, 0};
+                raize::TaskId taskId;
+                while (raize::kInvalidTaskId != (taskId = taskProvider.acquireTask(contextId, range))) {
+                    claimCounts[taskId]++;
+                    taskProvider.completeTask(contextId, taskId);
+                }
+            }));
+        }
+
+        start.store(true);
+        for (size_t loop = 0; loop < threadCount; ++loop) {
+            threads[loop].join();
+        }
+
+        taskProvider.onEndProcessing();
+
+        for (size_t loop = 0; loop < taskCount; ++loop) {
+            ASSERT_EQ(frame + 1, claimCounts[loop].load());
+        }
+    }
+}
+
+TEST(TaskProvider, StealingContention) {
+    ClaimUnderContention(raize::kTaskClaimMode_WorkStealing);
+}
+
+TEST(TaskProvider, BatchedContention) {
+    ClaimUnderContention(raize::kTaskClaimMode_Batched);
+}
+
+TEST(TaskProvider, BatchShrinks) {
+    raize::TaskProvider taskProvider;
+
+    EXPECT_TRUE(taskProvider.initialize(64, 2));
+    taskProvider.setClaimMode(raize::kTaskClaimMode_Batched);
+
+    for (size_t loop = 0; loop < 64; ++loop) {
+        EXPECT_TRUE(taskProvider.addTask(TestTask_ExecuteFunc1));
+    }
+
+    EXPECT_EQ(64, taskProvider.onBeginProcessing());
+
+    // Each batch takes a quarter of the remaining tasks, until the minimum batch size is reached
+    raize::TaskRange range;
+    size_t previousSize = 64;
+    size_t claimed = 0;
+
+    while (taskProvider.claimTasks(0, range)) {
+        EXPECT_EQ(claimed, range.first);
+        EXPECT_LE(range.last - range.first, previousSize);
+
+        previousSize = range.last - range.first;
+        claimed = range.last;
+    }
+
+    EXPECT_EQ(64, claimed);
+    EXPECT_EQ(1, previousSize);
+}
+
+TEST(TaskProvider, Dependencies) {
+    raize::TaskProvider taskProvider;
+
+    EXPECT_TRUE(taskProvider.initialize(4, 1, 1));
+    EXPECT_EQ(1, taskProvider.getMaximumDependencies());
+
+    raize::TaskId first = raize::kInvalidTaskId;
+    raize::TaskId second = raize::kInvalidTaskId;
+
+    EXPECT_TRUE(taskProvider.addTask(TestTask_ExecuteFunc1, nullptr, 0, &first));
+    EXPECT_TRUE(taskProvider.addTask(TestTask_ExecuteFunc2, &first, 1, &second));
+    EXPECT_FALSE(taskProvider.addTask(TestTask_ExecuteFunc2, &second, 1, nullptr));
+
+    EXPECT_EQ(2, taskProvider.onBeginProcessing());
+
+    // Only the first task is available until it has been completed
+    raize::TaskRange range = {0, 0};
+    EXPECT_EQ(first, taskProvider.acquireTask(0, range));
+    EXPECT_EQ(nullptr, taskProvider.nextTask(0));
+
+    taskProvider.completeTask(0, first);
+    EXPECT_EQ(second, taskProvider.acquireTask(0, range));
+
+    taskProvider.completeTask(0, second);
+    EXPECT_EQ(raize::kInvalidTaskId, taskProvider.acquireTask(0, range));
+}
+
+TEST(TaskProvider, ResourceAccess) {
+    raize::TaskProvider taskProvider;
+
+    EXPECT_TRUE(taskProvider.initialize(8, 1));
+
+    const raize::ResourceAccess readAccess = {7, raize::kResourceAccess_Read};
+    const raize::ResourceAccess writeAccess = {7, raize::kResourceAccess_Write};
+
+    raize::TaskId writer;
+    raize::TaskId readerA;
+    raize::TaskId readerB;
+    raize::TaskId finalWriter;
+
+    EXPECT_TRUE(taskProvider.addTask(TestTask_ExecuteFunc1, nullptr, 0, &writeAccess, 1, &writer));
+    EXPECT_TRUE(taskProvider.addTask(TestTask_ExecuteFunc1, nullptr, 0, &readAccess, 1, &readerA));
+    EXPECT_TRUE(taskProvider.addTask(TestTask_ExecuteFunc1, nullptr, 0, &readAccess, 1, &readerB));
+    EXPECT_TRUE(taskProvider.addTask(TestTask_ExecuteFunc1, nullptr, 0, &writeAccess, 1, &finalWriter));
+
+    EXPECT_EQ(0, taskProvider.getTask(writer)->predecessorCount);
+    EXPECT_EQ(1, taskProvider.getTask(readerA)->predecessorCount);
+    EXPECT_EQ(1, taskProvider.getTask(readerB)->predecessorCount);
+    EXPECT_EQ(2, taskProvider.getTask(finalWriter)->predecessorCount);
+
+    // Both readers become available together once the writer has completed
+    EXPECT_EQ(4, taskProvider.onBeginProcessing());
+
+    raize::TaskRange range = {0, 0};
+    EXPECT_EQ(writer, taskProvider.acquireTask(0, range));
+    taskProvider.completeTask(0, writer);
+
+    const raize::TaskId firstReader = taskProvider.acquireTask(0, range);
+    const raize::TaskId secondReader = taskProvider.acquireTask(0, range);
+    EXPECT_TRUE(firstReader == readerA || firstReader == readerB);
+    EXPECT_TRUE(secondReader == readerA || secondReader == readerB);
+    EXPECT_NE(firstReader, secondReader);
+    EXPECT_EQ(nullptr, taskProvider.nextTask(0));
+}
+
+TEST(TaskProvider, ReplayGraph) {
+    raize::TaskProvider taskProvider;
+
+    EXPECT_TRUE(taskProvider.initialize(4, 1));
+
+    raize::TaskId first;
+    raize::TaskId second;
+
+    EXPECT_TRUE(taskProvider.addTask(TestTask_ExecuteFunc1, nullptr, 0, &first));
+    EXPECT_TRUE(taskProvider.addTask(TestTask_ExecuteFunc1, nullptr, 0, &second));
+    EXPECT_TRUE(taskProvider.addTask(TestTask_ExecuteFunc2, &first, 1, nullptr));
+    EXPECT_TRUE(taskProvider.addTask(TestTask_ExecuteFunc2, &second, 1, nullptr));
+    EXPECT_TRUE(taskProvider.compile());
+
+    for (size_t frame = 0; frame < 3; ++frame) {
+        EXPECT_EQ(4, taskProvider.onBeginProcessing());
+
+        // The second frame is abandoned part way through, the next frame must start cleanly
+        const size_t completeCount = (1 == frame) ? 1 : 4;
+
+        raize::TaskRange range = {0, 0};
+        for (size_t loop = 0; loop < completeCount; ++loop) {
+            const raize::TaskId taskId = taskProvider.acquireTask(0, range);
+            ASSERT_NE(raize::kInvalidTaskId, taskId);
+
+            taskProvider.completeTask(0, taskId);
+        }
+
+        if (4 == completeCount) {
+            EXPECT_EQ(raize::kInvalidTaskId, taskProvider.acquireTask(0, range));
+        }
+
+        taskProvider.onEndProcessing();
+    }
+}
+
+TEST(TaskProvider, Priority) {
+    raize::TaskProvider taskProvider;
+
+    EXPECT_TRUE(taskProvider.initialize(16, 1));
+
+    raize::TaskId taskId;
+    for (size_t loop = 0; loop < 16; ++loop) {
+        EXPECT_TRUE(taskProvider.addTask(TestTask_ExecuteFunc1, nullptr, 0, &taskId));
+        EXPECT_TRUE(taskProvider.setTaskPriority(taskId, (loop < 8) ? raize::kTaskPriority_Low : raize::kTaskPriority_Critical));
+    }
+
+    EXPECT_FALSE(taskProvider.setTaskPriority(16, raize::kTaskPriority_High));
+    EXPECT_EQ(16, taskProvider.onBeginProcessing());
+
+    // Critical tasks are served first despite being added last, until aging lets a low priority task through
+    raize::TaskRange range = {0, 0};
+    for (size_t loop = 0; loop < 16; ++loop) {
+        taskId = taskProvider.acquireTask(0, range);
+        ASSERT_NE(raize::kInvalidTaskId, taskId);
+
+        const bool expectLow = (7 == loop) || (loop > 8);
+        EXPECT_EQ(expectLow ? raize::kTaskPriority_Low : raize::kTaskPriority_Critical, taskProvider.getTask(taskId)->priority);
+
+        taskProvider.completeTask(0, taskId);
+    }
+
+    EXPECT_EQ(raize::kInvalidTaskId, taskProvider.acquireTask(0, range));
+
+    // Completion times are held by each context until the frame ends
+    raize::PriorityStatistics statistics;
+    taskProvider.getPriorityStatistics(raize::kTaskPriority_Critical, statistics);
+    EXPECT_EQ(0, statistics.taskCount);
+
+    taskProvider.onEndProcessing();
+
+    taskProvider.getPriorityStatistics(raize::kTaskPriority_Critical, statistics);
+    EXPECT_EQ(8, statistics.taskCount);
+    taskProvider.getPriorityStatistics(raize::kTaskPriority_Normal, statistics);
+    EXPECT_EQ(0, statistics.taskCount);
+
+    taskProvider.resetPriorityStatistics();
+    taskProvider.getPriorityStatistics(raize::kTaskPriority_Critical, statistics);
+    EXPECT_EQ(0, statistics.taskCount);
+}
+
+// Durations recorded by each context only reach the task table once the frame ends.
+TEST(TaskProvider, TaskDurations) {
+    raize::TaskProvider taskProvider;
+
+    EXPECT_TRUE(taskProvider.initialize(16, 2));
+
+    raize::TaskId first;
+    raize::TaskId second;
+    EXPECT_TRUE(taskProvider.addTask(TestTask_ExecuteFunc1, nullptr, 0, &first));
+    EXPECT_TRUE(taskProvider.addTask(TestTask_ExecuteFunc1, nullptr, 0, &second));
+    EXPECT_EQ(2, taskProvider.onBeginProcessing());
+
+    taskProvider.recordDuration(0, first, 1000);
+    taskProvider.recordDuration(1, second, 2000);
+    EXPECT_EQ(0, taskProvider.getTaskDuration(first));
+
+    taskProvider.onEndProcessing();
+    EXPECT_EQ(1000, taskProvider.getTaskDuration(first));
+    EXPECT_EQ(2000, taskProvider.getTaskDuration(second));
+    EXPECT_EQ(0, taskProvider.getTaskDuration(2));
+
+    // Each frame replaces the durations of the tasks it executed
+    EXPECT_EQ(2, taskProvider.onBeginProcessing());
+    taskProvider.recordDuration(1, first, 3000);
+    taskProvider.onEndProcessing();
+
+    EXPECT_EQ(3000, taskProvider.getTaskDuration(first));
+    EXPECT_EQ(2000, taskProvider.getTaskDuration(second));
+}
+
+// Identifies the producer that submitted a task, and which of its submissions it was.
+struct SubmittedPayload {
+    uint32_t producer;
+    uint32_t index;
+};
+
+static void TestTask_SubmittedFunc(void *payload)
+{
+    (void)payload;
+}
+
+// Eight threads submit tasks at once, whilst the building thread adds tasks of its own, until
+// the task table is full. Every slot must hold exactly one task, the one its submitter was given.
+TEST(TaskProvider, ConcurrentSubmission) {
+    const size_t producerCount = 8;
+    const size_t submissionCount = 640;
+    const size_t taskCapacity = 4096;
+
+    raize::TaskProvider taskProvider;
+
+    EXPECT_TRUE(taskProvider.initialize(taskCapacity));
+
+    std::atomic<bool> start(false);
+    std::vector<std::vector<raize::TaskId>> submitted(producerCount);
+    std::vector<std::thread> threads;
+
+    for (uint32_t producer = 0; producer < producerCount; ++producer) {
+        threads.push_back(std::thread([&taskProvider, &submitted, &start, producer]() {
+            while (!start.load()) {
+                std::this_thread::yield();
+            }
+
+            for (uint32_t loop = 0; loop < submissionCount; ++loop) {
+                const SubmittedPayload payload = {producer, loop};
+
+                raize::TaskId taskId = raize::kInvalidTaskId;
+                if (taskProvider.submitTask(TestTask_SubmittedFunc, &payload, sizeof(payload), raize::kTaskPriority_Normal, &taskId)) {
+                    submitted[producer].push_back(taskId);
+                } else {
+                    // Once the table is full, every later submission must also fail
+                    EXPECT_FALSE(taskProvider.submitTask(TestTask_ExecuteFunc1));
+                }
+            }
+        }));
+    }
+
+    start.store(true);
+
+    // Each added task depends upon the one added before it, with submissions interleaved between them
+    std::vector<raize::TaskId> added;
+    raize::TaskId previous = raize::kInvalidTaskId;
+    for (size_t loop = 0; loop < 64; ++loop) {
+        raize::TaskId taskId;
+        if (!taskProvider.addTask(TestTask_ExecuteFunc1, &previous, (raize::kInvalidTaskId != previous) ? 1 : 0, &taskId)) {
+            break;
+        }
+
+        added.push_back(taskId);
+        previous = taskId;
+    }
+
+    for (size_t loop = 0; loop < producerCount; ++loop) {
+        threads[loop].join();
+    }
+
+    taskProvider.collectSubmissions();
+    EXPECT_EQ(taskCapacity, taskProvider.getTaskCount());
+
+    std::vector<unsigned int> owners(taskCapacity, 0);
+    size_t submittedTotal = 0;
+
+    for (uint32_t producer = 0; producer < producerCount; ++producer) {
+        for (uint32_t loop = 0; loop < submitted[producer].size(); ++loop) {
+            const raize::TaskId taskId = submitted[producer][loop];
+            ASSERT_LT(taskId, taskCapacity);
+
+            const raize::TaskInfo *taskInfo = taskProvider.getTask(taskId);
+            SubmittedPayload payload;
+            memcpy(&payload, taskInfo->payload.data, sizeof(payload));
+
+            EXPECT_TRUE(TestTask_SubmittedFunc == taskInfo->invoke);
+            EXPECT_EQ(producer, payload.producer);
+            EXPECT_EQ(loop, payload.index);
+
+            owners[taskId]++;
+        }
+
+        submittedTotal += submitted[producer].size();
+    }
+
+    for (size_t loop = 0; loop < added.size(); ++loop) {
+        EXPECT_TRUE(TestTask_ExecuteFunc1 == taskProvider.getTask(added[loop])->execute);
+        owners[added[loop]]++;
+    }
+
+    EXPECT_EQ(taskCapacity, submittedTotal + added.size());
+    for (size_t loop = 0; loop < taskCapacity; ++loop) {
+        ASSERT_EQ(1, owners[loop]);
+    }
+
+    // Processing the frame executes each task once, in dependency order
+    std::vector<unsigned int> claimCounts(taskCapacity, 0);
+    EXPECT_EQ(taskCapacity, taskProvider.onBeginProcessing());
+
+    raize::TaskRange range = {0, 0};
+    raize::TaskId taskId;
+    while (raize::kInvalidTaskId != (taskId = taskProvider.acquireTask(0, range))) {
+        claimCounts[taskId]++;
+        taskProvider.completeTask(0, taskId);
+    }
+
+    for (size_t loop = 0; loop < taskCapacity; ++loop) {
+        ASSERT_EQ(1, claimCounts[loop]);
+    }
+
+    taskProvider.onEndProcessing();
+
+    // Clearing the list releases every slot for submission
+    taskProvider.clearTasks();
+    EXPECT_EQ(0, taskProvider.getTaskCount());
+    EXPECT_TRUE(taskProvider.submitTask(TestTask_ExecuteFunc1));
+    EXPECT_EQ(1, taskProvider.collectSubmissions());
+}
@@ -0,0 +1,73 @@
+//
+// Copyright 2017 nfactorial
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include <thread>
+
+#if defined( __linux__ )
+    #include <sched.h>
+#endif //defined( __linux__ )
+
+#include "gtest/gtest.h"
+#include "thread_affinity.h"
+
+TEST(ThreadAffinity, DefaultPlacement) {
+    raize::ThreadPlacement placement;
+
+    raize::resetThreadPlacement(placement);
+    EXPECT_TRUE(raize::isDefaultThreadPlacement(placement));
+
+    placement.priority = 1;
+    EXPECT_FALSE(raize::isDefaultThreadPlacement(placement));
+
+    // The default placement is accepted on every platform
+    raize::resetThreadPlacement(placement);
+    EXPECT_TRUE(raize::applyThreadPlacement(placement));
+}
+
+#if defined( __linux__ )
+
+TEST(ThreadAffinity, PhysicalCores) {
+    raize::ThreadPlacement placements[4];
+
+    const size_t physicalCount = raize::getPhysicalCorePlacements(placements, 4);
+    EXPECT_LT(0, physicalCount);
+
+    for (size_t loop = 0; loop < 4; ++loop) {
+        EXPECT_EQ(1, placements[loop].cores.count());
+    }
+}
+
+// Pins a thread to the first physical core, the thread must then be running upon that core.
+TEST(ThreadAffinity, ApplyCoreSet) {
+    raize::ThreadPlacement placement;
+
+    EXPECT_LT(0, raize::getPhysicalCorePlacements(&placement, 1));
+
+    bool applied = false;
+    int runningCore = -1;
+
+    std::thread thread([&]() {
+        applied = raize::applyThreadPlacement(placement);
+        runningCore = sched_getcpu();
+    });
+
+    thread.join();
+
+    EXPECT_TRUE(applied);
+    ASSERT_LE(0, runningCore);
+    EXPECT_TRUE(placement.cores.test(static_cast< size_t >(runningCore)));
+}
+
+#endif //defined( __linux__ )
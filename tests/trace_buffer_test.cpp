@@ -0,0 +1,97 @@
+//
+// Copyright 2017 nfactorial
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <cstdio>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "trace_buffer.h"
+
+// Reads back everything written to a temporary file.
+static std::string ReadTraceFile(FILE *file)
+{
+    std::string contents;
+    char block[256];
+
+    rewind(file);
+
+    size_t bytesRead;
+    while (0 != (bytesRead = fread(block, 1, sizeof(block), file))) {
+        contents.append(block, bytesRead);
+    }
+
+    return contents;
+}
+
+// Counts the occurrences of a string within the trace.
+static size_t CountOccurrences(const std::string &contents, const char *search)
+{
+    size_t count = 0;
+    for (size_t position = contents.find(search); std::string::npos != position; position = contents.find(search, position + 1)) {
+        count++;
+    }
+
+    return count;
+}
+
+TEST(TraceBuffer, Wrap) {
+    raize::TraceBuffer traceBuffer;
+
+    EXPECT_FALSE(traceBuffer.initialize(0));
+    EXPECT_TRUE(traceBuffer.initialize(3));
+    EXPECT_EQ(4, traceBuffer.getCapacity());
+    EXPECT_EQ(0, traceBuffer.getEventCount());
+
+    for (uint32_t loop = 0; loop < 6; ++loop) {
+        const raize::TraceEvent traceEvent = {loop, loop + 1, loop, 0, 0, raize::kTraceEvent_Task};
+        traceBuffer.record(traceEvent);
+    }
+
+    // Only the four newest events remain, oldest first
+    EXPECT_EQ(4, traceBuffer.getEventCount());
+    for (size_t loop = 0; loop < 4; ++loop) {
+        EXPECT_EQ(loop + 2, traceBuffer.getEvent(loop).workId);
+    }
+
+    traceBuffer.clear();
+    EXPECT_EQ(0, traceBuffer.getEventCount());
+}
+
+TEST(TraceBuffer, ChromeTrace) {
+    raize::TraceBuffer traceBuffer;
+
+    EXPECT_TRUE(traceBuffer.initialize(16));
+
+    for (uint32_t frame = 0; frame < 3; ++frame) {
+        const raize::TraceEvent traceEvent = {1000 * frame, 1000 * frame + 500, 7, 1, frame, raize::kTraceEvent_Task};
+        traceBuffer.record(traceEvent);
+    }
+
+    FILE *file = tmpfile();
+    ASSERT_NE(nullptr, file);
+
+    const raize::TraceBuffer *buffers[] = {&traceBuffer, nullptr};
+    EXPECT_TRUE(raize::writeChromeTrace(file, buffers, 2, 1));
+
+    // Frame 0 is excluded, times are relative to the first event written
+    const std::string contents = ReadTraceFile(file);
+    EXPECT_EQ(2, CountOccurrences(contents, "\"ph\":\"X\""));
+    EXPECT_EQ(1, CountOccurrences(contents, "\"name\":\"Context 1\""));
+    EXPECT_EQ(1, CountOccurrences(contents, "\"ts\":0.000,\"dur\":0.500"));
+    EXPECT_EQ(1, CountOccurrences(contents, "\"ts\":1.000,\"dur\":0.500"));
+
+    fclose(file);
+}